@@ -0,0 +1,155 @@
+// filter masks as a bit vector against a vector of char with one byte per flag
+// reports the memory of both and the throughput of building, counting, combining and iterating the masks
+// build: cc -O2 -I.. bench_bits.c -o bench_bits
+// usage: ./bench_bits [flags, default 100000000] [percent set, default 10]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+#include "vec_bits.h"
+
+
+using_vector( char )
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// keeps the compiler from dropping the work
+static volatile size_t sink;
+
+static uint64_t rng_state = 88172645463325252ull;
+
+static uint64_t next_random( void )
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+// flags per ns and the bytes of mask read per second
+static void report( const char* name, size_t flags, size_t bytes, double seconds )
+{
+    printf( "%-28s %12.3f %12.2f\n", name, flags / seconds / 1e9, bytes / seconds / 1e9 );
+}
+
+
+int main( int argc, char** argv )
+{
+    size_t n = argc > 1 ? strtoull( argv[1], NULL, 10 ) : 100000000;
+    unsigned percent = argc > 2 ? (unsigned) strtoul( argv[2], NULL, 10 ) : 10;
+    printf( "%zu flags, %u%% set\n", n, percent );
+
+    // build both masks with push, the same random flags
+    double start = now();
+    char* chars = vec_new_char( 0, 0 );
+    char* other_chars = vec_new_char( 0, 0 );
+    for ( size_t i = 0; i < n; i++ )
+    {
+        chars = vec_push_back_char( chars, next_random() % 100 < percent );
+        other_chars = vec_push_back_char( other_chars, next_random() % 2 );
+    }
+    double char_build = now() - start;
+    rng_state = 88172645463325252ull;
+    start = now();
+    vec_bits* bits = vec_bits_new( 0, false );
+    vec_bits* other_bits = vec_bits_new( 0, false );
+    for ( size_t i = 0; i < n; i++ )
+    {
+        bits = vec_bits_push( bits, next_random() % 100 < percent );
+        other_bits = vec_bits_push( other_bits, next_random() % 2 );
+    }
+    double bits_build = now() - start;
+    size_t char_bytes = vec_size_char( chars );
+    size_t bits_bytes = vec_bits_words_for_( vec_bits_size( bits ) ) * sizeof ( uint64_t );
+    printf( "memory: char %zu bytes, bits %zu bytes ( %.1fx smaller )\n\n", char_bytes, bits_bytes,
+            (double) char_bytes / bits_bytes );
+    printf( "%-28s %12s %12s\n", "", "Gflags/s", "GB/s" );
+    report( "char push ( both )", 2 * n, 0, char_build );
+    report( "bits push ( both )", 2 * n, 0, bits_build );
+
+    // count the set flags
+    int reps = 10;
+    size_t count = 0;
+    start = now();
+    for ( int r = 0; r < reps; r++ )
+    {
+        for ( size_t i = 0; i < n; i++ ) count += chars[i] != 0;
+    }
+    report( "char count", reps * n, reps * char_bytes, now() - start );
+    start = now();
+    for ( int r = 0; r < reps; r++ ) count -= vec_bits_count( bits );
+    report( "bits count ( popcount )", reps * n, reps * bits_bytes, now() - start );
+    if ( count != 0 ) printf( "MISMATCH in count\n" );
+
+    // number of flags set before 100 evenly spaced positions, the char vector has to sum a prefix
+    size_t queries = 100;
+    size_t rank = 0;
+    start = now();
+    for ( size_t q = 0; q < queries; q++ )
+    {
+        size_t end = q * ( n / queries );
+        for ( size_t i = 0; i < end; i++ ) rank += chars[i] != 0;
+    }
+    double char_rank = now() - start;
+    start = now();
+    for ( size_t q = 0; q < queries; q++ ) rank -= vec_bits_rank( bits, q * ( n / queries ) );
+    double bits_rank = now() - start;
+    printf( "%-28s %12.1f us/query\n", "char rank", char_rank / queries * 1e6 );
+    printf( "%-28s %12.1f us/query\n", "bits rank", bits_rank / queries * 1e6 );
+    if ( rank != 0 ) printf( "MISMATCH in rank\n" );
+
+    // combine two masks, and then xor back
+    start = now();
+    for ( int r = 0; r < reps; r++ )
+    {
+        for ( size_t i = 0; i < n; i++ ) chars[i] ^= other_chars[i];
+    }
+    report( "char xor", reps * n, reps * 2 * char_bytes, now() - start );
+    start = now();
+    for ( int r = 0; r < reps; r++ ) vec_bits_xor( bits, other_bits );
+    report( "bits xor", reps * n, reps * 2 * bits_bytes, now() - start );
+
+    // visit the positions of the set flags
+    size_t visited = 0;
+    start = now();
+    for ( size_t i = 0; i < n; i++ )
+    {
+        if ( chars[i] ) visited += i;
+    }
+    report( "char iterate set", n, char_bytes, now() - start );
+    size_t positions[256];
+    size_t got, position = 0;
+    start = now();
+    while ( ( got = vec_bits_collect( bits, position, positions, 256 ) ) > 0 )
+    {
+        for ( size_t i = 0; i < got; i++ ) visited -= positions[i];
+        position = positions[ got - 1 ] + 1;
+    }
+    report( "bits iterate set ( collect )", n, bits_bytes, now() - start );
+    if ( visited != 0 ) printf( "MISMATCH in iterate\n" );
+
+    // single flag lookups at random positions
+    size_t lookups = n / 4;
+    size_t hits = 0;
+    start = now();
+    for ( size_t i = 0; i < lookups; i++ ) hits += chars[ next_random() % n ] != 0;
+    report( "char random test", lookups, 0, now() - start );
+    start = now();
+    for ( size_t i = 0; i < lookups; i++ ) hits += vec_bits_test( bits, next_random() % n );
+    report( "bits random test", lookups, 0, now() - start );
+    sink = hits;
+
+    vec_destroy_char( chars );
+    vec_destroy_char( other_chars );
+    vec_bits_destroy( bits );
+    vec_bits_destroy( other_bits );
+    return 0;
+}
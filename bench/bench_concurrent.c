@@ -0,0 +1,88 @@
+// multi-producer appends: vec_concurrent.h against vec_push_back behind a mutex
+// build: cc -O2 -I.. bench_concurrent.c -o bench_concurrent -pthread
+// the stress checks of the concurrent vector are in tests/test_concurrent.c
+// usage: ./bench_concurrent [pushes per run, default 10000000] [max threads, default 8]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+#include "vec_concurrent.h"
+
+
+using_vector( int64_t )
+using_concurrent_vector( int64_t )
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static vec_concurrent_int64_t shared;
+static int64_t* locked;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t per_thread;
+
+static void* push_concurrent( void* arg )
+{
+    int64_t base = (int64_t) (intptr_t) arg * (int64_t) per_thread;
+    for ( size_t i = 0; i < per_thread; i++ ) vec_concurrent_push_back_int64_t( &shared, base + (int64_t) i );
+    return NULL;
+}
+
+static void* push_locked( void* arg )
+{
+    int64_t base = (int64_t) (intptr_t) arg * (int64_t) per_thread;
+    for ( size_t i = 0; i < per_thread; i++ )
+    {
+        pthread_mutex_lock( &lock );
+        locked = vec_push_back_int64_t( locked, base + (int64_t) i );
+        pthread_mutex_unlock( &lock );
+    }
+    return NULL;
+}
+
+// run threads producers of FN, store the ns per push in result
+static double run( size_t threads, void* (*fn)( void* ) )
+{
+    pthread_t tid[ 256 ];
+    double start = now();
+    for ( size_t t = 0; t < threads; t++ ) pthread_create( &tid[t], NULL, fn, (void*) (intptr_t) t );
+    for ( size_t t = 0; t < threads; t++ ) pthread_join( tid[t], NULL );
+    return ( now() - start ) * 1e9 / ( threads * per_thread );
+}
+
+int main( int argc, char** argv )
+{
+    size_t n = argc > 1 ? strtoull( argv[1], NULL, 10 ) : 10000000;
+    size_t max_threads = argc > 2 ? strtoull( argv[2], NULL, 10 ) : 8;
+    if ( max_threads > 256 ) max_threads = 256;
+
+    printf( "%zu pushes per run\n%-8s %14s %14s\n", n, "threads", "mutex ns/op", "concurrent" );
+    for ( size_t threads = 1; threads <= max_threads; threads *= 2 )
+    {
+        per_thread = n / threads;
+
+        locked = vec_new_int64_t( 0, 0 );
+        double mutex_ns = run( threads, push_locked );
+        vec_destroy_int64_t( locked );
+
+        vec_concurrent_init_int64_t( &shared );
+        double concurrent_ns = run( threads, push_concurrent );
+        if ( vec_concurrent_size_int64_t( &shared ) != threads * per_thread )
+        {
+            printf( "lost pushes: %zu of %zu\n", vec_concurrent_size_int64_t( &shared ), threads * per_thread );
+            return 1;
+        }
+        vec_concurrent_destroy_int64_t( &shared );
+
+        printf( "%-8zu %14.2f %14.2f\n", threads, mutex_ns, concurrent_ns );
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+// fan-out of one large vector to N reader threads: a copy per reader against vec_share with VECTOR_COW
+// every reader sums its vector and destroys it, in the last run one reader appends to its vector as well,
+// which copies the shared block once for that reader only
+// build: cc -O2 -I.. bench_cow.c -o bench_cow -pthread
+// usage: ./bench_cow [elements, default 10000000] [max readers, default 16]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#define VECTOR_COW
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+
+
+using_vector( int64_t )
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+typedef struct reader
+{
+    pthread_t tid;
+    int64_t* data;              // this reader's vector, destroyed by the reader
+    bool writes;                // append to the vector before summing it
+    int64_t sum;
+} reader;
+
+static void* read_vector( void* arg )
+{
+    reader* r = arg;
+    if ( r->writes ) r->data = vec_push_back_int64_t( r->data, 1 );
+    int64_t sum = 0;
+    size_t size = vec_size_int64_t( r->data );
+    for ( size_t i = 0; i < size; i++ ) sum += r->data[i];
+    r->sum = sum;
+    vec_destroy_int64_t( r->data );
+    return NULL;
+}
+
+// hand source to readers threads, by copy or by share, and wait for them, returns the seconds taken
+static double fan_out( int64_t* source, size_t readers, bool share, bool one_writes, double* handoff )
+{
+    reader* r = calloc( readers, sizeof ( reader ) );
+    double start = now();
+    for ( size_t i = 0; i < readers; i++ )
+    {
+        if ( share ) r[i].data = vec_share_int64_t( source );
+        else r[i].data = vec_append_vec_int64_t( vec_new_int64_t( 0, 0 ), source );
+        r[i].writes = one_writes && i == 0;
+    }
+    *handoff = now() - start;
+    for ( size_t i = 0; i < readers; i++ ) pthread_create( &r[i].tid, NULL, read_vector, &r[i] );
+    for ( size_t i = 0; i < readers; i++ ) pthread_join( r[i].tid, NULL );
+    double seconds = now() - start;
+    for ( size_t i = 1; i < readers; i++ )
+    {
+        if ( r[i].sum != r[0].sum - ( one_writes ? 1 : 0 ) ) printf( "MISMATCH in reader %zu\n", i );
+    }
+    free( r );
+    return seconds;
+}
+
+
+int main( int argc, char** argv )
+{
+    size_t size = argc > 1 ? strtoull( argv[1], NULL, 10 ) : 10000000;
+    size_t max_readers = argc > 2 ? strtoull( argv[2], NULL, 10 ) : 16;
+    int64_t* source = vec_new_int64_t( 0, 0 );
+    for ( size_t i = 0; i < size; i++ ) source = vec_push_back_int64_t( source, (int64_t) i );
+    printf( "%zu elements ( %.1f MB ) to each reader\n", size, size * sizeof ( int64_t ) / 1e6 );
+    printf( "%8s %-20s %14s %14s %14s\n", "readers", "", "handoff ms", "total ms", "copied MB" );
+
+    for ( size_t readers = 1; readers <= max_readers; readers *= 2 )
+    {
+        double handoff;
+        double seconds = fan_out( source, readers, false, false, &handoff );
+        printf( "%8zu %-20s %14.2f %14.2f %14.1f\n", readers, "copy per reader", handoff * 1e3, seconds * 1e3,
+                readers * size * sizeof ( int64_t ) / 1e6 );
+        seconds = fan_out( source, readers, true, false, &handoff );
+        printf( "%8zu %-20s %14.3f %14.2f %14.1f\n", readers, "vec_share", handoff * 1e3, seconds * 1e3, 0.0 );
+        seconds = fan_out( source, readers, true, true, &handoff );
+        printf( "%8zu %-20s %14.3f %14.2f %14.1f\n", readers, "vec_share, 1 writer", handoff * 1e3, seconds * 1e3,
+                size * sizeof ( int64_t ) / 1e6 );
+    }
+    vec_destroy_int64_t( source );
+    return 0;
+}
@@ -0,0 +1,119 @@
+// a FIFO work queue on the ring-buffer deque against a vector that inserts at the front and pops at the back
+// the queue is filled to depth, then every operation adds one item and takes the oldest one out
+// build: cc -O2 -I.. bench_deque.c -o bench_deque
+// usage: ./bench_deque [depth, default 10000] [operations, default 200000] [batch, default 64]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+#include "vec_deque.h"
+
+
+using_vector( int )
+using_deque( int )
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// keeps the compiler from dropping the work
+static volatile long sink;
+
+static void report( const char* name, size_t ops, double seconds )
+{
+    printf( "%-28s %12.2f %12.2f\n", name, seconds / ops * 1e9, ops / seconds / 1e6 );
+}
+
+
+int main( int argc, char** argv )
+{
+    size_t depth = argc > 1 ? strtoull( argv[1], NULL, 10 ) : 10000;
+    size_t ops = argc > 2 ? strtoull( argv[2], NULL, 10 ) : 200000;
+    size_t batch = argc > 3 ? strtoull( argv[3], NULL, 10 ) : 64;
+    if ( batch == 0 ) batch = 1;
+    printf( "queue depth %zu, %zu operations\n", depth, ops );
+    printf( "%-28s %12s %12s\n", "", "ns/op", "Mops/s" );
+
+    // vector: new work goes in at the front, the oldest item is the last one
+    int* vec = vec_new_int( 0, 0 );
+    for ( size_t i = 0; i < depth; i++ ) vec = vec_insert_int( vec, 0, (int) i );
+    double start = now();
+    long sum = 0;
+    for ( size_t i = 0; i < ops; i++ )
+    {
+        vec = vec_insert_int( vec, 0, (int) i );
+        sum += *vec_back_int( vec );
+        vec = vec_pop_back_int( vec );
+    }
+    report( "vec_insert( 0 ) + pop_back", ops, now() - start );
+    sink = sum;
+
+    // vector the other way round: push at the back, erase the front
+    vec = vec_clear_int( vec );
+    for ( size_t i = 0; i < depth; i++ ) vec = vec_push_back_int( vec, (int) i );
+    start = now();
+    sum = 0;
+    for ( size_t i = 0; i < ops; i++ )
+    {
+        vec = vec_push_back_int( vec, (int) i );
+        sum += vec[0];
+        vec = vec_erase_range_int( vec, 0, 1 );
+    }
+    report( "push_back + erase( 0 )", ops, now() - start );
+    sink = sum;
+    vec_destroy_int( vec );
+
+    // deque, one item at a time
+    vec_deque_int* deque = vec_deque_new_int( 0 );
+    for ( size_t i = 0; i < depth; i++ ) deque = vec_deque_push_back_int( deque, (int) i );
+    start = now();
+    sum = 0;
+    for ( size_t i = 0; i < ops; i++ )
+    {
+        deque = vec_deque_push_back_int( deque, (int) i );
+        sum += vec_deque_pop_front_int( deque );
+    }
+    report( "deque push_back + pop_front", ops, now() - start );
+    sink = sum;
+
+    // deque, the consumer takes batch items at a time through the contiguous spans
+    int* items = malloc( batch * sizeof ( int ) );
+    start = now();
+    sum = 0;
+    for ( size_t i = 0; i < ops; i += batch )
+    {
+        size_t count = ops - i < batch ? ops - i : batch;
+        for ( size_t j = 0; j < count; j++ ) items[j] = (int) ( i + j );
+        deque = vec_deque_push_back_arr_int( deque, items, count );
+        while ( count > 0 )
+        {
+            int* span;
+            size_t n = vec_deque_span_int( deque, 0, &span );
+            if ( n > count ) n = count;
+            for ( size_t j = 0; j < n; j++ ) sum += span[j];
+            vec_deque_drop_front_int( deque, n );
+            count -= n;
+        }
+    }
+    report( "deque batched spans", ops, now() - start );
+    sink = sum;
+    free( items );
+
+    // FIFO growing from an empty deque, the capacity doubles as it fills
+    vec_deque_clear_int( deque );
+    deque = vec_deque_shrink_to_fit_int( deque );
+    start = now();
+    for ( size_t i = 0; i < ops; i++ ) deque = vec_deque_push_back_int( deque, (int) i );
+    while ( vec_deque_size_int( deque ) > 0 ) sum += vec_deque_pop_front_int( deque );
+    report( "deque fill + drain", 2 * ops, now() - start );
+    sink = sum;
+    vec_deque_destroy_int( deque );
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+// push_back throughput under each growth policy
+// build: cc -O2 -I.. bench_growth.c -o bench_growth
+// usage: ./bench_growth [max elements, default 100000000]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+
+
+typedef int int_2x;
+typedef int int_1_5x;
+typedef int int_tiered;
+
+using_vector_policy( int_2x, vec_growth_2x )
+using_vector_policy( int_1_5x, vec_growth_1_5x )
+using_vector_policy( int_tiered, vec_growth_tiered )
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// push max elements, report ns/op for every decade so a linear growth would show up as a rising column
+#define BENCH_PUSH( T, max )                                                                                \
+{                                                                                                           \
+    T* vec = vec_new_##T( 0, 0 );                                                                           \
+    double start = now();                                                                                   \
+    size_t next = 10;                                                                                       \
+    printf( "%-12s", #T );                                                                                  \
+    for ( size_t i = 0; i < max; i++ )                                                                      \
+    {                                                                                                       \
+        vec = vec_push_back_##T( vec, (T) i );                                                              \
+        if ( i + 1 == next )                                                                                \
+        {                                                                                                   \
+            printf( " %8.2f", ( now() - start ) * 1e9 / next );                                             \
+            next *= 10;                                                                                     \
+        }                                                                                                   \
+    }                                                                                                       \
+    printf( "    cap %zu\n", vec_capacity_##T( vec ) );                                                     \
+    vec_destroy_##T( vec );                                                                                 \
+}                                                                                                           \
+
+int main( int argc, char** argv )
+{
+    size_t max = argc > 1 ? strtoull( argv[1], NULL, 10 ) : 100000000;
+
+    printf( "%-12s", "ns/op at" );
+    for ( size_t n = 10; n <= max; n *= 10 )
+    {
+        printf( " %8.0e", (double) n );
+    }
+    printf( "\n" );
+
+    BENCH_PUSH( int_2x, max );
+    BENCH_PUSH( int_1_5x, max );
+    BENCH_PUSH( int_tiered, max );
+
+    return 0;
+}
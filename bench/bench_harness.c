@@ -0,0 +1,377 @@
+// regression harness: ns/op, allocations/op and peak RSS of the core operations across sizes
+// build: make bench ( vec_gen writes the vectors from bench/harness.manifest, compiled with VECTOR_STATS )
+// usage: ./bench_harness [--sizes 10,1000,100000,10000000,100000000] [--baseline file] [--write file]
+//                        [--tolerance 0.3]
+// every case runs in its own child processes so its peak RSS is its own, timings are the best of several runs
+// in each of 3 children, since page placement makes whole processes faster or slower than the next one
+// ns/op is per element, a push_pop op is one push and one pop, insert_middle makes 16 inserts at the middle
+// and reserve grows the capacity to the size in 16 steps, so both are per element of the vector
+// with --baseline it exits 1 when a case got slower by more than the tolerance, allocates more per op,
+// or needs more than the tolerance of extra memory
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "harness.h"
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static unsigned rng_state = 12345;
+static unsigned rng( void )
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static size_t allocations( void )
+{
+    return vec_stats_int()->allocs + vec_stats_int()->reallocs
+         + vec_stats_double()->allocs + vec_stats_double()->reallocs;
+}
+
+// keeps results alive so the loops are not optimized away
+static volatile double sink;
+
+
+// one timed run of a case over n elements, returns seconds, the setup before start is not timed
+typedef double (*case_fn)( size_t n );
+
+static double case_push_back( size_t n )
+{
+    double start = now();
+    int* v = vec_new( 0, 0 );
+    for ( size_t i = 0; i < n; i++ ) v = vec_push_back( v, (int) i );
+    sink = v[ n / 2 ];
+    vec_destroy( v );
+    return now() - start;
+}
+
+static double case_push_reserved( size_t n )
+{
+    double start = now();
+    int* v = vec_reserve( vec_new( 0, 0 ), n );
+    for ( size_t i = 0; i < n; i++ ) v = vec_push_back( v, (int) i );
+    sink = v[ n / 2 ];
+    vec_destroy( v );
+    return now() - start;
+}
+
+static double case_push_pop( size_t n )
+{
+    double start = now();
+    int* v = vec_new( 0, 0 );
+    for ( size_t i = 0; i < n; i++ ) v = vec_push_back( v, (int) i );
+    for ( size_t i = 0; i < n; i++ ) v = vec_pop_back( v );
+    sink = vec_capacity( v );
+    vec_destroy( v );
+    return now() - start;
+}
+
+static double case_append_arr( size_t n )
+{
+    int chunk[64];
+    for ( int i = 0; i < 64; i++ ) chunk[i] = i;
+    double start = now();
+    int* v = vec_new( 0, 0 );
+    for ( size_t i = 0; i < n; i += 64 ) v = vec_append_arr( v, chunk, n - i < 64 ? n - i : 64 );
+    sink = v[ n / 2 ];
+    vec_destroy( v );
+    return now() - start;
+}
+
+static double case_insert_middle( size_t n )
+{
+    int* v = vec_new( n, 0 );
+    double start = now();
+    for ( int i = 0; i < 16; i++ ) v = vec_insert( v, vec_size( v ) / 2, i );
+    double time = now() - start;
+    sink = v[ n / 2 ];
+    vec_destroy( v );
+    return time;
+}
+
+static double case_pop_back( size_t n )
+{
+    int* v = vec_new( n, 0 );
+    double start = now();
+    for ( size_t i = 0; i < n; i++ ) v = vec_pop_back( v );
+    double time = now() - start;
+    sink = vec_capacity( v );
+    vec_destroy( v );
+    return time;
+}
+
+static double case_resize( size_t n )
+{
+    double start = now();
+    int* v = vec_resize( vec_new( 0, 0 ), n, 1 );
+    sink = v[ n / 2 ];
+    vec_destroy( v );
+    return now() - start;
+}
+
+static double case_assign( size_t n )
+{
+    int* v = vec_new( n, 0 );
+    double start = now();
+    v = vec_assign( v, n, 1 );
+    double time = now() - start;
+    sink = v[ n / 2 ];
+    vec_destroy( v );
+    return time;
+}
+
+// a clear op is a clear and the pushes back to the size, which reuse the capacity clear kept
+static double case_clear( size_t n )
+{
+    int* v = vec_new( n, 0 );
+    double start = now();
+    v = vec_clear( v );
+    for ( size_t i = 0; i < n; i++ ) v = vec_push_back( v, (int) i );
+    double time = now() - start;
+    sink = v[ n / 2 ];
+    vec_destroy( v );
+    return time;
+}
+
+static double case_reserve( size_t n )
+{
+    double start = now();
+    int* v = vec_new( 0, 0 );
+    for ( size_t i = 1; i <= 16; i++ ) v = vec_reserve( v, n * i / 16 );
+    sink = vec_capacity( v );
+    vec_destroy( v );
+    return now() - start;
+}
+
+static double case_sort( size_t n )
+{
+    int* v = vec_new( n, 0 );
+    for ( size_t i = 0; i < n; i++ ) v[i] = (int) rng();
+    double start = now();
+    vec_sort( v );
+    double time = now() - start;
+    sink = v[ n / 2 ];
+    vec_destroy( v );
+    return time;
+}
+
+static double case_radix_sort( size_t n )
+{
+    int* v = vec_new( n, 0 );
+    for ( size_t i = 0; i < n; i++ ) v[i] = (int) rng();
+    double start = now();
+    vec_radix_sort( v );
+    double time = now() - start;
+    sink = v[ n / 2 ];
+    vec_destroy( v );
+    return time;
+}
+
+static double case_sum( size_t n )
+{
+    double* v = vec_new( n, 1.0 );
+    double start = now();
+    sink = vec_sum( v );
+    double time = now() - start;
+    vec_destroy( v );
+    return time;
+}
+
+static const struct
+{
+    const char* name;
+    case_fn run;
+} cases[] = {
+    { "push_back", case_push_back },
+    { "push_reserved", case_push_reserved },
+    { "push_pop", case_push_pop },
+    { "append_arr", case_append_arr },
+    { "insert_middle", case_insert_middle },
+    { "pop_back", case_pop_back },
+    { "resize", case_resize },
+    { "assign", case_assign },
+    { "clear", case_clear },
+    { "reserve", case_reserve },
+    { "sort", case_sort },
+    { "radix_sort", case_radix_sort },
+    { "sum", case_sum },
+};
+#define CASES ( sizeof ( cases ) / sizeof ( cases[0] ) )
+#define CHILDREN 3
+
+
+typedef struct result
+{
+    double ns_per_op;
+    double allocs_per_op;
+    long peak_kb;
+} result;
+
+// run a case in a child, best of at least 3 runs and 0.2 s, allocations from the first run
+static bool measure( case_fn run, size_t n, result* out )
+{
+    int fds[2];
+    if ( pipe( fds ) != 0 ) return false;
+    pid_t pid = fork();
+    if ( pid < 0 ) return false;
+    if ( pid == 0 )
+    {
+        close( fds[0] );
+        size_t before = allocations();
+        double best = run( n );
+        result r = { .allocs_per_op = (double) ( allocations() - before ) / n };
+        double total = best;
+        for ( int runs = 1; runs < 3 || total < 0.2; runs++ )
+        {
+            double time = run( n );
+            total += time;
+            if ( time < best ) best = time;
+        }
+        r.ns_per_op = best * 1e9 / n;
+        _exit( write( fds[1], &r, sizeof r ) == sizeof r ? 0 : 1 );
+    }
+    close( fds[1] );
+    ssize_t got = read( fds[0], out, sizeof *out );
+    close( fds[0] );
+    int status;
+    struct rusage usage;
+    if ( wait4( pid, &status, 0, &usage ) != pid || !WIFEXITED( status ) || WEXITSTATUS( status ) != 0 ) return false;
+    out->peak_kb = usage.ru_maxrss;
+    return got == sizeof *out;
+}
+
+
+typedef struct entry
+{
+    char name[64];
+    size_t size;
+    result r;
+} entry;
+
+// baseline lines are `case size ns_per_op allocs_per_op peak_kb`, '#' starts a comment line
+static size_t read_baseline( const char* path, entry* entries, size_t max )
+{
+    FILE* file = fopen( path, "r" );
+    if ( file == NULL )
+    {
+        perror( path );
+        exit(1);
+    }
+    char line[256];
+    size_t count = 0;
+    while ( count < max && fgets( line, sizeof line, file ) != NULL )
+    {
+        entry* e = &entries[count];
+        if ( line[0] == '#' ) continue;
+        if ( sscanf( line, "%63s %zu %lf %lf %ld", e->name, &e->size, &e->r.ns_per_op, &e->r.allocs_per_op,
+                     &e->r.peak_kb ) == 5 ) count++;
+    }
+    fclose( file );
+    return count;
+}
+
+int main( int argc, char** argv )
+{
+    size_t sizes[16] = { 10, 1000, 100000, 10000000, 100000000 };
+    size_t nsizes = 5;
+    const char* baseline = NULL;
+    const char* output = NULL;
+    double tolerance = 0.3;
+
+    for ( int i = 1; i + 1 < argc; i += 2 )
+    {
+        if ( strcmp( argv[i], "--sizes" ) == 0 )
+        {
+            nsizes = 0;
+            for ( char* s = strtok( argv[ i + 1 ], "," ); s && nsizes < 16; s = strtok( NULL, "," ) )
+            {
+                sizes[ nsizes++ ] = strtoull( s, NULL, 10 );
+            }
+        }
+        else if ( strcmp( argv[i], "--baseline" ) == 0 ) baseline = argv[ i + 1 ];
+        else if ( strcmp( argv[i], "--write" ) == 0 ) output = argv[ i + 1 ];
+        else if ( strcmp( argv[i], "--tolerance" ) == 0 ) tolerance = strtod( argv[ i + 1 ], NULL );
+        else
+        {
+            fprintf( stderr, "[usage]: %s [--sizes a,b,c] [--baseline file] [--write file] [--tolerance 0.3]\n", argv[0] );
+            return 2;
+        }
+    }
+
+    static entry base[ 1024 ];
+    size_t nbase = baseline ? read_baseline( baseline, base, 1024 ) : 0;
+    FILE* out = NULL;
+    if ( output != NULL )
+    {
+        out = fopen( output, "w" );
+        if ( out == NULL )
+        {
+            perror( output );
+            return 1;
+        }
+        fprintf( out, "# case size ns_per_op allocs_per_op peak_kb\n" );
+    }
+
+    int regressions = 0;
+    printf( "%-14s %10s %10s %11s %10s   %s\n", "case", "size", "ns/op", "allocs/op", "peak MB",
+            baseline ? "against baseline" : "" );
+    for ( size_t c = 0; c < CASES; c++ )
+    {
+        for ( size_t s = 0; s < nsizes; s++ )
+        {
+            result r, again;
+            for ( int child = 0; child < CHILDREN; child++ )
+            {
+                if ( sizes[s] == 0 || !measure( cases[c].run, sizes[s], child ? &again : &r ) )
+                {
+                    fprintf( stderr, "[ERRO]: %s at %zu failed\n", cases[c].name, sizes[s] );
+                    return 1;
+                }
+                if ( child && again.ns_per_op < r.ns_per_op ) r.ns_per_op = again.ns_per_op;
+                if ( child && again.peak_kb < r.peak_kb ) r.peak_kb = again.peak_kb;
+            }
+            printf( "%-14s %10zu %10.2f %11.4f %10.1f", cases[c].name, sizes[s], r.ns_per_op, r.allocs_per_op,
+                    r.peak_kb / 1024.0 );
+            if ( out ) fprintf( out, "%s %zu %.9g %.9g %ld\n", cases[c].name, sizes[s], r.ns_per_op, r.allocs_per_op,
+                                r.peak_kb );
+            const entry* b = NULL;
+            for ( size_t i = 0; i < nbase; i++ )
+            {
+                if ( strcmp( base[i].name, cases[c].name ) == 0 && base[i].size == sizes[s] ) b = &base[i];
+            }
+            if ( b != NULL )
+            {
+                // memory gets 1 MB of slack for the runtime's own pages
+                bool slower = r.ns_per_op > b->r.ns_per_op * ( 1 + tolerance );
+                bool more_allocs = r.allocs_per_op > b->r.allocs_per_op * 1.01 + 1e-9;
+                bool more_memory = r.peak_kb > b->r.peak_kb * ( 1 + tolerance ) + 1024;
+                printf( "   %+6.1f%% time%s%s%s", ( r.ns_per_op / b->r.ns_per_op - 1 ) * 100,
+                        slower ? "  SLOWER" : "", more_allocs ? "  MORE ALLOCS" : "", more_memory ? "  MORE MEMORY" : "" );
+                regressions += slower || more_allocs || more_memory;
+            }
+            else if ( baseline ) printf( "   not in baseline" );
+            printf( "\n" );
+            fflush( stdout );
+        }
+    }
+    if ( out ) fclose( out );
+    if ( regressions )
+    {
+        printf( "%d regression%s against %s\n", regressions, regressions > 1 ? "s" : "", baseline );
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,47 @@
+// call overhead of out-of-line accessors against the VECTOR_INLINE layout
+// build: cc -O2 -I.. bench_inline.c bench_inline_impl.c -o bench_inline
+// usage: ./bench_inline [elements, default 10000000]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "bench_inline.h"
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// fill with push_back, walk with vec_size in the loop condition, sum through vec_back while popping
+#define BENCH_LOOPS( T, n )                                                                                 \
+{                                                                                                           \
+    T* vec = vec_new_##T( 0, 0 );                                                                           \
+    long long sum = 0;                                                                                      \
+    double t0 = now();                                                                                      \
+    for ( size_t i = 0; i < n; i++ ) vec = vec_push_back_##T( vec, (T) i );                                 \
+    double t1 = now();                                                                                      \
+    for ( size_t i = 0; i < vec_size_##T( vec ); i++ ) sum += vec[i];                                       \
+    double t2 = now();                                                                                      \
+    while ( vec_size_##T( vec ) )                                                                           \
+    {                                                                                                       \
+        sum += *vec_back_##T( vec );                                                                        \
+        vec = vec_pop_back_##T( vec );                                                                      \
+    }                                                                                                       \
+    double t3 = now();                                                                                      \
+    printf( "%-12s push %6.2f    size loop %6.2f    back+pop %6.2f ns/op    (%lld)\n", #T,                  \
+            ( t1 - t0 ) * 1e9 / n, ( t2 - t1 ) * 1e9 / n, ( t3 - t2 ) * 1e9 / n, sum );                     \
+    vec_destroy_##T( vec );                                                                                 \
+}                                                                                                           \
+
+int main( int argc, char** argv )
+{
+    size_t n = argc > 1 ? strtoull( argv[1], NULL, 10 ) : 10000000;
+
+    BENCH_LOOPS( int, n );
+    BENCH_LOOPS( int_inline, n );
+
+    return 0;
+}
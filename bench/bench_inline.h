@@ -0,0 +1,7 @@
+// the same vector generated twice, once with out-of-line hot paths, once with inline ones
+#include "vector.h"
+
+typedef int int_inline;
+
+using_vector_ex( int, VEC_GROWTH_DEFAULT, VEC_HEADER_ALIGN, extern )
+using_vector_ex( int_inline, VEC_GROWTH_DEFAULT, VEC_HEADER_ALIGN, inline )
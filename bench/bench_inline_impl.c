@@ -0,0 +1,3 @@
+// vec.c of bench_inline, kept in its own translation unit so nothing is inlined across it without LTO
+#define VECTOR_IMPLEMENTATION
+#include "bench_inline.h"
@@ -0,0 +1,68 @@
+// growth and scan of a vector past 1 GB: malloc/realloc against the vec_large mmap allocator
+// build: cc -O2 -I.. bench_large.c -o bench_large
+// usage: ./bench_large [elements, default 134217728 ( 1 GB of uint64_t )] [threshold bytes, default 4 MB]
+// growth is push_back from empty, so every reallocation of the big block is on the clock
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+#include "vec_alloc.h"
+
+
+using_vector( uint64_t )
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t sum( uint64_t* self )
+{
+    uint64_t s = 0;
+    for ( size_t i = 0; i < vec_size_uint64_t( self ); i++ ) s += self[i];
+    return s;
+}
+
+static void run( const char* name, const vec_allocator* alloc, size_t n )
+{
+    double start = now();
+    uint64_t* v = vec_new_with_alloc_uint64_t( 0, 0, alloc );
+    for ( size_t i = 0; i < n; i++ ) v = vec_push_back_uint64_t( v, i );
+    double grow = now() - start;
+
+    uint64_t expect = (uint64_t) n * ( n - 1 ) / 2;
+    double bytes = (double) n * sizeof ( uint64_t );
+    start = now();
+    uint64_t s = sum( v );
+    double scan = now() - start;
+    start = now();
+    s += sum( v );
+    double again = now() - start;
+    printf( "%-14s grow %8.1f ms  %6.2f ns/push   scan %6.2f GB/s  %6.2f GB/s   %s\n", name, grow * 1e3,
+            grow * 1e9 / n, bytes / scan / 1e9, bytes / again / 1e9, s == 2 * expect ? "ok" : "WRONG" );
+    vec_destroy_uint64_t( v );
+}
+
+int main( int argc, char** argv )
+{
+    size_t n = argc > 1 ? strtoull( argv[1], NULL, 10 ) : (size_t) 1 << 27;
+    size_t threshold = argc > 2 ? strtoull( argv[2], NULL, 10 ) : 0;
+
+    printf( "%zu uint64_t ( %.2f GB )\n", n, n * sizeof ( uint64_t ) / 1e9 );
+    run( "malloc", NULL, n );
+
+    vec_large large;
+    vec_large_init( &large, threshold, false );
+    run( "mmap", &large.allocator, n );
+
+    vec_large huge;
+    vec_large_init( &huge, threshold, true );
+    run( "mmap + THP", &huge.allocator, n );
+    return 0;
+}
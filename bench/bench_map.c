@@ -0,0 +1,131 @@
+// inserts and lookups on the flat hash map from 10^3 keys up to the largest size asked for
+// at the small sizes the lookups are also timed as a linear scan over a vector, the hand-rolled lookup table
+// the map replaces
+// build: cc -O2 -I.. bench_map.c -o bench_map
+// usage: ./bench_map [largest size, default 10000000, 100000000 needs about 2.5 GB] [lookups, default 1000000]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+#include "vec_map.h"
+
+
+// keys per vec_map_get_batch call
+#define BATCH 256
+
+typedef uint64_t u64;
+
+using_vector( u64 )
+using_flat_map( u64, u64, VEC_HASH, VEC_EQ )
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// keeps the compiler from dropping the work
+static volatile u64 sink;
+
+static u64 rng_state = 0x2545F4914F6CDD1DULL;
+
+static u64 next_random( void )
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static void report( const char* name, size_t ops, double seconds )
+{
+    printf( "  %-22s %10.1f ns/op %10.2f Mops/s\n", name, seconds / ops * 1e9, ops / seconds / 1e6 );
+}
+
+
+int main( int argc, char** argv )
+{
+    size_t largest = argc > 1 ? strtoull( argv[1], NULL, 10 ) : 10000000;
+    size_t lookups = argc > 2 ? strtoull( argv[2], NULL, 10 ) : 1000000;
+    u64* probes = vec_new_u64( lookups, 0 );
+    u64* found[ BATCH ];
+
+    for ( size_t n = 1000; n <= largest; n *= 10 )
+    {
+        // odd keys are in the map, even ones are misses
+        u64* keys = vec_new_u64( n, 0 );
+        for ( size_t i = 0; i < n; i++ ) keys[i] = next_random() | 1;
+
+        vec_map_u64_u64* map = vec_map_new_u64_u64( 0 );
+        double start = now();
+        for ( size_t i = 0; i < n; i++ ) map = vec_map_put_u64_u64( map, keys[i], i );
+        double grow = now() - start;
+        size_t capacity = vec_map_capacity_u64_u64( map );
+        printf( "%zu keys, %zu slots, %.1f MB\n", n, capacity,
+                ( capacity * ( sizeof ( vec_map_entry_u64_u64 ) + 1 ) ) / 1e6 );
+        report( "insert", n, grow );
+
+        vec_map_clear_u64_u64( map );
+        map = vec_map_reserve_u64_u64( map, n );
+        start = now();
+        for ( size_t i = 0; i < n; i++ ) map = vec_map_put_u64_u64( map, keys[i], i );
+        report( "insert reserved", n, now() - start );
+
+        for ( size_t i = 0; i < lookups; i++ ) probes[i] = keys[ next_random() % n ];
+        u64 sum = 0;
+        start = now();
+        for ( size_t i = 0; i < lookups; i++ ) sum += *vec_map_get_u64_u64( map, probes[i] );
+        report( "lookup hit", lookups, now() - start );
+
+        // a consumer looking up BATCH keys at a time and using the values right away
+        start = now();
+        for ( size_t i = 0; i < lookups; i += BATCH )
+        {
+            size_t count = lookups - i < BATCH ? lookups - i : BATCH;
+            vec_map_get_batch_u64_u64( map, probes + i, count, found );
+            for ( size_t j = 0; j < count; j++ ) sum += *found[j];
+        }
+        report( "lookup hit, batched", lookups, now() - start );
+
+        for ( size_t i = 0; i < lookups; i++ ) probes[i] = next_random() & ~(u64) 1;
+        start = now();
+        for ( size_t i = 0; i < lookups; i++ ) sum += vec_map_contains_u64_u64( map, probes[i] );
+        report( "lookup miss", lookups, now() - start );
+
+        if ( n <= 10000 )
+        {
+            // the linear scan a plain vector needs, over the same hit keys
+            size_t scans = lookups / ( n / 100 );
+            for ( size_t i = 0; i < scans; i++ ) probes[i] = keys[ next_random() % n ];
+            start = now();
+            for ( size_t i = 0; i < scans; i++ )
+            {
+                for ( size_t j = 0; j < n; j++ )
+                {
+                    if ( keys[j] == probes[i] )
+                    {
+                        sum += j;
+                        break;
+                    }
+                }
+            }
+            report( "vector linear scan", scans, now() - start );
+        }
+
+        start = now();
+        for ( size_t i = 0; i < n; i++ ) vec_map_remove_u64_u64( map, keys[i] );
+        report( "remove", n, now() - start );
+        sink = sum;
+
+        vec_map_destroy_u64_u64( map );
+        vec_destroy_u64( keys );
+    }
+
+    vec_destroy_u64( probes );
+    return 0;
+}
@@ -0,0 +1,102 @@
+// startup time of a saved vector: vec_map_file against reading it back with fread
+// build: cc -O2 -I.. bench_mmap.c -o bench_mmap
+// usage: ./bench_mmap [doubles, default 268435456 ( 2 GB )] [file, default bench_mmap.vec]
+// the file is read right after it was written, so both paths start from a warm page cache
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+#include "vec_mmap.h"
+
+
+using_vector( double )
+using_vector_mmap( double )
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// the fread path: header, then one big read into a fresh vector
+static double* load_fread( const char* path )
+{
+    FILE* file = fopen( path, "rb" );
+    if ( file == NULL ) return NULL;
+    vec_file_header header;
+    if ( fread( &header, sizeof header, 1, file ) != 1 || fseek( file, (long) header.data_offset, SEEK_SET ) != 0 )
+    {
+        fclose( file );
+        return NULL;
+    }
+    double* self = vec_new_double( header.size, 0.0 );
+    size_t got = fread( self, sizeof ( double ), header.size, file );
+    fclose( file );
+    if ( got != header.size )
+    {
+        vec_destroy_double( self );
+        return NULL;
+    }
+    return self;
+}
+
+static double sum( double* self )
+{
+    double s = 0;
+    for ( size_t i = 0; i < vec_size_double( self ); i++ ) s += self[i];
+    return s;
+}
+
+int main( int argc, char** argv )
+{
+    size_t n = argc > 1 ? strtoull( argv[1], NULL, 10 ) : (size_t) 1 << 28;
+    const char* path = argc > 2 ? argv[2] : "bench_mmap.vec";
+
+    double* v = vec_new_double( n, 0.0 );
+    for ( size_t i = 0; i < n; i++ ) v[i] = (double) ( i & 1023 );
+    double start = now();
+    if ( vec_save_double( v, path ) != VEC_OK )
+    {
+        perror( path );
+        return 1;
+    }
+    printf( "%zu doubles ( %.2f GB ), saved in %.1f ms\n", n, n * sizeof ( double ) / 1e9, ( now() - start ) * 1e3 );
+    double expect = sum( v );
+    vec_destroy_double( v );
+
+    start = now();
+    double* loaded = load_fread( path );
+    double load = now() - start;
+    if ( loaded == NULL )
+    {
+        perror( path );
+        return 1;
+    }
+    start = now();
+    double s = sum( loaded );
+    double scan = now() - start;
+    printf( "%-10s startup %10.3f ms   first scan %8.1f ms   %s\n", "fread", load * 1e3, scan * 1e3,
+            s == expect ? "ok" : "WRONG" );
+    vec_destroy_double( loaded );
+
+    start = now();
+    double* mapped = vec_map_file_double( path, VEC_MAP_READ );
+    load = now() - start;
+    start = now();
+    s = sum( mapped );
+    scan = now() - start;
+    printf( "%-10s startup %10.3f ms   first scan %8.1f ms   %s\n", "mmap", load * 1e3, scan * 1e3,
+            s == expect ? "ok" : "WRONG" );
+    start = now();
+    s = sum( mapped );
+    printf( "%-10s %29s second scan %7.1f ms   %s\n", "mmap", "", ( now() - start ) * 1e3,
+            s == expect ? "ok" : "WRONG" );
+    vec_destroy_double( mapped );
+
+    remove( path );
+    return 0;
+}
@@ -0,0 +1,146 @@
+// compressed integer vectors against plain ones: the compression ratio of each format on a few typical columns,
+// and the speed of appending, of decoding back into a plain vector, of counting a range and of lower_bound
+// decode GB/s counts the bytes of the decoded values, the plain row is a memcpy of the same vector
+// build: cc -O2 -I.. bench_pack.c -o bench_pack
+// usage: ./bench_pack [values, default 10000000]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+#include "vec_pack.h"
+
+
+using_vector( uint32_t )
+using_vector( int64_t )
+using_packed_vector( uint32_t )
+using_packed_vector( int64_t )
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// keeps the compiler from dropping the work
+static volatile size_t sink;
+
+static uint64_t rng_state = 88172645463325252ull;
+
+static uint64_t next_random( void )
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static const char* format_name[] = { "FOR", "DELTA" };
+
+// the same measurements for every element type
+#define BENCH( T )                                                                                          \
+static void bench_##T( const char* name, T* values, int format )                                            \
+{                                                                                                           \
+    size_t n = vec_size_##T( values );                                                                      \
+    double start = now();                                                                                   \
+    vec_packed_##T* packed = vec_packed_new_##T( format );                                                  \
+    for ( size_t i = 0; i < n; i++ ) vec_packed_push_##T( packed, values[i] );                              \
+    double push = now() - start;                                                                            \
+    double ratio = (double) ( n * sizeof ( T ) ) / vec_packed_bytes_##T( packed );                          \
+    double bits = vec_packed_bytes_##T( packed ) * 8.0 / n;                                                 \
+                                                                                                            \
+    int reps = 10;                                                                                          \
+    T* out = vec_new_##T( 0, 0 );                                                                           \
+    out = vec_reserve_##T( out, n );                                                                        \
+    start = now();                                                                                          \
+    for ( int r = 0; r < reps; r++ )                                                                        \
+    {                                                                                                       \
+        out = vec_clear_##T( out );                                                                         \
+        out = vec_packed_decode_##T( packed, out );                                                         \
+    }                                                                                                       \
+    double decode = ( now() - start ) / reps;                                                               \
+    if ( memcmp( out, values, n * sizeof ( T ) ) != 0 ) printf( "MISMATCH in decode\n" );                   \
+                                                                                                            \
+    /* the values between two taken from the middle of the column */                                        \
+    T lo = values[ n / 2 ] < values[ n / 3 ] ? values[ n / 2 ] : values[ n / 3 ];                           \
+    T hi = values[ n / 2 ] < values[ n / 3 ] ? values[ n / 3 ] : values[ n / 2 ];                           \
+    start = now();                                                                                          \
+    size_t count = 0;                                                                                       \
+    for ( int r = 0; r < reps; r++ ) count += vec_packed_count_range_##T( packed, lo, hi );                 \
+    double scan = ( now() - start ) / reps;                                                                 \
+    for ( size_t i = 0; i < n; i++ ) count -= reps * ( values[i] >= lo && values[i] <= hi );                \
+    if ( count != 0 ) printf( "MISMATCH in count_range\n" );                                                \
+                                                                                                            \
+    printf( "%-24s %-6s %8.2f %8.2fx %10.1f %10.2f %10.2f", name, format_name[ format ], bits, ratio,       \
+            n / push / 1e6, n * sizeof ( T ) / decode / 1e9, n / scan / 1e9 );                              \
+    if ( strstr( name, "sorted" ) != NULL )                                                                 \
+    {                                                                                                       \
+        size_t queries = 100000;                                                                            \
+        start = now();                                                                                      \
+        for ( size_t q = 0; q < queries; q++ )                                                              \
+        {                                                                                                   \
+            sink += vec_packed_lower_bound_##T( packed, values[ next_random() % n ] );                      \
+        }                                                                                                   \
+        printf( " %10.0f", ( now() - start ) / queries * 1e9 );                                             \
+    }                                                                                                       \
+    printf( "\n" );                                                                                         \
+    vec_destroy_##T( out );                                                                                 \
+    vec_packed_destroy_##T( packed );                                                                       \
+}                                                                                                           \
+/* the uncompressed baseline of the decode column */                                                        \
+static void bench_plain_##T( const char* name, T* values )                                                  \
+{                                                                                                           \
+    size_t n = vec_size_##T( values );                                                                      \
+    T* out = vec_new_##T( n, 0 );                                                                           \
+    int reps = 10;                                                                                          \
+    double start = now();                                                                                   \
+    for ( int r = 0; r < reps; r++ ) memcpy( out, values, n * sizeof ( T ) );                               \
+    double copy = ( now() - start ) / reps;                                                                 \
+    sink += out[ n / 2 ];                                                                                   \
+    printf( "%-24s %-6s %8.2f %8.2fx %10s %10.2f\n", name, "plain", sizeof ( T ) * 8.0, 1.0, "",            \
+            n * sizeof ( T ) / copy / 1e9 );                                                                \
+    vec_destroy_##T( out );                                                                                 \
+}                                                                                                           \
+
+BENCH( uint32_t )
+BENCH( int64_t )
+
+
+int main( int argc, char** argv )
+{
+    size_t n = argc > 1 ? strtoull( argv[1], NULL, 10 ) : 10000000;
+    printf( "%zu values\n", n );
+    printf( "%-24s %-6s %8s %9s %10s %10s %10s %10s\n", "", "", "bits", "ratio", "push M/s", "decode GB/s",
+            "range G/s", "lower ns" );
+
+    // sorted ids with small random gaps, a posting list or a sorted key column
+    uint32_t* ids = vec_new_uint32_t( 0, 0 );
+    uint32_t id = 0;
+    for ( size_t i = 0; i < n; i++ ) ids = vec_push_back_uint32_t( ids, id += 1 + next_random() % 16 );
+    bench_plain_uint32_t( "sorted ids, gaps < 16", ids );
+    bench_uint32_t( "sorted ids, gaps < 16", ids, VEC_PACK_FOR );
+    bench_uint32_t( "sorted ids, gaps < 16", ids, VEC_PACK_DELTA );
+
+    // small unsorted values, a dictionary code or a counter
+    uint32_t* codes = vec_new_uint32_t( 0, 0 );
+    for ( size_t i = 0; i < n; i++ ) codes = vec_push_back_uint32_t( codes, next_random() % 1000 );
+    bench_uint32_t( "codes < 1000", codes, VEC_PACK_FOR );
+    bench_uint32_t( "codes < 1000", codes, VEC_PACK_DELTA );
+
+    // nanosecond timestamps about a microsecond apart
+    int64_t* times = vec_new_int64_t( 0, 0 );
+    int64_t time = 1700000000000000000;
+    for ( size_t i = 0; i < n; i++ ) times = vec_push_back_int64_t( times, time += 500 + next_random() % 1000 );
+    bench_plain_int64_t( "sorted timestamps", times );
+    bench_int64_t( "sorted timestamps", times, VEC_PACK_FOR );
+    bench_int64_t( "sorted timestamps", times, VEC_PACK_DELTA );
+
+    vec_destroy_uint32_t( ids );
+    vec_destroy_uint32_t( codes );
+    vec_destroy_int64_t( times );
+    return 0;
+}
@@ -0,0 +1,136 @@
+// scaling of the vec_parallel.h algorithms from 1 to N threads
+// build: cc -O2 -I.. bench_parallel.c -o bench_parallel -pthread
+// usage: ./bench_parallel [elements, default 10000000] [max threads, default online cpus]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+#include "vec_sort.h"
+#include "vec_parallel.h"
+
+
+using_vector( double )
+using_vector( int )
+using_vector_sort( int, VEC_LESS )
+using_vector_parallel( double )
+using_vector_parallel( int )
+using_vector_par_sort( int, VEC_LESS )
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t rng_state = 88172645463325252ull;
+static uint32_t rng( void )
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t) rng_state;
+}
+
+static void fill( double* arr, size_t size, void* ctx )
+{
+    double val = *(double*) ctx;
+    for ( size_t i = 0; i < size; i++ ) arr[i] = val;
+}
+
+// a few flops per element so the transform is not purely memory bound
+static void poly( double* dst, const double* src, size_t size, void* ctx )
+{
+    (void) ctx;
+    for ( size_t i = 0; i < size; i++ )
+    {
+        double x = src[i];
+        dst[i] = ( ( 3.0 * x + 2.0 ) * x + 1.0 ) * x + 0.5;
+    }
+}
+
+static double sum( const double* arr, size_t size, void* ctx )
+{
+    (void) ctx;
+    double s = 0;
+    for ( size_t i = 0; i < size; i++ ) s += arr[i];
+    return s;
+}
+
+static double add( double a, double b, void* ctx )
+{
+    (void) ctx;
+    return a + b;
+}
+
+// time BODY, store the seconds in result
+#define TIME( result, BODY )                                                                                \
+{                                                                                                           \
+    double start = now();                                                                                   \
+    BODY;                                                                                                   \
+    result = now() - start;                                                                                 \
+}                                                                                                           \
+
+int main( int argc, char** argv )
+{
+    size_t n = argc > 1 ? strtoull( argv[1], NULL, 10 ) : 10000000;
+    long cpus = sysconf( _SC_NPROCESSORS_ONLN );
+    size_t max_threads = argc > 2 ? strtoull( argv[2], NULL, 10 ) : ( cpus > 0 ? (size_t) cpus : 1 );
+
+    double* src = vec_new_double( n, 1.0 );
+    double* dst = vec_new_double( 0, 0.0 );
+    int* keys = vec_new_int( n, 0 );
+    int* work = vec_new_int( n, 0 );
+    for ( size_t i = 0; i < n; i++ ) keys[i] = (int) rng();
+    // fault the destination in once so the first row does not pay for it
+    dst = vec_reserve_double( dst, n );
+    poly( dst, src, n, NULL );
+
+    printf( "%zu elements\n%-8s %12s %12s %12s %12s   ( ms, speedup against 1 thread )\n", n, "threads",
+            "for_each", "transform", "reduce", "sort" );
+    double base[4] = { 0 };
+    for ( size_t threads = 1; threads <= max_threads; threads = threads < max_threads && threads * 2 > max_threads
+                                                                 ? max_threads : threads * 2 )
+    {
+        vec_thread_pool pool;
+        if ( !vec_thread_pool_init( &pool, threads ) )
+        {
+            printf( "cannot start %zu threads\n", threads );
+            break;
+        }
+        double t[4];
+        double val = (double) threads;
+        volatile double sink;
+        TIME( t[0], vec_par_for_each_double( &pool, src, fill, &val ) );
+        TIME( t[1], dst = vec_par_transform_double( &pool, dst, src, poly, NULL ) );
+        TIME( t[2], sink = vec_par_reduce_double( &pool, dst, 0.0, sum, add, NULL ) );
+        (void) sink;
+        memcpy( work, keys, n * sizeof ( int ) );
+        TIME( t[3], vec_par_sort_int( &pool, work ) );
+        for ( size_t i = 1; i < n; i++ )
+        {
+            if ( work[i] < work[ i - 1 ] )
+            {
+                printf( "not sorted at %zu\n", i );
+                return 1;
+            }
+        }
+        if ( threads == 1 ) memcpy( base, t, sizeof base );
+        printf( "%-8zu", threads );
+        for ( size_t k = 0; k < 4; k++ ) printf( " %6.1f %4.1fx", t[k] * 1e3, base[k] / t[k] );
+        printf( "\n" );
+        vec_thread_pool_destroy( &pool );
+        if ( threads == max_threads ) break;
+    }
+
+    vec_destroy_double( src );
+    vec_destroy_double( dst );
+    vec_destroy_int( keys );
+    vec_destroy_int( work );
+    return 0;
+}
@@ -0,0 +1,92 @@
+// GB/s of the vec_simd.h kernels against naive loops
+// build: cc -O2 -I.. bench_simd.c -o bench_simd
+// usage: ./bench_simd [elements, default 1048576] [rounds, default 200]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+#include "vec_simd.h"
+
+
+using_vector( int )
+using_vector( int64_t )
+using_vector( float )
+using_vector( double )
+using_vector_numeric( int )
+using_vector_numeric( int64_t )
+using_vector_numeric( float )
+using_vector_numeric( double )
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// keeps the compiler from dropping the work of a round
+static volatile double sink;
+
+// time rounds repetitions of BODY, which touches bytes bytes per round, store the GB/s in result
+#define TIME_GBS( result, BODY, bytes, rounds )                                                             \
+{                                                                                                           \
+    double start = now();                                                                                   \
+    for ( size_t r = 0; r < rounds; r++ ) { BODY; }                                                         \
+    result = (double) ( bytes ) * rounds / ( now() - start ) / 1e9;                                         \
+}                                                                                                           \
+
+#define BENCH_TYPE( T, n, rounds )                                                                          \
+{                                                                                                           \
+    T* x = vec_new_##T( n, (T) 1 );                                                                         \
+    T* y = vec_new_##T( n, (T) 2 );                                                                         \
+    for ( size_t i = 0; i < n; i++ ) x[i] = (T) ( i % 100 );                                                \
+    size_t bytes = n * sizeof ( T );                                                                        \
+    printf( "%-8s %-8s %10s %10s\n", #T, "kernel", "naive", "vec" );                                        \
+    double naive, simd;                                                                                     \
+                                                                                                            \
+    TIME_GBS( naive, for ( size_t i = 0; i < n; i++ ) y[i] = (T) r;, bytes, rounds );                       \
+    TIME_GBS( simd, vec_fill_##T( y, (T) r ), bytes, rounds );                                              \
+    printf( "%-8s %-8s %10.2f %10.2f\n", "", "fill", naive, simd );                                         \
+                                                                                                            \
+    TIME_GBS( naive, T s = 0; for ( size_t i = 0; i < n; i++ ) s += x[i]; sink = s;, bytes, rounds );       \
+    TIME_GBS( simd, sink = vec_sum_##T( x ), bytes, rounds );                                               \
+    printf( "%-8s %-8s %10.2f %10.2f\n", "", "sum", naive, simd );                                          \
+                                                                                                            \
+    TIME_GBS( naive, T lo = x[0]; T hi = x[0];                                                              \
+                      for ( size_t i = 0; i < n; i++ ) { if ( x[i] < lo ) lo = x[i]; if ( x[i] > hi ) hi = x[i]; } \
+                      sink = lo + hi;, bytes, rounds );                                                     \
+    TIME_GBS( simd, T lo; T hi; vec_minmax_##T( x, &lo, &hi ); sink = lo + hi;, bytes, rounds );            \
+    printf( "%-8s %-8s %10.2f %10.2f\n", "", "minmax", naive, simd );                                       \
+                                                                                                            \
+    TIME_GBS( naive, T s = 0; for ( size_t i = 0; i < n; i++ ) s += x[i] * y[i]; sink = s;, 2 * bytes, rounds ); \
+    TIME_GBS( simd, sink = vec_dot_##T( x, y ), 2 * bytes, rounds );                                        \
+    printf( "%-8s %-8s %10.2f %10.2f\n", "", "dot", naive, simd );                                          \
+                                                                                                            \
+    TIME_GBS( naive, for ( size_t i = 0; i < n; i++ ) y[i] += (T) 3 * x[i];, 3 * bytes, rounds );           \
+    TIME_GBS( simd, vec_axpy_##T( y, (T) 3, x ), 3 * bytes, rounds );                                       \
+    printf( "%-8s %-8s %10.2f %10.2f\n", "", "axpy", naive, simd );                                         \
+                                                                                                            \
+    TIME_GBS( naive, for ( size_t i = 0; i < n; i++ ) y[i] *= ( r & 1 ) ? (T) 1 : (T) -1;, 2 * bytes, rounds ); \
+    TIME_GBS( simd, vec_scale_##T( y, ( r & 1 ) ? (T) 1 : (T) -1 ), 2 * bytes, rounds );                    \
+    printf( "%-8s %-8s %10.2f %10.2f\n", "", "scale", naive, simd );                                        \
+                                                                                                            \
+    vec_destroy_##T( x );                                                                                   \
+    vec_destroy_##T( y );                                                                                   \
+}                                                                                                           \
+
+int main( int argc, char** argv )
+{
+    size_t n = argc > 1 ? strtoull( argv[1], NULL, 10 ) : 1048576;
+    size_t rounds = argc > 2 ? strtoull( argv[2], NULL, 10 ) : 200;
+
+    BENCH_TYPE( int, n, rounds );
+    BENCH_TYPE( int64_t, n, rounds );
+    BENCH_TYPE( float, n, rounds );
+    BENCH_TYPE( double, n, rounds );
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+// create / fill / destroy short vectors, heap vec_new against small-vector storage on the stack
+// build: cc -O2 -I.. bench_small.c -o bench_small
+// usage: ./bench_small [rounds, default 10000000]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+
+
+using_vector( int )
+using_small_vector( int, 8 )
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// build a vector of k elements, read it back and throw it away, rounds times
+#define BENCH_ROUNDS( name, NEW, k, rounds )                                                                \
+{                                                                                                           \
+    long long sum = 0;                                                                                      \
+    double start = now();                                                                                   \
+    for ( size_t r = 0; r < rounds; r++ )                                                                   \
+    {                                                                                                       \
+        vec_small_int_8 storage;                                                                            \
+        (void) storage;                                                                                     \
+        int* vec = NEW;                                                                                     \
+        for ( int i = 0; i < k; i++ ) vec = vec_push_back_int( vec, i + (int) r );                          \
+        for ( size_t i = 0; i < vec_size_int( vec ); i++ ) sum += vec[i];                                   \
+        vec_destroy_int( vec );                                                                             \
+    }                                                                                                       \
+    printf( "%-8s %2d elements %8.2f ns/vector    (%lld)\n", name, k, ( now() - start ) * 1e9 / rounds, sum ); \
+}                                                                                                           \
+
+int main( int argc, char** argv )
+{
+    size_t rounds = argc > 1 ? strtoull( argv[1], NULL, 10 ) : 10000000;
+
+    for ( int k = 0; k <= 16; k += 4 )
+    {
+        BENCH_ROUNDS( "heap", vec_new_int( 0, 0 ), k, rounds );
+        BENCH_ROUNDS( "small", vec_small_new_int_8( &storage ), k, rounds );
+    }
+
+    return 0;
+}
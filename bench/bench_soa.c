@@ -0,0 +1,130 @@
+// field scans over a structure-of-arrays vector against the same records in an array of structs
+// the particle record is 32 bytes with 8 fields, a scan that reads one field of the AoS vector still pulls
+// every byte of the record through the cache, the SoA vector reads only the column it needs
+// build: cc -O2 -I.. bench_soa.c -o bench_soa
+// usage: ./bench_soa [rows, default 4194304] [rounds, default 20]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+#include "vec_simd.h"
+#include "vec_soa.h"
+
+
+typedef struct particle
+{
+    float x, y, z;
+    float vx, vy, vz;
+    float mass;
+    int id;
+} particle;
+
+using_vector( particle )
+using_vector( float )
+using_vector_numeric( float )
+using_soa_vector( particles, ( float, x ), ( float, y ), ( float, z ), ( float, vx ), ( float, vy ), ( float, vz ),
+                  ( float, mass ), ( int, id ) )
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// keeps the compiler from dropping the work of a round
+static volatile double sink;
+
+// time rounds repetitions of BODY, store the seconds of one round in result
+#define TIME_ROUND( result, BODY, rounds )                                                                  \
+{                                                                                                           \
+    double start = now();                                                                                   \
+    for ( size_t r = 0; r < rounds; r++ ) { BODY; }                                                         \
+    result = ( now() - start ) / rounds;                                                                    \
+}                                                                                                           \
+
+// one line of the report, bytes are the bytes the scan needs, not the bytes it drags through the cache
+static void report( const char* name, size_t rows, size_t bytes, double aos, double soa )
+{
+    printf( "%-16s %10.2f %10.2f %10.2f %10.2f %8.2fx\n", name, bytes / aos / 1e9, bytes / soa / 1e9,
+            aos / rows * 1e9, soa / rows * 1e9, aos / soa );
+}
+
+
+int main( int argc, char** argv )
+{
+    size_t n = argc > 1 ? strtoull( argv[1], NULL, 10 ) : 4194304;
+    size_t rounds = argc > 2 ? strtoull( argv[2], NULL, 10 ) : 20;
+
+    particle* aos = vec_new_particle( 0, (particle) { 0 } );
+    particles* soa = vec_new_particles( 0, (particles_row) { 0 } );
+    double aos_time, soa_time;
+
+    TIME_ROUND( aos_time, aos = vec_clear_particle( aos );
+                for ( size_t i = 0; i < n; i++ )
+                {
+                    float f = (float) ( i % 1000 );
+                    aos = vec_push_back_particle( aos, (particle) { f, f, f, 1, 2, 3, 1, (int) i } );
+                }, 1 );
+    TIME_ROUND( soa_time, soa = vec_clear_particles( soa );
+                for ( size_t i = 0; i < n; i++ )
+                {
+                    float f = (float) ( i % 1000 );
+                    soa = vec_push_back_particles( soa, (particles_row) { f, f, f, 1, 2, 3, 1, (int) i } );
+                }, 1 );
+
+    printf( "%zu rows of %zu bytes, %zu rounds\n", n, sizeof ( particle ), rounds );
+    printf( "%-16s %10s %10s %10s %10s %9s\n", "", "AoS GB/s", "SoA GB/s", "AoS ns/row", "SoA ns/row", "speedup" );
+    report( "push_back", n, n * sizeof ( particle ), aos_time, soa_time );
+
+    // one field: sum of x
+    TIME_ROUND( aos_time, float s = 0; for ( size_t i = 0; i < n; i++ ) s += aos[i].x; sink = s;, rounds );
+    TIME_ROUND( soa_time, float s = 0; for ( size_t i = 0; i < n; i++ ) s += soa->x[i]; sink = s;, rounds );
+    report( "sum x", n, n * sizeof ( float ), aos_time, soa_time );
+    TIME_ROUND( soa_time, sink = vec_sum_arr_float( soa->x, soa->size ), rounds );
+    report( "sum x (simd)", n, n * sizeof ( float ), aos_time, soa_time );
+
+    // two fields: x += vx * dt
+    TIME_ROUND( aos_time, for ( size_t i = 0; i < n; i++ ) aos[i].x += aos[i].vx * 0.01f;, rounds );
+    TIME_ROUND( soa_time, for ( size_t i = 0; i < n; i++ ) soa->x[i] += soa->vx[i] * 0.01f;, rounds );
+    report( "x += vx * dt", n, 3 * n * sizeof ( float ), aos_time, soa_time );
+    TIME_ROUND( soa_time, vec_axpy_arr_float( soa->x, 0.01f, soa->vx, soa->size ), rounds );
+    report( "x += vx (simd)", n, 3 * n * sizeof ( float ), aos_time, soa_time );
+
+    // three fields, all positions: x, y, z += v * dt
+    TIME_ROUND( aos_time, for ( size_t i = 0; i < n; i++ )
+                {
+                    aos[i].x += aos[i].vx * 0.01f;
+                    aos[i].y += aos[i].vy * 0.01f;
+                    aos[i].z += aos[i].vz * 0.01f;
+                }, rounds );
+    TIME_ROUND( soa_time, for ( size_t i = 0; i < n; i++ )
+                {
+                    soa->x[i] += soa->vx[i] * 0.01f;
+                    soa->y[i] += soa->vy[i] * 0.01f;
+                    soa->z[i] += soa->vz[i] * 0.01f;
+                }, rounds );
+    report( "xyz += v * dt", n, 9 * n * sizeof ( float ), aos_time, soa_time );
+
+    // every field of every row, where the AoS layout has nothing to lose
+    TIME_ROUND( aos_time, double s = 0;
+                for ( size_t i = 0; i < n; i++ )
+                {
+                    particle p = aos[i];
+                    s += p.x + p.y + p.z + p.vx + p.vy + p.vz + p.mass + p.id;
+                } sink = s;, rounds );
+    TIME_ROUND( soa_time, double s = 0;
+                for ( size_t i = 0; i < n; i++ )
+                {
+                    particles_row p = vec_get_particles( soa, i );
+                    s += p.x + p.y + p.z + p.vx + p.vy + p.vz + p.mass + p.id;
+                } sink = s;, rounds );
+    report( "whole rows", n, n * sizeof ( particle ), aos_time, soa_time );
+
+    vec_destroy_particle( aos );
+    vec_destroy_particles( soa );
+    return 0;
+}
@@ -0,0 +1,133 @@
+// vec_sort.h against libc qsort / bsearch on ints and 16-byte records
+// build: cc -O2 -I.. bench_sort.c -o bench_sort
+// usage: ./bench_sort [elements, default 10000000]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+#include "vec_sort.h"
+
+
+typedef struct record
+{
+    uint32_t key;
+    uint32_t payload[3];
+} record;
+
+#define RECORD_LESS( a, b ) ( (a).key < (b).key )
+#define RECORD_KEY( r ) VEC_KEY_UNSIGNED( (r).key )
+
+using_vector( int )
+using_vector( record )
+using_vector_sort( int, VEC_LESS )
+using_vector_radix( int, VEC_KEY_I32 )
+using_vector_sort( record, RECORD_LESS )
+using_vector_radix( record, RECORD_KEY )
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int cmp_int( const void* a, const void* b )
+{
+    int x = *(const int*) a;
+    int y = *(const int*) b;
+    return ( x > y ) - ( x < y );
+}
+
+static int cmp_record( const void* a, const void* b )
+{
+    uint32_t x = ( (const record*) a )->key;
+    uint32_t y = ( (const record*) b )->key;
+    return ( x > y ) - ( x < y );
+}
+
+// xorshift, deterministic across runs
+static uint64_t rng_state = 88172645463325252ull;
+static uint32_t rng( void )
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t) rng_state;
+}
+
+// copy src to dst, time SORT on dst, check the order with LESS
+#define BENCH_SORT( T, name, SORT, LESS, src, dst, n )                                                      \
+{                                                                                                           \
+    memcpy( dst, src, n * sizeof ( T ) );                                                                   \
+    double start = now();                                                                                   \
+    SORT;                                                                                                   \
+    double elapsed = now() - start;                                                                         \
+    for ( size_t i = 1; i < n; i++ )                                                                        \
+    {                                                                                                       \
+        if ( LESS( dst[i], dst[ i - 1 ] ) )                                                                 \
+        {                                                                                                   \
+            printf( "%s: not sorted at %zu\n", name, i );                                                   \
+            exit( 1 );                                                                                      \
+        }                                                                                                   \
+    }                                                                                                       \
+    printf( "  %-14s %8.1f ms %8.2f ns/elem\n", name, elapsed * 1e3, elapsed * 1e9 / n );                   \
+}                                                                                                           \
+
+int main( int argc, char** argv )
+{
+    size_t n = argc > 1 ? strtoull( argv[1], NULL, 10 ) : 10000000;
+
+    int* ints = vec_new_int( n, 0 );
+    int* work = vec_new_int( n, 0 );
+    for ( size_t i = 0; i < n; i++ ) ints[i] = (int) rng();
+    printf( "%zu random ints\n", n );
+    BENCH_SORT( int, "qsort", qsort( work, n, sizeof ( int ), cmp_int ), VEC_LESS, ints, work, n );
+    BENCH_SORT( int, "vec_sort", vec_sort_int( work ), VEC_LESS, ints, work, n );
+    BENCH_SORT( int, "vec_stable", vec_stable_sort_int( work ), VEC_LESS, ints, work, n );
+    BENCH_SORT( int, "vec_radix", vec_radix_sort_int( work ), VEC_LESS, ints, work, n );
+
+    // sorted and few-distinct inputs, the usual quicksort traps
+    for ( size_t i = 0; i < n; i++ ) ints[i] = (int) i;
+    printf( "%zu sorted ints\n", n );
+    BENCH_SORT( int, "qsort", qsort( work, n, sizeof ( int ), cmp_int ), VEC_LESS, ints, work, n );
+    BENCH_SORT( int, "vec_sort", vec_sort_int( work ), VEC_LESS, ints, work, n );
+    for ( size_t i = 0; i < n; i++ ) ints[i] = (int) ( rng() % 16 );
+    printf( "%zu ints in 0..15\n", n );
+    BENCH_SORT( int, "qsort", qsort( work, n, sizeof ( int ), cmp_int ), VEC_LESS, ints, work, n );
+    BENCH_SORT( int, "vec_sort", vec_sort_int( work ), VEC_LESS, ints, work, n );
+
+    // lookups in the sorted array
+    for ( size_t i = 0; i < n; i++ ) ints[i] = (int) rng();
+    vec_sort_int( ints );
+    size_t queries = n < 1000000 ? n : 1000000;
+    for ( size_t i = 0; i < queries; i++ ) work[i] = (int) rng();
+    size_t found = 0;
+    double start = now();
+    for ( size_t i = 0; i < queries; i++ ) found += bsearch( &work[i], ints, n, sizeof ( int ), cmp_int ) != NULL;
+    double lib = now() - start;
+    start = now();
+    for ( size_t i = 0; i < queries; i++ ) found += vec_binary_search_int( ints, work[i] );
+    double vec = now() - start;
+    printf( "%zu lookups ( %zu hits )\n  %-14s %8.2f ns/op\n  %-14s %8.2f ns/op\n", queries, found,
+            "bsearch", lib * 1e9 / queries, "vec_search", vec * 1e9 / queries );
+
+    vec_destroy_int( ints );
+    vec_destroy_int( work );
+
+    record* recs = vec_new_record( n, (record) { 0 } );
+    record* rwork = vec_new_record( n, (record) { 0 } );
+    for ( size_t i = 0; i < n; i++ ) recs[i] = (record) { rng(), { (uint32_t) i, 0, 0 } };
+    printf( "%zu random 16-byte records\n", n );
+    BENCH_SORT( record, "qsort", qsort( rwork, n, sizeof ( record ), cmp_record ), RECORD_LESS, recs, rwork, n );
+    BENCH_SORT( record, "vec_sort", vec_sort_record( rwork ), RECORD_LESS, recs, rwork, n );
+    BENCH_SORT( record, "vec_stable", vec_stable_sort_record( rwork ), RECORD_LESS, recs, rwork, n );
+    BENCH_SORT( record, "vec_radix", vec_radix_sort_record( rwork ), RECORD_LESS, recs, rwork, n );
+    vec_destroy_record( recs );
+    vec_destroy_record( rwork );
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+// push_back / pop_back stack workloads, against the old realloc-per-operation behaviour
+// and the checked vec_try_* variants
+// build: cc -O2 -I.. bench_stack.c -o bench_stack
+// usage: ./bench_stack [operations, default 10000000]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+
+
+using_vector( int )
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+// the previous push_back / pop_back: every call went through resize, which always reallocated,
+// growing 2x up to 1024 elements and by 512 after that, pop_back shrank the buffer every time
+static size_t legacy_capacity( size_t capacity, size_t size )
+{
+    size_t cap = size < 16 ? 16 : size;
+    while ( capacity < cap )
+    {
+        if ( capacity <= 1024 ) capacity *= 2;
+        else capacity += 512;
+    }
+    while ( cap > 1024 && cap + 512 < capacity ) capacity -= 512;
+    while ( cap <= 1024 && cap * 2 < capacity ) capacity /= 2;
+    return capacity;
+}
+
+static int* legacy_push_back( int* self, int val )
+{
+    vec_meta* vector = (vec_meta*) ( (char*) self - sizeof ( vec_meta ) );
+    vector->capacity = legacy_capacity( vector->capacity, vector->size + 1 );
+    vector = realloc( vector, sizeof ( vec_meta ) + sizeof ( int ) * vector->capacity );
+    self = (void*) ( (char*) vector + sizeof ( vec_meta ) );
+    self[ vector->size++ ] = val;
+    return self;
+}
+
+static int* legacy_pop_back( int* self )
+{
+    vec_meta* vector = (vec_meta*) ( (char*) self - sizeof ( vec_meta ) );
+    vector->size--;
+    vector->capacity = legacy_capacity( vector->capacity, vector->size );
+    vector = realloc( vector, sizeof ( vec_meta ) + sizeof ( int ) * vector->capacity );
+    return (void*) ( (char*) vector + sizeof ( vec_meta ) );
+}
+
+static int* legacy_new( void )
+{
+    vec_meta* vector = malloc( sizeof ( vec_meta ) + sizeof ( int ) * 16 );
+    vector->size = 0;
+    vector->capacity = 16;
+    return (void*) ( (char*) vector + sizeof ( vec_meta ) );
+}
+
+
+// the vec_try_* paths, checking every result the way a caller that cannot exit would
+static int* try_push_back( int* self, int val )
+{
+    if ( vec_try_push_back_int( &self, val ) != VEC_OK ) abort();
+    return self;
+}
+
+static int* try_pop_back( int* self )
+{
+    if ( vec_try_pop_back_int( &self ) != VEC_OK ) abort();
+    return self;
+}
+
+
+// push n, pop n
+#define BENCH_FILL_DRAIN( name, NEW, PUSH, POP, FREE, n )                                                   \
+{                                                                                                           \
+    int* vec = NEW;                                                                                         \
+    double start = now();                                                                                   \
+    for ( size_t i = 0; i < n; i++ ) vec = PUSH( vec, (int) i );                                            \
+    double mid = now();                                                                                     \
+    for ( size_t i = 0; i < n; i++ ) vec = POP( vec );                                                      \
+    double end = now();                                                                                     \
+    printf( "%-8s push %8.2f ns/op    pop %8.2f ns/op\n", name,                                             \
+            ( mid - start ) * 1e9 / n, ( end - mid ) * 1e9 / n );                                           \
+    FREE;                                                                                                   \
+}                                                                                                           \
+
+// a stack that hovers around a fixed depth: push 3, pop 2, ... then drain
+#define BENCH_MIXED( name, NEW, PUSH, POP, FREE, n )                                                        \
+{                                                                                                           \
+    int* vec = NEW;                                                                                         \
+    size_t ops = 0;                                                                                         \
+    double start = now();                                                                                   \
+    for ( size_t i = 0; ops < n; i++ )                                                                      \
+    {                                                                                                       \
+        vec = PUSH( vec, (int) i );                                                                         \
+        vec = PUSH( vec, (int) i );                                                                         \
+        vec = PUSH( vec, (int) i );                                                                         \
+        vec = POP( vec );                                                                                   \
+        vec = POP( vec );                                                                                   \
+        ops += 5;                                                                                           \
+        if ( ( i & 1023 ) == 1023 )                                                                         \
+        {                                                                                                   \
+            while ( vec_size_int( vec ) ) vec = POP( vec );                                                 \
+        }                                                                                                   \
+    }                                                                                                       \
+    double end = now();                                                                                     \
+    printf( "%-8s mixed %7.2f ns/op\n", name, ( end - start ) * 1e9 / ops );                                \
+    FREE;                                                                                                   \
+}                                                                                                           \
+
+int main( int argc, char** argv )
+{
+    size_t n = argc > 1 ? strtoull( argv[1], NULL, 10 ) : 10000000;
+
+    BENCH_FILL_DRAIN( "vec", vec_new_int( 0, 0 ), vec_push_back_int, vec_pop_back_int, vec_destroy_int( vec ), n );
+    BENCH_FILL_DRAIN( "vec try", vec_new_int( 0, 0 ), try_push_back, try_pop_back, vec_destroy_int( vec ), n );
+    BENCH_FILL_DRAIN( "legacy", legacy_new(), legacy_push_back, legacy_pop_back,
+                      free( (char*) vec - sizeof ( vec_meta ) ), n );
+    BENCH_MIXED( "vec", vec_new_int( 0, 0 ), vec_push_back_int, vec_pop_back_int, vec_destroy_int( vec ), n );
+    BENCH_MIXED( "vec try", vec_new_int( 0, 0 ), try_push_back, try_pop_back, vec_destroy_int( vec ), n );
+    BENCH_MIXED( "legacy", legacy_new(), legacy_push_back, legacy_pop_back,
+                 free( (char*) vec - sizeof ( vec_meta ) ), n );
+
+    return 0;
+}
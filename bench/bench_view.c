@@ -0,0 +1,126 @@
+// slices of one large vector handed to the numeric and sort kernels: a copy of each slice into its own vector
+// against a vec_view_##T over it, for a range of slice lengths
+// build: cc -O2 -I.. bench_view.c -o bench_view
+// usage: ./bench_view [elements, default 10000000]
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+#include "vec_simd.h"
+#include "vec_sort.h"
+
+
+using_vector( int64_t )
+using_vector_numeric( int64_t )
+using_vector_sort( int64_t, VEC_LESS )
+
+
+static double now( void )
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t rng_state = 88172645463325252ull;
+
+static uint64_t next_random( void )
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+// sum every slice of length slice, copying each into a reused vector first or viewing it in place
+static double sum_slices( int64_t* source, size_t slice, bool view, int64_t* total )
+{
+    size_t size = vec_size_int64_t( source );
+    int64_t* copy = vec_new_int64_t( 0, 0 );
+    int64_t sum = 0;
+    double start = now();
+    for ( size_t at = 0; at + slice <= size; at += slice )
+    {
+        if ( view ) sum += vec_view_sum_int64_t( vec_view_range_int64_t( source, at, slice ) );
+        else
+        {
+            copy = vec_append_arr_int64_t( vec_clear_int64_t( copy ), source + at, slice );
+            sum += vec_sum_int64_t( copy );
+        }
+    }
+    double seconds = now() - start;
+    vec_destroy_int64_t( copy );
+    *total = sum;
+    return seconds;
+}
+
+// sort every slice of length slice in place, through a copy that is written back or through a view
+static double sort_slices( int64_t* source, size_t slice, bool view )
+{
+    size_t size = vec_size_int64_t( source );
+    int64_t* copy = vec_new_int64_t( 0, 0 );
+    double start = now();
+    for ( size_t at = 0; at + slice <= size; at += slice )
+    {
+        if ( view ) vec_view_sort_int64_t( vec_view_range_int64_t( source, at, slice ) );
+        else
+        {
+            copy = vec_append_arr_int64_t( vec_clear_int64_t( copy ), source + at, slice );
+            vec_sort_int64_t( copy );
+            memcpy( source + at, copy, slice * sizeof ( int64_t ) );
+        }
+    }
+    double seconds = now() - start;
+    vec_destroy_int64_t( copy );
+    return seconds;
+}
+
+static bool slices_sorted( int64_t* values, size_t slice )
+{
+    size_t size = vec_size_int64_t( values );
+    for ( size_t at = 0; at + slice <= size; at += slice )
+    {
+        for ( size_t i = at + 1; i < at + slice; i++ )
+        {
+            if ( values[ i - 1 ] > values[i] ) return false;
+        }
+    }
+    return true;
+}
+
+static void shuffle( int64_t* values )
+{
+    size_t size = vec_size_int64_t( values );
+    for ( size_t i = 0; i < size; i++ ) values[i] = (int64_t) ( next_random() % 1000000 );
+}
+
+
+int main( int argc, char** argv )
+{
+    size_t size = argc > 1 ? strtoull( argv[1], NULL, 10 ) : 10000000;
+    int64_t* source = vec_new_int64_t( size, 0 );
+    shuffle( source );
+    printf( "%zu elements\n", size );
+    printf( "%10s %16s %16s %16s %16s\n", "slice", "copy+sum ms", "view sum ms", "copy+sort ms", "view sort ms" );
+
+    for ( size_t slice = 16; slice <= size && slice <= 1048576; slice *= 16 )
+    {
+        int64_t copied, viewed;
+        double copy_sum = sum_slices( source, slice, false, &copied );
+        double view_sum = sum_slices( source, slice, true, &viewed );
+        if ( copied != viewed ) printf( "MISMATCH in sum\n" );
+        double copy_sort = sort_slices( source, slice, false );
+        shuffle( source );
+        double view_sort = sort_slices( source, slice, true );
+        if ( !slices_sorted( source, slice ) ) printf( "MISMATCH in sort\n" );
+        shuffle( source );
+        printf( "%10zu %16.2f %16.2f %16.2f %16.2f\n", slice, copy_sum * 1e3, view_sum * 1e3, copy_sort * 1e3,
+                view_sort * 1e3 );
+    }
+    vec_destroy_int64_t( source );
+    return 0;
+}
@@ -0,0 +1,98 @@
+// stress checks of vec_concurrent.h, run by make test
+// many short bursts of a few pushes per thread, where producers most often finish out of order, every burst
+// has to end with all of its pushes committed, then a long run where every value has to land exactly once
+// build: cc -O2 -I.. test_concurrent.c -o test_concurrent -pthread
+// usage: ./test_concurrent [threads, default 8] [bursts, default 10000], exits 1 if a check failed
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+#include "vec_concurrent.h"
+
+
+using_vector( int64_t )
+using_concurrent_vector( int64_t )
+
+
+static int failures;
+
+#define CHECK( cond )                                                                                       \
+    do                                                                                                      \
+    {                                                                                                       \
+        if ( !( cond ) )                                                                                    \
+        {                                                                                                   \
+            fprintf( stderr, "%s:%d: CHECK( %s ) failed\n", __FILE__, __LINE__, #cond );                    \
+            failures++;                                                                                     \
+        }                                                                                                   \
+    } while ( 0 )
+
+static vec_concurrent_int64_t shared;
+static size_t per_thread;
+static _Atomic size_t misplaced;
+
+// push per_thread values of its own, each has to be found at the index push_back returned
+static void* producer( void* arg )
+{
+    int64_t base = (int64_t) (intptr_t) arg * (int64_t) per_thread;
+    for ( size_t i = 0; i < per_thread; i++ )
+    {
+        size_t index = vec_concurrent_push_back_int64_t( &shared, base + (int64_t) i );
+        if ( *vec_concurrent_at_int64_t( &shared, index ) != base + (int64_t) i ) misplaced++;
+    }
+    return NULL;
+}
+
+static void run( size_t threads )
+{
+    pthread_t tid[ 256 ];
+    for ( size_t t = 0; t < threads; t++ ) pthread_create( &tid[t], NULL, producer, (void*) (intptr_t) t );
+    for ( size_t t = 0; t < threads; t++ ) pthread_join( tid[t], NULL );
+}
+
+// every value 0 .. count - 1 is in the committed prefix exactly once
+static bool all_once( size_t count )
+{
+    int64_t* out = vec_concurrent_snapshot_int64_t( &shared, vec_new_int64_t( 0, 0 ) );
+    unsigned char* seen = calloc( count, 1 );
+    bool ok = seen != NULL && vec_size_int64_t( out ) == count;
+    for ( size_t i = 0; ok && i < count; i++ )
+    {
+        ok = out[i] >= 0 && (size_t) out[i] < count && !seen[ out[i] ];
+        if ( ok ) seen[ out[i] ] = 1;
+    }
+    free( seen );
+    vec_destroy_int64_t( out );
+    return ok;
+}
+
+
+int main( int argc, char** argv )
+{
+    size_t threads = argc > 1 ? strtoull( argv[1], NULL, 10 ) : 8;
+    size_t bursts = argc > 2 ? strtoull( argv[2], NULL, 10 ) : 10000;
+    if ( threads == 0 || threads > 256 ) threads = 8;
+
+    per_thread = 3;
+    size_t lost = 0;
+    for ( size_t b = 0; b < bursts; b++ )
+    {
+        vec_concurrent_init_int64_t( &shared );
+        run( threads );
+        lost += !all_once( threads * per_thread );
+        vec_concurrent_destroy_int64_t( &shared );
+    }
+    CHECK( lost == 0 );
+
+    per_thread = 100000;
+    vec_concurrent_init_int64_t( &shared );
+    run( threads );
+    CHECK( vec_concurrent_size_int64_t( &shared ) == threads * per_thread );
+    CHECK( all_once( threads * per_thread ) );
+    vec_concurrent_destroy_int64_t( &shared );
+    CHECK( misplaced == 0 );
+
+    printf( "%zu bursts of %zu x 3 pushes, %zu lost a push, %d checks failed\n", bursts, threads, lost, failures );
+    return failures > 0;
+}
@@ -0,0 +1,237 @@
+// correctness checks of the core vector, the vec_try_* API, bulk operations, views and sorting, run by make test
+// build: cc -O2 -I.. test_vector.c -o test_vector, add -DVECTOR_COW for the copy-on-write checks
+// usage: ./test_vector, prints every failed check and exits 1 if there was one
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+#include "vec_simd.h"
+#include "vec_sort.h"
+
+
+using_vector( int )
+using_vector_numeric( int )
+using_vector_sort( int, VEC_LESS )
+using_vector_radix( int, VEC_KEY_I32 )
+
+
+static int failures;
+static int checks;
+
+#define CHECK( cond )                                                                                       \
+    do                                                                                                      \
+    {                                                                                                       \
+        checks++;                                                                                           \
+        if ( !( cond ) )                                                                                    \
+        {                                                                                                   \
+            fprintf( stderr, "%s:%d: CHECK( %s ) failed\n", __FILE__, __LINE__, #cond );                    \
+            failures++;                                                                                     \
+        }                                                                                                   \
+    } while ( 0 )
+
+static bool is_sorted( const int* arr, size_t size )
+{
+    for ( size_t i = 1; i < size; i++ )
+    {
+        if ( arr[i] < arr[ i - 1 ] ) return false;
+    }
+    return true;
+}
+
+static unsigned rng_state = 12345;
+static int rng( void )
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (int) ( rng_state % 1000 );
+}
+
+
+// pushes keep every element, the capacity grows geometrically and pops give it back
+static void test_growth( void )
+{
+    int* v = vec_new_int( 0, 0 );
+    size_t grows = 0;
+    for ( int i = 0; i < 1000000; i++ )
+    {
+        size_t capacity = vec_capacity_int( v );
+        v = vec_push_back_int( v, i );
+        grows += vec_capacity_int( v ) != capacity;
+    }
+    CHECK( vec_size_int( v ) == 1000000 );
+    CHECK( vec_capacity_int( v ) >= vec_size_int( v ) );
+    CHECK( grows < 64 );
+    bool kept = true;
+    for ( int i = 0; i < 1000000; i++ ) kept &= v[i] == i;
+    CHECK( kept );
+    CHECK( *vec_back_int( v ) == 999999 );
+
+    while ( vec_size_int( v ) > 10 ) v = vec_pop_back_int( v );
+    CHECK( vec_size_int( v ) == 10 && v[9] == 9 );
+    CHECK( vec_capacity_int( v ) < 1000000 );
+
+    size_t capacity = vec_capacity_int( v );
+    v = vec_clear_int( v );
+    CHECK( vec_size_int( v ) == 0 && vec_capacity_int( v ) == capacity );
+    v = vec_reserve_int( v, 5000 );
+    CHECK( vec_capacity_int( v ) >= 5000 && vec_size_int( v ) == 0 );
+    v = vec_resize_int( v, 100, 7 );
+    CHECK( vec_size_int( v ) == 100 && v[0] == 7 && v[99] == 7 );
+    v = vec_shrink_to_fit_int( v );
+    CHECK( vec_capacity_int( v ) >= 100 && vec_capacity_int( v ) < 5000 );
+    v = vec_assign_int( v, 3, 4 );
+    CHECK( vec_size_int( v ) == 3 && v[2] == 4 );
+    v = vec_release_int( v );
+    CHECK( vec_size_int( v ) == 0 );
+    vec_destroy_int( v );
+}
+
+// the vec_try_* forms report errors and leave the vector untouched
+static void test_try( void )
+{
+    int* v;
+    CHECK( vec_try_new_int( &v, 4, 1 ) == VEC_OK );
+    CHECK( vec_try_push_back_int( &v, 2 ) == VEC_OK && vec_size_int( v ) == 5 && v[4] == 2 );
+    CHECK( vec_try_insert_int( &v, 6, 0 ) == VEC_ERR_RANGE );
+    CHECK( vec_try_erase_range_int( &v, 3, 3 ) == VEC_ERR_RANGE );
+    CHECK( vec_try_swap_remove_int( &v, 5 ) == VEC_ERR_RANGE );
+    CHECK( vec_size_int( v ) == 5 );
+    CHECK( vec_try_reserve_int( &v, SIZE_MAX / 2 ) == VEC_ERR_NOMEM );
+    CHECK( vec_size_int( v ) == 5 && v[4] == 2 );
+    while ( vec_size_int( v ) > 0 ) CHECK( vec_try_pop_back_int( &v ) == VEC_OK );
+    CHECK( vec_try_pop_back_int( &v ) == VEC_ERR_EMPTY );
+    vec_destroy_int( v );
+}
+
+// append, insert, erase, swap-remove and truncate in the middle and at both ends
+static void test_bulk( void )
+{
+    int arr[] = { 10, 11, 12, 13 };
+    int* v = vec_new_int( 0, 0 );
+    v = vec_append_arr_int( v, arr, 4 );
+    v = vec_insert_arr_int( v, 2, arr, 2 );
+    v = vec_insert_int( v, 0, 9 );
+    CHECK( vec_size_int( v ) == 7 );
+    CHECK( v[0] == 9 && v[1] == 10 && v[2] == 11 && v[3] == 10 && v[4] == 11 && v[5] == 12 && v[6] == 13 );
+    v = vec_erase_range_int( v, 1, 2 );
+    CHECK( vec_size_int( v ) == 5 && v[0] == 9 && v[1] == 10 && v[4] == 13 );
+    v = vec_swap_remove_int( v, 0 );
+    CHECK( vec_size_int( v ) == 4 && v[0] == 13 && v[1] == 10 );
+    v = vec_append_vec_int( v, v );
+    CHECK( vec_size_int( v ) == 8 && v[4] == 13 && v[7] == v[3] );
+    v = vec_truncate_int( v, 2 );
+    CHECK( vec_size_int( v ) == 2 && v[1] == 10 );
+    v = vec_erase_range_int( v, 0, 2 );
+    CHECK( vec_size_int( v ) == 0 );
+    vec_destroy_int( v );
+}
+
+// views read and write the elements of the vector they cover, without copying them
+static void test_views( void )
+{
+    int* v = vec_new_int( 100, 1 );
+    vec_view_int all = vec_view_of_int( v );
+    CHECK( vec_view_size_int( all ) == 100 && vec_view_sum_int( all ) == 100 );
+    vec_view_int page = vec_view_range_int( v, 10, 20 );
+    vec_view_fill_int( page, 3 );
+    CHECK( v[9] == 1 && v[10] == 3 && v[29] == 3 && v[30] == 1 );
+    CHECK( vec_view_sum_int( all ) == 80 + 60 );
+    vec_view_int head = vec_view_sub_int( page, 0, 5 );
+    vec_view_scale_int( head, 2 );
+    CHECK( v[14] == 6 && v[15] == 3 );
+    CHECK( *vec_view_front_int( head ) == 6 && *vec_view_back_int( page ) == 3 );
+    CHECK( vec_view_at_int( page, 20 ) == NULL );
+    CHECK( vec_view_try_sub_int( &page, 15, 6 ) == VEC_ERR_RANGE && vec_view_size_int( page ) == 20 );
+    int min, max;
+    CHECK( vec_view_minmax_int( all, &min, &max ) && min == 1 && max == 6 );
+    vec_destroy_int( v );
+}
+
+// every sort gives the same order with the same elements, the searches and unique work on it
+static void test_sort( void )
+{
+    int* v = vec_new_int( 0, 0 );
+    for ( int i = 0; i < 100000; i++ ) v = vec_push_back_int( v, rng() - 500 );
+    int* w = vec_new_int( 0, 0 );
+    w = vec_append_vec_int( w, v );
+    int* x = vec_new_int( 0, 0 );
+    x = vec_append_vec_int( x, v );
+    long long sum = vec_sum_int( v );
+
+    v = vec_sort_int( v );
+    w = vec_stable_sort_int( w );
+    x = vec_radix_sort_int( x );
+    CHECK( is_sorted( v, vec_size_int( v ) ) && vec_sum_int( v ) == sum );
+    CHECK( is_sorted( w, vec_size_int( w ) ) && vec_sum_int( w ) == sum );
+    CHECK( is_sorted( x, vec_size_int( x ) ) && vec_sum_int( x ) == sum );
+    bool same = true;
+    for ( size_t i = 0; i < vec_size_int( v ); i++ ) same &= v[i] == w[i] && v[i] == x[i];
+    CHECK( same );
+
+    CHECK( vec_binary_search_int( v, -500 ) && !vec_binary_search_int( v, 500 ) );
+    size_t lower = vec_lower_bound_int( v, 0 ), upper = vec_upper_bound_int( v, 0 );
+    CHECK( lower < upper && v[ lower ] == 0 && v[ upper - 1 ] == 0 && ( lower == 0 || v[ lower - 1 ] < 0 ) );
+    v = vec_unique_int( v );
+    CHECK( vec_size_int( v ) == 1000 && v[0] == -500 && v[999] == 499 );
+
+    int arr[] = { 5, 1, 4, 1, 3 };
+    vec_view_int view = vec_view_arr_int( arr, 5 );
+    vec_view_sort_int( vec_view_sub_int( view, 1, 3 ) );
+    CHECK( arr[0] == 5 && arr[1] == 1 && arr[2] == 1 && arr[3] == 4 && arr[4] == 3 );
+    CHECK( vec_view_size_int( vec_view_unique_int( vec_view_sub_int( view, 1, 2 ) ) ) == 1 );
+    vec_destroy_int( v );
+    vec_destroy_int( w );
+    vec_destroy_int( x );
+}
+
+#ifdef VECTOR_COW
+// a shared block stays as it is for every owner, whichever owner writes gets its own copy first
+static void test_cow( void )
+{
+    int* a = vec_new_int( 0, 0 );
+    for ( int i = 0; i < 1000; i++ ) a = vec_push_back_int( a, 999 - i );
+    int* b = vec_share_int( a );
+    CHECK( a == b && vec_is_shared_int( a ) && vec_is_shared_int( b ) );
+
+    b = vec_push_back_int( b, -1 );
+    CHECK( a != b && !vec_is_shared_int( a ) && !vec_is_shared_int( b ) );
+    CHECK( vec_size_int( a ) == 1000 && vec_size_int( b ) == 1001 && b[0] == 999 && b[1000] == -1 );
+    vec_destroy_int( b );
+
+    b = vec_share_int( a );
+    CHECK( vec_try_stable_sort_int( b ) == VEC_ERR_SHARED && vec_try_radix_sort_int( b ) == VEC_ERR_SHARED );
+    b = vec_sort_int( b );
+    CHECK( a != b && a[0] == 999 && b[0] == 0 && is_sorted( b, vec_size_int( b ) ) );
+    vec_destroy_int( b );
+
+    b = vec_share_int( a );
+    b = vec_fill_int( b, 5 );
+    CHECK( a != b && a[0] == 999 && b[0] == 5 );
+    vec_destroy_int( b );
+
+    b = vec_share_int( a );
+    vec_destroy_int( a );
+    CHECK( !vec_is_shared_int( b ) && b[0] == 999 );
+    b = vec_unshare_int( b );
+    b[0] = 0;
+    CHECK( b[0] == 0 );
+    vec_destroy_int( b );
+}
+#endif
+
+
+int main( void )
+{
+    test_growth();
+    test_try();
+    test_bulk();
+    test_views();
+    test_sort();
+#ifdef VECTOR_COW
+    test_cow();
+#endif
+    printf( "%d of %d checks failed\n", failures, checks );
+    return failures > 0;
+}
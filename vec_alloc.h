@@ -0,0 +1,360 @@
+#ifndef __VEC_ALLOC_H__
+#define __VEC_ALLOC_H__
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "vector.h"
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+
+// allocator backends for `vec_new_with_alloc_##T`
+// neither of them is thread safe, use one per thread or per request
+
+
+// round p up to a multiple of align, align must be a power of two
+static inline char* vec_align_ptr_( char* p, size_t align )
+{
+    return (char*) ( ( (uintptr_t) p + align - 1 ) & ~(uintptr_t) ( align - 1 ) );
+}
+
+
+// bump-pointer arena
+// every vector allocated from it is released at once by vec_arena_reset or vec_arena_destroy,
+// vec_destroy only gives memory back when the vector was the last allocation of the arena
+#ifndef VEC_ARENA_BLOCK_SIZE
+#define VEC_ARENA_BLOCK_SIZE ( (size_t) 64 << 10 )
+#endif
+
+typedef struct vec_arena_block
+{
+    struct vec_arena_block* next;   // older block
+    size_t size;                    // usable bytes after the header
+} vec_arena_block;
+
+typedef struct vec_arena
+{
+    vec_allocator allocator;        // pass &arena->allocator to vec_new_with_alloc
+    vec_arena_block* blocks;        // newest block first
+    char* ptr;                      // next free byte of the newest block
+    char* end;                      // end of the newest block
+    char* last;                     // the last allocation, the only one that can grow or shrink in place
+    size_t block_size;              // minimum size of a new block
+} vec_arena;
+
+static inline void* vec_arena_allocate_( void* ctx, size_t size, size_t align )
+{
+    vec_arena* arena = ctx;
+    char* p = arena->blocks ? vec_align_ptr_( arena->ptr, align ) : NULL;
+    if ( p == NULL || size > (size_t) ( arena->end - p ) )
+    {
+        size_t bytes = arena->block_size;
+        if ( bytes < size + align ) bytes = size + align;
+        vec_arena_block* block = malloc( sizeof ( vec_arena_block ) + bytes );
+        if ( block == NULL ) return NULL;
+        block->next = arena->blocks;
+        block->size = bytes;
+        arena->blocks = block;
+        arena->end = (char*) ( block + 1 ) + bytes;
+        p = vec_align_ptr_( (char*) ( block + 1 ), align );
+    }
+    arena->last = p;
+    arena->ptr = p + size;
+    return p;
+}
+
+static inline void* vec_arena_reallocate_( void* ctx, void* ptr, size_t old_size, size_t new_size, size_t align )
+{
+    vec_arena* arena = ctx;
+    if ( ptr == arena->last && new_size <= (size_t) ( arena->end - (char*) ptr ) )
+    {
+        arena->ptr = (char*) ptr + new_size;
+        return ptr;
+    }
+    if ( new_size <= old_size ) return ptr;
+    void* p = vec_arena_allocate_( ctx, new_size, align );
+    if ( p == NULL ) return NULL;
+    memcpy( p, ptr, old_size );
+    return p;
+}
+
+static inline void vec_arena_deallocate_( void* ctx, void* ptr, size_t size, size_t align )
+{
+    vec_arena* arena = ctx;
+    (void) size;
+    (void) align;
+    if ( ptr == arena->last )
+    {
+        arena->ptr = ptr;
+        arena->last = NULL;
+    }
+}
+
+// block_size is the minimum size of each chunk the arena takes from malloc, 0 for VEC_ARENA_BLOCK_SIZE
+static inline void vec_arena_init( vec_arena* arena, size_t block_size )
+{
+    arena->allocator = (vec_allocator) {
+        .allocate = vec_arena_allocate_,
+        .reallocate = vec_arena_reallocate_,
+        .deallocate = vec_arena_deallocate_,
+        .ctx = arena,
+    };
+    arena->blocks = NULL;
+    arena->ptr = NULL;
+    arena->end = NULL;
+    arena->last = NULL;
+    arena->block_size = block_size ? block_size : VEC_ARENA_BLOCK_SIZE;
+}
+
+// release every vector allocated from the arena, keeps the newest block for the next round
+static inline void vec_arena_reset( vec_arena* arena )
+{
+    if ( arena->blocks == NULL ) return;
+    vec_arena_block* block = arena->blocks->next;
+    while ( block )
+    {
+        vec_arena_block* next = block->next;
+        free( block );
+        block = next;
+    }
+    arena->blocks->next = NULL;
+    arena->ptr = (char*) ( arena->blocks + 1 );
+    arena->last = NULL;
+}
+
+// release every vector allocated from the arena and the arena's own memory
+static inline void vec_arena_destroy( vec_arena* arena )
+{
+    vec_arena_reset( arena );
+    free( arena->blocks );
+    arena->blocks = NULL;
+    arena->ptr = NULL;
+    arena->end = NULL;
+}
+
+
+// size-class pool for small vectors
+// blocks of 64 to 4096 bytes are carved from slabs and recycled through one free list per size class,
+// anything bigger goes straight to malloc/realloc/free
+// blocks are 64-byte aligned, a stricter alignment gets a fresh aligned block of the full class size
+#ifndef VEC_POOL_SLAB_SIZE
+#define VEC_POOL_SLAB_SIZE ( (size_t) 64 << 10 )
+#endif
+
+#define VEC_POOL_MIN_BLOCK ( (size_t) 64 )
+#define VEC_POOL_CLASSES 7                      // 64, 128, ... 4096 bytes
+
+typedef struct vec_pool_slab
+{
+    struct vec_pool_slab* next;
+} vec_pool_slab;
+
+typedef struct vec_pool
+{
+    vec_allocator allocator;                    // pass &pool->allocator to vec_new_with_alloc
+    void* free_lists[ VEC_POOL_CLASSES ];       // each free block holds the pointer to the next one
+    vec_pool_slab* slabs;
+} vec_pool;
+
+// size class of a block, VEC_POOL_CLASSES when it is too big for the pool
+static inline size_t vec_pool_class_( size_t size )
+{
+    size_t cls = 0;
+    size_t block = VEC_POOL_MIN_BLOCK;
+    while ( block < size && cls < VEC_POOL_CLASSES )
+    {
+        block *= 2;
+        cls++;
+    }
+    return cls;
+}
+
+static inline void* vec_pool_allocate_( void* ctx, size_t size, size_t align )
+{
+    vec_pool* pool = ctx;
+    size_t cls = vec_pool_class_( size );
+    if ( cls == VEC_POOL_CLASSES ) return vec_default_alloc( size, align );
+    if ( VEC_UNLIKELY( align > VEC_POOL_MIN_BLOCK ) ) return vec_default_alloc( VEC_POOL_MIN_BLOCK << cls, align );
+    void* p = pool->free_lists[ cls ];
+    if ( VEC_UNLIKELY( p == NULL ) )
+    {
+        // carve a new slab into blocks of this class, the first VEC_POOL_MIN_BLOCK bytes hold the slab link
+        size_t block = VEC_POOL_MIN_BLOCK << cls;
+        vec_pool_slab* slab = vec_default_alloc( VEC_POOL_SLAB_SIZE, VEC_POOL_MIN_BLOCK );
+        if ( slab == NULL ) return NULL;
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+        char* first = (char*) slab + VEC_POOL_MIN_BLOCK;
+        char* end = (char*) slab + VEC_POOL_SLAB_SIZE;
+        for ( char* b = first; b + block <= end; b += block )
+        {
+            *(void**) b = ( b + 2 * block <= end ) ? b + block : NULL;
+        }
+        p = first;
+    }
+    pool->free_lists[ cls ] = *(void**) p;
+    return p;
+}
+
+static inline void vec_pool_deallocate_( void* ctx, void* ptr, size_t size, size_t align )
+{
+    vec_pool* pool = ctx;
+    size_t cls = vec_pool_class_( size );
+    if ( cls == VEC_POOL_CLASSES || align > VEC_POOL_MIN_BLOCK )
+    {
+        free( ptr );
+        return;
+    }
+    *(void**) ptr = pool->free_lists[ cls ];
+    pool->free_lists[ cls ] = ptr;
+}
+
+static inline void* vec_pool_reallocate_( void* ctx, void* ptr, size_t old_size, size_t new_size, size_t align )
+{
+    size_t old_cls = vec_pool_class_( old_size );
+    size_t new_cls = vec_pool_class_( new_size );
+    if ( old_cls == new_cls )
+    {
+        if ( old_cls == VEC_POOL_CLASSES ) return vec_default_realloc( ptr, old_size, new_size, align );
+        return ptr;
+    }
+    void* p = vec_pool_allocate_( ctx, new_size, align );
+    if ( p == NULL ) return NULL;
+    memcpy( p, ptr, old_size < new_size ? old_size : new_size );
+    vec_pool_deallocate_( ctx, ptr, old_size, align );
+    return p;
+}
+
+static inline void vec_pool_init( vec_pool* pool )
+{
+    pool->allocator = (vec_allocator) {
+        .allocate = vec_pool_allocate_,
+        .reallocate = vec_pool_reallocate_,
+        .deallocate = vec_pool_deallocate_,
+        .ctx = pool,
+    };
+    for ( size_t i = 0; i < VEC_POOL_CLASSES; i++ )
+    {
+        pool->free_lists[i] = NULL;
+    }
+    pool->slabs = NULL;
+}
+
+// release every slab, vectors that outgrew the pool still have to be destroyed on their own
+static inline void vec_pool_destroy( vec_pool* pool )
+{
+    vec_pool_slab* slab = pool->slabs;
+    while ( slab )
+    {
+        vec_pool_slab* next = slab->next;
+        free( slab );
+        slab = next;
+    }
+    vec_pool_init( pool );
+}
+
+
+// large-vector allocator
+// blocks of at least threshold bytes are anonymous mappings that grow with mremap( MREMAP_MAYMOVE ), so the
+// kernel moves page tables instead of copying bytes, smaller ones go to malloc/realloc/free
+// with huge_pages the mappings are madvise'd for transparent huge pages, fewer TLB misses on long scans
+// needs mmap with MAP_ANONYMOUS, define _GNU_SOURCE before any include, it is thread safe
+#if defined( MAP_ANONYMOUS )
+#define VEC_HAS_LARGE 1
+
+#ifndef VEC_LARGE_THRESHOLD
+#define VEC_LARGE_THRESHOLD ( (size_t) 4 << 20 )
+#endif
+
+typedef struct vec_large
+{
+    vec_allocator allocator;                    // pass &large->allocator to vec_new_with_alloc
+    size_t threshold;                           // smallest block that is mapped
+    size_t page;                                // mappings are a multiple of this
+    bool huge_pages;                            // madvise( MADV_HUGEPAGE ) every mapping
+} vec_large;
+
+static inline size_t vec_large_round_( vec_large* large, size_t size )
+{
+    return ( size + large->page - 1 ) / large->page * large->page;
+}
+
+static inline void vec_large_advise_( vec_large* large, void* p, size_t length )
+{
+#if defined( MADV_HUGEPAGE )
+    if ( large->huge_pages ) madvise( p, length, MADV_HUGEPAGE );
+#else
+    (void) large;
+    (void) p;
+    (void) length;
+#endif
+}
+
+static inline void* vec_large_allocate_( void* ctx, size_t size, size_t align )
+{
+    vec_large* large = ctx;
+    if ( size < large->threshold || align > large->page ) return vec_default_alloc( size, align );
+    size_t length = vec_large_round_( large, size );
+    void* p = mmap( NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if ( p == MAP_FAILED ) return NULL;
+    vec_large_advise_( large, p, length );
+    return p;
+}
+
+static inline void vec_large_deallocate_( void* ctx, void* ptr, size_t size, size_t align )
+{
+    vec_large* large = ctx;
+    if ( size < large->threshold || align > large->page ) free( ptr );
+    else munmap( ptr, vec_large_round_( large, size ) );
+}
+
+static inline void* vec_large_reallocate_( void* ctx, void* ptr, size_t old_size, size_t new_size, size_t align )
+{
+    vec_large* large = ctx;
+    bool old_mapped = old_size >= large->threshold && align <= large->page;
+    bool new_mapped = new_size >= large->threshold && align <= large->page;
+    if ( !old_mapped && !new_mapped ) return vec_default_realloc( ptr, old_size, new_size, align );
+    if ( old_mapped && new_mapped )
+    {
+        size_t old_length = vec_large_round_( large, old_size );
+        size_t new_length = vec_large_round_( large, new_size );
+        if ( old_length == new_length ) return ptr;
+#if defined( __linux__ ) && defined( MREMAP_MAYMOVE )
+        void* p = mremap( ptr, old_length, new_length, MREMAP_MAYMOVE );
+        if ( p == MAP_FAILED ) return NULL;
+        if ( new_length > old_length ) vec_large_advise_( large, p, new_length );
+        return p;
+#endif
+    }
+    // crossing the threshold, or no mremap
+    void* p = vec_large_allocate_( ctx, new_size, align );
+    if ( p == NULL ) return NULL;
+    memcpy( p, ptr, old_size < new_size ? old_size : new_size );
+    vec_large_deallocate_( ctx, ptr, old_size, align );
+    return p;
+}
+
+// threshold is the smallest block in bytes that is mapped, 0 for VEC_LARGE_THRESHOLD
+static inline void vec_large_init( vec_large* large, size_t threshold, bool huge_pages )
+{
+    large->allocator = (vec_allocator) {
+        .allocate = vec_large_allocate_,
+        .reallocate = vec_large_reallocate_,
+        .deallocate = vec_large_deallocate_,
+        .ctx = large,
+    };
+    long page = sysconf( _SC_PAGESIZE );
+    large->page = page > 0 ? (size_t) page : 4096;
+    large->threshold = threshold ? threshold : VEC_LARGE_THRESHOLD;
+    if ( large->threshold < large->page ) large->threshold = large->page;
+    large->huge_pages = huge_pages;
+}
+
+#endif  // MAP_ANONYMOUS
+
+
+#endif  // __VEC_ALLOC_H__
@@ -0,0 +1,571 @@
+#ifndef __VEC_BITS_H__
+#define __VEC_BITS_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "vector.h"
+#include "vec_simd.h"
+
+
+// bit vector: flags packed 64 to a word behind the same vec_meta header as a vector, 8x smaller than a vector
+// of bool or char, size and capacity count bits
+// bits past the size are always zero, so popcounts and scans work on whole words and never look at the size
+// the bitwise kernels are plain word loops, cloned for AVX-512 / AVX2 like vec_simd.h, popcount uses a nibble
+// lookup with AVX-512BW or AVX2 when the CPU has it and the popcnt instruction otherwise
+// `vec_bits_*` are not generated per type, include this header with VECTOR_IMPLEMENTATION in one translation unit
+// ( more are fine, the definitions are weak )
+#define VEC_BITS_WORD 64
+
+#if ( defined( __GNUC__ ) || defined( __clang__ ) ) && defined( __x86_64__ ) && !defined( VEC_NO_SIMD_DISPATCH )
+#define VEC_BITS_X86_
+#include <immintrin.h>
+#endif
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define VEC_BITS_CTZ( x ) ( (size_t) __builtin_ctzll( x ) )
+#define VEC_BITS_POPCOUNT( x ) ( (size_t) __builtin_popcountll( x ) )
+#else
+#define VEC_BITS_CTZ( x ) vec_bits_ctz_( x )
+#define VEC_BITS_POPCOUNT( x ) vec_bits_popcount_( x )
+static inline size_t vec_bits_ctz_( uint64_t x )
+{
+    size_t r = 0;
+    while ( !( x & 1 ) ) { x >>= 1; r++; }
+    return r;
+}
+static inline size_t vec_bits_popcount_( uint64_t x )
+{
+    x = x - ( ( x >> 1 ) & UINT64_C( 0x5555555555555555 ) );
+    x = ( x & UINT64_C( 0x3333333333333333 ) ) + ( ( x >> 2 ) & UINT64_C( 0x3333333333333333 ) );
+    x = ( x + ( x >> 4 ) ) & UINT64_C( 0x0F0F0F0F0F0F0F0F );
+    return (size_t) ( ( x * UINT64_C( 0x0101010101010101 ) ) >> 56 );
+}
+#endif
+
+typedef struct vec_bits
+{
+    vec_meta meta;                  // size and capacity in bits, the capacity is a multiple of VEC_BITS_WORD
+    uint64_t words[];               // bit i is bit i % 64 of words[ i / 64 ]
+} vec_bits;
+
+// number of words holding size bits
+static inline size_t vec_bits_words_for_( size_t size )
+{
+    return size / VEC_BITS_WORD + ( size % VEC_BITS_WORD != 0 );
+}
+
+// slow path of push, defined with the rest of the bit vector
+vec_bits* vec_bits_grow_( vec_bits* self, size_t size );
+
+// Returns the number of bits in the vector
+static inline size_t vec_bits_size( vec_bits* self )
+{
+    return self->meta.size;
+}
+
+// get the allocated size for the vector in bits
+static inline size_t vec_bits_capacity( vec_bits* self )
+{
+    return self->meta.capacity;
+}
+
+// get the words of the vector, vec_bits_words_for_( size ) of them are in use
+static inline uint64_t* vec_bits_data( vec_bits* self )
+{
+    return self->words;
+}
+
+// Returns bit position, position must be below the size
+static inline bool vec_bits_test( vec_bits* self, size_t position )
+{
+    return ( self->words[ position / VEC_BITS_WORD ] >> ( position % VEC_BITS_WORD ) ) & 1;
+}
+
+// set bit position to val, position must be below the size
+static inline void vec_bits_set( vec_bits* self, size_t position, bool val )
+{
+    uint64_t bit = (uint64_t) 1 << ( position % VEC_BITS_WORD );
+    if ( val ) self->words[ position / VEC_BITS_WORD ] |= bit;
+    else self->words[ position / VEC_BITS_WORD ] &= ~bit;
+}
+
+// Adds a new bit after the last one
+static inline vec_bits* vec_bits_push( vec_bits* self, bool val )
+{
+    if ( VEC_UNLIKELY( self->meta.size == self->meta.capacity ) )
+    {
+        self = vec_bits_grow_( self, self->meta.size + 1 );
+    }
+    /* the bit past the size is zero already */
+    size_t position = self->meta.size++;
+    self->words[ position / VEC_BITS_WORD ] |= (uint64_t) val << ( position % VEC_BITS_WORD );
+    return self;
+}
+
+vec_bits* vec_bits_new( size_t size, bool val );
+vec_bits* vec_bits_new_with_alloc( size_t size, bool val, const vec_allocator* alloc );
+vec_bits* vec_bits_resize( vec_bits* self, size_t size, bool val );
+vec_bits* vec_bits_assign( vec_bits* self, size_t size, bool val );
+vec_bits* vec_bits_reserve( vec_bits* self, size_t size );
+vec_bits* vec_bits_shrink_to_fit( vec_bits* self );
+void vec_bits_clear( vec_bits* self );
+void vec_bits_destroy( vec_bits* self );
+int vec_bits_try_new( vec_bits** self, size_t size, bool val );
+int vec_bits_try_new_with_alloc( vec_bits** self, size_t size, bool val, const vec_allocator* alloc );
+int vec_bits_try_push( vec_bits** self, bool val );
+int vec_bits_try_resize( vec_bits** self, size_t size, bool val );
+int vec_bits_try_assign( vec_bits** self, size_t size, bool val );
+int vec_bits_try_reserve( vec_bits** self, size_t size );
+
+// word kernels, they work on any array of words
+void vec_bits_and_arr( uint64_t* dst, const uint64_t* src, size_t count );
+void vec_bits_or_arr( uint64_t* dst, const uint64_t* src, size_t count );
+void vec_bits_xor_arr( uint64_t* dst, const uint64_t* src, size_t count );
+void vec_bits_not_arr( uint64_t* dst, size_t count );
+size_t vec_bits_popcount_arr( const uint64_t* words, size_t count );
+
+// bitwise ops on whole vectors, self op= other over their common length, the rest of self is unchanged
+void vec_bits_and( vec_bits* self, vec_bits* other );
+void vec_bits_or( vec_bits* self, vec_bits* other );
+void vec_bits_xor( vec_bits* self, vec_bits* other );
+void vec_bits_not( vec_bits* self );
+
+// scans, a position that is not found comes back as the size
+size_t vec_bits_count( vec_bits* self );
+size_t vec_bits_rank( vec_bits* self, size_t position );
+size_t vec_bits_select( vec_bits* self, size_t rank );
+size_t vec_bits_find_next( vec_bits* self, size_t position );
+size_t vec_bits_collect( vec_bits* self, size_t position, size_t* out, size_t max );
+
+#endif  // __VEC_BITS_H__
+
+
+#if defined( VECTOR_IMPLEMENTATION ) && !defined( __VEC_BITS_IMPL__ )
+#define __VEC_BITS_IMPL__
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define VEC_BITS_WEAK __attribute__(( weak ))
+#else
+#define VEC_BITS_WEAK
+#endif
+
+#if defined( VEC_BITS_X86_ ) && defined( __ELF__ )
+#define VEC_BITS_POPCNT_CLONES __attribute__(( target_clones( "popcnt", "default" ) ))
+#else
+#define VEC_BITS_POPCNT_CLONES
+#endif
+
+// bytes of a block holding capacity bits, capacity is a multiple of VEC_BITS_WORD
+static inline size_t vec_bits_bytes_( size_t capacity )
+{
+    return sizeof ( vec_bits ) + capacity / VEC_BITS_WORD * sizeof ( uint64_t );
+}
+
+// zero the bits from size up to the end of its word, keeps the bits past the size zero
+static inline void vec_bits_trim_( vec_bits* self )
+{
+    size_t used = self->meta.size % VEC_BITS_WORD;
+    if ( used ) self->words[ self->meta.size / VEC_BITS_WORD ] &= ~( ~(uint64_t) 0 << used );
+}
+
+// set the bits in [ from, to ) to val, they are zero on entry
+static void vec_bits_fill_( vec_bits* self, size_t from, size_t to, bool val )
+{
+    if ( !val || from >= to ) return;
+    size_t first = from / VEC_BITS_WORD, last = ( to - 1 ) / VEC_BITS_WORD;
+    uint64_t head = ~(uint64_t) 0 << ( from % VEC_BITS_WORD );
+    uint64_t tail = ~(uint64_t) 0 >> ( VEC_BITS_WORD - 1 - ( to - 1 ) % VEC_BITS_WORD );
+    if ( first == last )
+    {
+        self->words[ first ] |= head & tail;
+        return;
+    }
+    self->words[ first ] |= head;
+    memset( &self->words[ first + 1 ], 0xFF, ( last - first - 1 ) * sizeof ( uint64_t ) );
+    self->words[ last ] |= tail;
+}
+
+// reallocate to capacity bits, the new words are zeroed, NULL and untouched on failure
+static vec_bits* vec_bits_realloc_( vec_bits* self, size_t capacity )
+{
+    size_t old = self->meta.capacity;
+    vec_bits* moved = vec_mem_realloc( self->meta.alloc, self, vec_bits_bytes_( old ), vec_bits_bytes_( capacity ),
+                                       VEC_HEADER_ALIGN );
+    if ( VEC_UNLIKELY( moved == NULL ) ) return NULL;
+    if ( capacity > old )
+    {
+        size_t added = ( capacity - old ) / VEC_BITS_WORD;
+        memset( &moved->words[ old / VEC_BITS_WORD ], 0, added * sizeof ( uint64_t ) );
+    }
+    moved->meta.capacity = capacity;
+    return moved;
+}
+
+// grow *self to hold at least size bits, *self is untouched on failure
+static int vec_bits_try_grow_( vec_bits** self, size_t size )
+{
+    size_t capacity = ( *self )->meta.capacity;
+    if ( size <= capacity ) return VEC_OK;
+    size_t words = vec_grow_capacity( capacity / VEC_BITS_WORD, vec_bits_words_for_( size ), sizeof ( uint64_t ),
+                                      VEC_GROWTH_DEFAULT );
+    if ( VEC_UNLIKELY( words > ( SIZE_MAX - sizeof ( vec_bits ) ) / sizeof ( uint64_t ) ) ) return VEC_ERR_NOMEM;
+    vec_bits* grown = vec_bits_realloc_( *self, words * VEC_BITS_WORD );
+    if ( VEC_UNLIKELY( grown == NULL ) ) return VEC_ERR_NOMEM;
+    *self = grown;
+    return VEC_OK;
+}
+
+// slow path of push, only taken when the vector is full
+VEC_BITS_WEAK VEC_COLD vec_bits* vec_bits_grow_( vec_bits* self, size_t size )
+{
+    int err = vec_bits_try_grow_( &self, size );
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );
+    return self;
+}
+
+// create a vector of size bits set to val, its memory comes from alloc ( NULL for malloc )
+VEC_BITS_WEAK int vec_bits_try_new_with_alloc( vec_bits** self, size_t size, bool val, const vec_allocator* alloc )
+{
+    size_t words = vec_bits_words_for_( size );
+    if ( words < VEC_MIN_CAPACITY ) words = VEC_MIN_CAPACITY;
+    if ( VEC_UNLIKELY( words > ( SIZE_MAX - sizeof ( vec_bits ) ) / sizeof ( uint64_t ) ) ) return VEC_ERR_NOMEM;
+    size_t capacity = words * VEC_BITS_WORD;
+    vec_bits* bits = vec_mem_alloc( alloc, vec_bits_bytes_( capacity ), VEC_HEADER_ALIGN );
+    if ( VEC_UNLIKELY( bits == NULL ) ) return VEC_ERR_NOMEM;
+    bits->meta = (vec_meta) { .size = size, .capacity = capacity, .alloc = alloc, .flags = 0 };
+    memset( bits->words, 0, words * sizeof ( uint64_t ) );
+    vec_bits_fill_( bits, 0, size, val );
+    *self = bits;
+    return VEC_OK;
+}
+
+// create a vector of size bits set to val
+VEC_BITS_WEAK int vec_bits_try_new( vec_bits** self, size_t size, bool val )
+{
+    return vec_bits_try_new_with_alloc( self, size, val, NULL );
+}
+
+VEC_BITS_WEAK vec_bits* vec_bits_new_with_alloc( size_t size, bool val, const vec_allocator* alloc )
+{
+    vec_bits* self = NULL;
+    int err = vec_bits_try_new_with_alloc( &self, size, val, alloc );
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );
+    return self;
+}
+
+VEC_BITS_WEAK vec_bits* vec_bits_new( size_t size, bool val )
+{
+    return vec_bits_new_with_alloc( size, val, NULL );
+}
+
+// Adds a new bit after the last one, VEC_ERR_NOMEM and untouched when the vector can not grow
+VEC_BITS_WEAK int vec_bits_try_push( vec_bits** self, bool val )
+{
+    int err = vec_bits_try_grow_( self, ( *self )->meta.size + 1 );
+    if ( VEC_UNLIKELY( err ) ) return err;
+    *self = vec_bits_push( *self, val );
+    return VEC_OK;
+}
+
+// change the size, the bits added are set to val
+VEC_BITS_WEAK int vec_bits_try_resize( vec_bits** self, size_t size, bool val )
+{
+    int err = vec_bits_try_grow_( self, size );
+    if ( VEC_UNLIKELY( err ) ) return err;
+    vec_bits* bits = *self;
+    size_t old = bits->meta.size;
+    if ( size < old )
+    {
+        size_t keep = vec_bits_words_for_( size );
+        memset( &bits->words[ keep ], 0, ( vec_bits_words_for_( old ) - keep ) * sizeof ( uint64_t ) );
+    }
+    bits->meta.size = size;
+    vec_bits_trim_( bits );
+    vec_bits_fill_( bits, old, size, val );
+    return VEC_OK;
+}
+
+// replace the contents with size bits set to val
+VEC_BITS_WEAK int vec_bits_try_assign( vec_bits** self, size_t size, bool val )
+{
+    int err = vec_bits_try_grow_( self, size );
+    if ( VEC_UNLIKELY( err ) ) return err;
+    vec_bits* bits = *self;
+    size_t words = vec_bits_words_for_( size > bits->meta.size ? size : bits->meta.size );
+    memset( bits->words, 0, words * sizeof ( uint64_t ) );
+    bits->meta.size = size;
+    vec_bits_fill_( bits, 0, size, val );
+    return VEC_OK;
+}
+
+// make room for at least size bits
+VEC_BITS_WEAK int vec_bits_try_reserve( vec_bits** self, size_t size )
+{
+    return vec_bits_try_grow_( self, size );
+}
+
+VEC_BITS_WEAK vec_bits* vec_bits_resize( vec_bits* self, size_t size, bool val )
+{
+    int err = vec_bits_try_resize( &self, size, val );
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );
+    return self;
+}
+
+VEC_BITS_WEAK vec_bits* vec_bits_assign( vec_bits* self, size_t size, bool val )
+{
+    int err = vec_bits_try_assign( &self, size, val );
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );
+    return self;
+}
+
+VEC_BITS_WEAK vec_bits* vec_bits_reserve( vec_bits* self, size_t size )
+{
+    int err = vec_bits_try_reserve( &self, size );
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );
+    return self;
+}
+
+// give back the capacity that is not used, the vector is kept as it is when the allocator fails
+VEC_BITS_WEAK vec_bits* vec_bits_shrink_to_fit( vec_bits* self )
+{
+    size_t words = vec_bits_words_for_( self->meta.size );
+    if ( words < VEC_MIN_CAPACITY ) words = VEC_MIN_CAPACITY;
+    if ( words * VEC_BITS_WORD >= self->meta.capacity ) return self;
+    vec_bits* shrunk = vec_bits_realloc_( self, words * VEC_BITS_WORD );
+    return shrunk != NULL ? shrunk : self;
+}
+
+// remove every bit, the capacity is kept
+VEC_BITS_WEAK void vec_bits_clear( vec_bits* self )
+{
+    memset( self->words, 0, vec_bits_words_for_( self->meta.size ) * sizeof ( uint64_t ) );
+    self->meta.size = 0;
+}
+
+VEC_BITS_WEAK void vec_bits_destroy( vec_bits* self )
+{
+    vec_mem_free( self->meta.alloc, self, vec_bits_bytes_( self->meta.capacity ), VEC_HEADER_ALIGN );
+}
+
+// dst[i] &= src[i]
+VEC_BITS_WEAK VEC_SIMD_CLONES void vec_bits_and_arr( uint64_t* dst, const uint64_t* src, size_t count )
+{
+    for ( size_t i = 0; i < count; i++ ) dst[i] &= src[i];
+}
+
+// dst[i] |= src[i]
+VEC_BITS_WEAK VEC_SIMD_CLONES void vec_bits_or_arr( uint64_t* dst, const uint64_t* src, size_t count )
+{
+    for ( size_t i = 0; i < count; i++ ) dst[i] |= src[i];
+}
+
+// dst[i] ^= src[i]
+VEC_BITS_WEAK VEC_SIMD_CLONES void vec_bits_xor_arr( uint64_t* dst, const uint64_t* src, size_t count )
+{
+    for ( size_t i = 0; i < count; i++ ) dst[i] ^= src[i];
+}
+
+// dst[i] = ~dst[i]
+VEC_BITS_WEAK VEC_SIMD_CLONES void vec_bits_not_arr( uint64_t* dst, size_t count )
+{
+    for ( size_t i = 0; i < count; i++ ) dst[i] = ~dst[i];
+}
+
+// four independent sums keep the popcnt unit busy
+static VEC_BITS_POPCNT_CLONES size_t vec_bits_popcount_words_( const uint64_t* words, size_t count )
+{
+    size_t sum[4] = { 0 };
+    size_t i = 0;
+    for ( ; i + 4 <= count; i += 4 )
+    {
+        for ( size_t j = 0; j < 4; j++ ) sum[j] += VEC_BITS_POPCOUNT( words[ i + j ] );
+    }
+    for ( ; i < count; i++ ) sum[0] += VEC_BITS_POPCOUNT( words[i] );
+    return sum[0] + sum[1] + sum[2] + sum[3];
+}
+
+#ifdef VEC_BITS_X86_
+// popcount of every byte from two 16-entry nibble lookups, summed into 64-bit lanes with sad
+__attribute__(( target( "avx512bw" ) ))
+static size_t vec_bits_popcount_avx512_( const uint64_t* words, size_t count )
+{
+    const __m512i table = _mm512_broadcast_i32x4( _mm_setr_epi8( 0, 1, 1, 2, 1, 2, 2, 3,
+                                                                 1, 2, 2, 3, 2, 3, 3, 4 ) );
+    const __m512i low = _mm512_set1_epi8( 0x0F );
+    __m512i sum = _mm512_setzero_si512();
+    size_t i = 0;
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        __m512i v = _mm512_loadu_si512( (const void*) ( words + i ) );
+        __m512i high = _mm512_and_si512( _mm512_srli_epi16( v, 4 ), low );
+        __m512i bytes = _mm512_add_epi8( _mm512_shuffle_epi8( table, _mm512_and_si512( v, low ) ),
+                                         _mm512_shuffle_epi8( table, high ) );
+        sum = _mm512_add_epi64( sum, _mm512_sad_epu8( bytes, _mm512_setzero_si512() ) );
+    }
+    return (size_t) _mm512_reduce_add_epi64( sum ) + vec_bits_popcount_words_( words + i, count - i );
+}
+
+__attribute__(( target( "avx2" ) ))
+static size_t vec_bits_popcount_avx2_( const uint64_t* words, size_t count )
+{
+    const __m256i table = _mm256_setr_epi8( 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 );
+    const __m256i low = _mm256_set1_epi8( 0x0F );
+    __m256i sum = _mm256_setzero_si256();
+    size_t i = 0;
+    for ( ; i + 4 <= count; i += 4 )
+    {
+        __m256i v = _mm256_loadu_si256( (const __m256i*) ( words + i ) );
+        __m256i high = _mm256_and_si256( _mm256_srli_epi16( v, 4 ), low );
+        __m256i bytes = _mm256_add_epi8( _mm256_shuffle_epi8( table, _mm256_and_si256( v, low ) ),
+                                         _mm256_shuffle_epi8( table, high ) );
+        sum = _mm256_add_epi64( sum, _mm256_sad_epu8( bytes, _mm256_setzero_si256() ) );
+    }
+    size_t total = (size_t) _mm256_extract_epi64( sum, 0 ) + (size_t) _mm256_extract_epi64( sum, 1 ) +
+                   (size_t) _mm256_extract_epi64( sum, 2 ) + (size_t) _mm256_extract_epi64( sum, 3 );
+    return total + vec_bits_popcount_words_( words + i, count - i );
+}
+#endif
+
+// number of set bits in count words
+VEC_BITS_WEAK size_t vec_bits_popcount_arr( const uint64_t* words, size_t count )
+{
+#ifdef VEC_BITS_X86_
+    if ( count >= 16 && __builtin_cpu_supports( "avx512bw" ) ) return vec_bits_popcount_avx512_( words, count );
+    if ( count >= 16 && __builtin_cpu_supports( "avx2" ) ) return vec_bits_popcount_avx2_( words, count );
+#endif
+    return vec_bits_popcount_words_( words, count );
+}
+
+// self = self op other over the common length, the partial last word only takes other's bits below that length
+VEC_BITS_WEAK void vec_bits_and( vec_bits* self, vec_bits* other )
+{
+    size_t size = self->meta.size < other->meta.size ? self->meta.size : other->meta.size;
+    vec_bits_and_arr( self->words, other->words, size / VEC_BITS_WORD );
+    if ( size % VEC_BITS_WORD )
+    {
+        uint64_t mask = ~(uint64_t) 0 << ( size % VEC_BITS_WORD );
+        self->words[ size / VEC_BITS_WORD ] &= other->words[ size / VEC_BITS_WORD ] | mask;
+    }
+}
+
+VEC_BITS_WEAK void vec_bits_or( vec_bits* self, vec_bits* other )
+{
+    size_t size = self->meta.size < other->meta.size ? self->meta.size : other->meta.size;
+    vec_bits_or_arr( self->words, other->words, size / VEC_BITS_WORD );
+    if ( size % VEC_BITS_WORD )
+    {
+        uint64_t mask = ~( ~(uint64_t) 0 << ( size % VEC_BITS_WORD ) );
+        self->words[ size / VEC_BITS_WORD ] |= other->words[ size / VEC_BITS_WORD ] & mask;
+    }
+}
+
+VEC_BITS_WEAK void vec_bits_xor( vec_bits* self, vec_bits* other )
+{
+    size_t size = self->meta.size < other->meta.size ? self->meta.size : other->meta.size;
+    vec_bits_xor_arr( self->words, other->words, size / VEC_BITS_WORD );
+    if ( size % VEC_BITS_WORD )
+    {
+        uint64_t mask = ~( ~(uint64_t) 0 << ( size % VEC_BITS_WORD ) );
+        self->words[ size / VEC_BITS_WORD ] ^= other->words[ size / VEC_BITS_WORD ] & mask;
+    }
+}
+
+// flip every bit
+VEC_BITS_WEAK void vec_bits_not( vec_bits* self )
+{
+    vec_bits_not_arr( self->words, vec_bits_words_for_( self->meta.size ) );
+    vec_bits_trim_( self );
+}
+
+// number of set bits
+VEC_BITS_WEAK size_t vec_bits_count( vec_bits* self )
+{
+    return vec_bits_popcount_arr( self->words, vec_bits_words_for_( self->meta.size ) );
+}
+
+// number of set bits before position, the count of the whole vector past the size
+VEC_BITS_WEAK size_t vec_bits_rank( vec_bits* self, size_t position )
+{
+    if ( position >= self->meta.size ) return vec_bits_count( self );
+    size_t rank = vec_bits_popcount_arr( self->words, position / VEC_BITS_WORD );
+    if ( position % VEC_BITS_WORD )
+    {
+        uint64_t mask = ~( ~(uint64_t) 0 << ( position % VEC_BITS_WORD ) );
+        rank += VEC_BITS_POPCOUNT( self->words[ position / VEC_BITS_WORD ] & mask );
+    }
+    return rank;
+}
+
+// position of the set bit with rank set bits before it, the size when there are not that many
+VEC_BITS_WEAK size_t vec_bits_select( vec_bits* self, size_t rank )
+{
+    size_t words = vec_bits_words_for_( self->meta.size );
+    size_t w = 0;
+    /* skip blocks of 8 words at a time, then single words */
+    for ( ; w + 8 <= words; w += 8 )
+    {
+        size_t count = vec_bits_popcount_words_( &self->words[w], 8 );
+        if ( rank < count ) break;
+        rank -= count;
+    }
+    for ( ; w < words; w++ )
+    {
+        size_t count = VEC_BITS_POPCOUNT( self->words[w] );
+        if ( rank < count ) break;
+        rank -= count;
+    }
+    if ( w == words ) return self->meta.size;
+    uint64_t word = self->words[w];
+    for ( ; rank > 0; rank-- ) word &= word - 1;
+    return w * VEC_BITS_WORD + VEC_BITS_CTZ( word );
+}
+
+// position of the first set bit at or after position, the size when there is none
+VEC_BITS_WEAK size_t vec_bits_find_next( vec_bits* self, size_t position )
+{
+    if ( position >= self->meta.size ) return self->meta.size;
+    size_t words = vec_bits_words_for_( self->meta.size );
+    size_t w = position / VEC_BITS_WORD;
+    uint64_t word = self->words[w] & ( ~(uint64_t) 0 << ( position % VEC_BITS_WORD ) );
+    if ( word ) return w * VEC_BITS_WORD + VEC_BITS_CTZ( word );
+    /* sparse masks: or 8 words together and skip the block when it is all zero */
+    for ( w++; w + 8 <= words; w += 8 )
+    {
+        uint64_t any = 0;
+        for ( size_t j = 0; j < 8; j++ ) any |= self->words[ w + j ];
+        if ( any ) break;
+    }
+    for ( ; w < words; w++ )
+    {
+        if ( self->words[w] ) return w * VEC_BITS_WORD + VEC_BITS_CTZ( self->words[w] );
+    }
+    return self->meta.size;
+}
+
+// write the positions of up to max set bits at or after position to out, returns how many were written
+// continue from out[ n - 1 ] + 1 to iterate over all of them a batch at a time
+VEC_BITS_WEAK size_t vec_bits_collect( vec_bits* self, size_t position, size_t* out, size_t max )
+{
+    position = vec_bits_find_next( self, position );
+    if ( position >= self->meta.size || max == 0 ) return 0;
+    /* out is size_t like the header, keep everything the loop reads in locals so the stores do not reload it */
+    const uint64_t* data = self->words;
+    size_t words = vec_bits_words_for_( self->meta.size );
+    size_t w = position / VEC_BITS_WORD;
+    uint64_t word = data[w] & ( ~(uint64_t) 0 << ( position % VEC_BITS_WORD ) );
+    size_t n = 0;
+    for ( ;; )
+    {
+        while ( word )
+        {
+            out[ n++ ] = w * VEC_BITS_WORD + VEC_BITS_CTZ( word );
+            if ( n == max ) return n;
+            word &= word - 1;
+        }
+        if ( ++w == words ) return n;
+        word = data[w];
+    }
+}
+#endif  // __VEC_BITS_IMPL__
@@ -0,0 +1,172 @@
+#ifndef __VEC_CONCURRENT_H__
+#define __VEC_CONCURRENT_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "vector.h"
+
+
+// append-only vector shared between threads
+// producers reserve a slot with one atomic fetch-add and write it in place, the storage is a list of segments
+// of VEC_CONCURRENT_FIRST, 2 * VEC_CONCURRENT_FIRST, 4 * VEC_CONCURRENT_FIRST ... elements, so an element never
+// moves once written and pointers to it stay valid until the vector is destroyed
+// every slot has a ready flag, whoever completes the prefix moves the committed size forward, readers only
+// ever see that size, so everything below it is fully written
+#ifndef VEC_CONCURRENT_FIRST
+#define VEC_CONCURRENT_FIRST ( (size_t) 64 )   // elements in the first segment, a power of two
+#endif
+#define VEC_CONCURRENT_SEGMENTS ( sizeof ( size_t ) * 8 )
+
+// floor( log2( x ) ), x > 0
+static inline size_t vec_log2_( size_t x )
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+    return sizeof ( unsigned long long ) * 8 - 1 - (size_t) __builtin_clzll( (unsigned long long) x );
+#else
+    size_t r = 0;
+    while ( x >>= 1 ) r++;
+    return r;
+#endif
+}
+
+// segment holding element index and the position inside it
+static inline size_t vec_concurrent_locate_( size_t index, size_t* offset )
+{
+    size_t shifted = index + VEC_CONCURRENT_FIRST;
+    size_t segment = vec_log2_( shifted ) - vec_log2_( VEC_CONCURRENT_FIRST );
+    *offset = shifted - ( VEC_CONCURRENT_FIRST << segment );
+    return segment;
+}
+
+// the struct is the same in the declaration and the implementation
+#define vec_concurrent_struct_( T )                                                                         \
+typedef struct vec_concurrent_##T                                                                           \
+{                                                                                                           \
+    _Atomic( T* ) segments[ VEC_CONCURRENT_SEGMENTS ];     /* each segment is followed by its ready flags */ \
+    _Alignas( 64 ) atomic_size_t reserved;                 /* slots handed out to producers */              \
+    _Alignas( 64 ) atomic_size_t committed;                /* every slot below is written */                \
+} vec_concurrent_##T;                                                                                       \
+
+
+// generate the concurrent vector for T, `using_vector( T )` must come first
+#ifndef VECTOR_IMPLEMENTATION
+#define using_concurrent_vector( T )                                                                        \
+vec_concurrent_struct_( T )                                                                                 \
+void vec_concurrent_init_##T( vec_concurrent_##T* self );                                                   \
+void vec_concurrent_destroy_##T( vec_concurrent_##T* self );                                                \
+size_t vec_concurrent_push_back_##T( vec_concurrent_##T* self, T val );                                     \
+size_t vec_concurrent_size_##T( vec_concurrent_##T* self );                                                 \
+T* vec_concurrent_at_##T( vec_concurrent_##T* self, size_t index );                                         \
+T* vec_concurrent_snapshot_##T( vec_concurrent_##T* self, T* out );                                         \
+
+#endif  // VECTOR_IMPLEMENTATION
+#endif  // __VEC_CONCURRENT_H__
+
+
+#ifdef VECTOR_IMPLEMENTATION
+#define using_concurrent_vector( T )                                                                        \
+vec_concurrent_struct_( T )                                                                                 \
+/* an empty vector, no memory is allocated until the first push */                                          \
+void vec_concurrent_init_##T( vec_concurrent_##T* self )                                                    \
+{                                                                                                           \
+    for ( size_t i = 0; i < VEC_CONCURRENT_SEGMENTS; i++ ) atomic_init( &self->segments[i], NULL );         \
+    atomic_init( &self->reserved, 0 );                                                                      \
+    atomic_init( &self->committed, 0 );                                                                     \
+}                                                                                                           \
+/* free every segment, no thread may use the vector anymore */                                              \
+void vec_concurrent_destroy_##T( vec_concurrent_##T* self )                                                 \
+{                                                                                                           \
+    for ( size_t i = 0; i < VEC_CONCURRENT_SEGMENTS; i++ )                                                  \
+    {                                                                                                       \
+        free( atomic_load_explicit( &self->segments[i], memory_order_relaxed ) );                           \
+        atomic_store_explicit( &self->segments[i], NULL, memory_order_relaxed );                            \
+    }                                                                                                       \
+    atomic_store( &self->reserved, 0 );                                                                     \
+    atomic_store( &self->committed, 0 );                                                                    \
+}                                                                                                           \
+/* the ready flags behind a segment of count elements */                                                    \
+static inline atomic_uchar* vec_concurrent_flags_##T( T* segment, size_t count )                            \
+{                                                                                                           \
+    return (atomic_uchar*) ( segment + count );                                                             \
+}                                                                                                           \
+/* segment k, allocated by whichever producer gets there first */                                           \
+static T* vec_concurrent_segment_##T( vec_concurrent_##T* self, size_t k )                                  \
+{                                                                                                           \
+    T* segment = atomic_load_explicit( &self->segments[k], memory_order_acquire );                          \
+    if ( VEC_LIKELY( segment != NULL ) ) return segment;                                                    \
+    size_t count = VEC_CONCURRENT_FIRST << k;                                                               \
+    T* fresh = vec_default_alloc( count * sizeof ( T ) + count, _Alignof( T ) );                            \
+    if ( VEC_UNLIKELY( fresh == NULL ) ) vec_fail_( VEC_ERR_NOMEM );                                        \
+    atomic_uchar* flags = vec_concurrent_flags_##T( fresh, count );                                         \
+    for ( size_t i = 0; i < count; i++ ) atomic_init( &flags[i], 0 );                                       \
+    if ( atomic_compare_exchange_strong( &self->segments[k], &segment, fresh ) ) return fresh;              \
+    free( fresh );                                                                                          \
+    return segment;                                                                                         \
+}                                                                                                           \
+/* ready flag of a slot whose segment exists */                                                             \
+static inline atomic_uchar* vec_concurrent_ready_##T( vec_concurrent_##T* self, size_t index )              \
+{                                                                                                           \
+    size_t offset;                                                                                          \
+    size_t k = vec_concurrent_locate_( index, &offset );                                                    \
+    T* segment = atomic_load_explicit( &self->segments[k], memory_order_acquire );                          \
+    if ( segment == NULL ) return NULL;                                                                     \
+    return &vec_concurrent_flags_##T( segment, VEC_CONCURRENT_FIRST << k )[ offset ];                       \
+}                                                                                                           \
+/* append val from any thread, returns its index, it becomes visible once every slot before it is written */ \
+size_t vec_concurrent_push_back_##T( vec_concurrent_##T* self, T val )                                      \
+{                                                                                                           \
+    size_t index = atomic_fetch_add_explicit( &self->reserved, 1, memory_order_relaxed );                   \
+    size_t offset;                                                                                          \
+    size_t k = vec_concurrent_locate_( index, &offset );                                                    \
+    T* segment = vec_concurrent_segment_##T( self, k );                                                     \
+    segment[ offset ] = val;                                                                                \
+    /* next in line, publish directly, otherwise leave the ready flag for whoever fills the gap */          \
+    size_t committed = index;                                                                               \
+    if ( atomic_compare_exchange_strong( &self->committed, &committed, index + 1 ) ) committed = index + 1; \
+    else                                                                                                    \
+    {                                                                                                       \
+        atomic_store( &vec_concurrent_flags_##T( segment, VEC_CONCURRENT_FIRST << k )[ offset ], 1 );       \
+        /* the failed exchange read committed before the flag was set, and a producer that published */     \
+        /* directly since then leaves no flag behind, so walk from a fresh value */                         \
+        committed = atomic_load( &self->committed );                                                        \
+    }                                                                                                       \
+    /* move committed over every ready slot, the producer filling the last gap finishes the job */          \
+    for ( ;; )                                                                                              \
+    {                                                                                                       \
+        atomic_uchar* ready = vec_concurrent_ready_##T( self, committed );                                  \
+        if ( ready == NULL || !atomic_load( ready ) ) break;                                                \
+        if ( atomic_compare_exchange_weak( &self->committed, &committed, committed + 1 ) ) committed++;     \
+    }                                                                                                       \
+    return index;                                                                                           \
+}                                                                                                           \
+/* number of elements a reader can use, all of them fully written */                                        \
+size_t vec_concurrent_size_##T( vec_concurrent_##T* self )                                                  \
+{                                                                                                           \
+    return atomic_load_explicit( &self->committed, memory_order_acquire );                                  \
+}                                                                                                           \
+/* address of element index, index must be below vec_concurrent_size */                                     \
+T* vec_concurrent_at_##T( vec_concurrent_##T* self, size_t index )                                          \
+{                                                                                                           \
+    size_t offset;                                                                                          \
+    size_t k = vec_concurrent_locate_( index, &offset );                                                    \
+    return atomic_load_explicit( &self->segments[k], memory_order_acquire ) + offset;                       \
+}                                                                                                           \
+/* append the committed prefix to the regular vector out, one memcpy per segment */                         \
+T* vec_concurrent_snapshot_##T( vec_concurrent_##T* self, T* out )                                          \
+{                                                                                                           \
+    size_t size = vec_concurrent_size_##T( self );                                                          \
+    out = vec_reserve_##T( out, vec_size_##T( out ) + size );                                               \
+    for ( size_t k = 0, done = 0; done < size; k++ )                                                        \
+    {                                                                                                       \
+        size_t count = VEC_CONCURRENT_FIRST << k;                                                           \
+        if ( count > size - done ) count = size - done;                                                     \
+        out = vec_append_arr_##T( out, atomic_load_explicit( &self->segments[k], memory_order_acquire ), count ); \
+        done += count;                                                                                      \
+    }                                                                                                       \
+    return out;                                                                                             \
+}                                                                                                           \
+
+#endif  // VECTOR_IMPLEMENTATION
@@ -0,0 +1,351 @@
+#ifndef __VEC_DEQUE_H__
+#define __VEC_DEQUE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "vector.h"
+
+
+// double-ended queue: a ring buffer in one block that starts with the same vec_meta header as a vector,
+// followed by the offset of the first element and the elements themselves
+// the capacity is a power of two, so element i lives at data[ ( head + i ) & ( capacity - 1 ) ], pushing and
+// popping at either end is O(1) and only a push into a full deque reallocates, doubling the capacity
+// pops never shrink the deque, work queues drain and refill all the time, call vec_deque_shrink_to_fit_##T
+// the elements are contiguous in at most two spans, vec_deque_span_##T hands them out for batch processing
+
+// the struct and the hot paths are the same in the declaration and the implementation
+#define vec_deque_common_( T )                                                                              \
+typedef struct vec_deque_##T                                                                                \
+{                                                                                                           \
+    vec_meta meta;                                                                                          \
+    size_t head;                    /* index in data of the front element */                                \
+    T data[];                                                                                               \
+} vec_deque_##T;                                                                                            \
+/* slow path of the pushes, defined with the rest of the deque */                                           \
+vec_deque_##T* vec_deque_grow_##T( vec_deque_##T* self, size_t size );                                      \
+/* Returns the number of elements in the deque */                                                           \
+static inline size_t vec_deque_size_##T( vec_deque_##T* self )                                              \
+{                                                                                                           \
+    return self->meta.size;                                                                                 \
+}                                                                                                           \
+/* get the allocated size for the deque in terms of elements, always a power of two */                      \
+static inline size_t vec_deque_capacity_##T( vec_deque_##T* self )                                          \
+{                                                                                                           \
+    return self->meta.capacity;                                                                             \
+}                                                                                                           \
+/* get the reference of element index counted from the front, index must be below the size */               \
+static inline T* vec_deque_at_##T( vec_deque_##T* self, size_t index )                                      \
+{                                                                                                           \
+    return &self->data[ ( self->head + index ) & ( self->meta.capacity - 1 ) ];                             \
+}                                                                                                           \
+/* get the reference of the first item, NULL when empty */                                                  \
+static inline T* vec_deque_front_##T( vec_deque_##T* self )                                                 \
+{                                                                                                           \
+    return self->meta.size > 0 ? &self->data[ self->head ] : NULL;                                          \
+}                                                                                                           \
+/* get the reference of the last item, NULL when empty */                                                   \
+static inline T* vec_deque_back_##T( vec_deque_##T* self )                                                  \
+{                                                                                                           \
+    return self->meta.size > 0 ? vec_deque_at_##T( self, self->meta.size - 1 ) : NULL;                      \
+}                                                                                                           \
+/* Adds a new element after the last one */                                                                 \
+static inline vec_deque_##T* vec_deque_push_back_##T( vec_deque_##T* self, T val )                          \
+{                                                                                                           \
+    if ( VEC_UNLIKELY( self->meta.size == self->meta.capacity ) )                                           \
+    {                                                                                                       \
+        self = vec_deque_grow_##T( self, self->meta.size + 1 );                                             \
+    }                                                                                                       \
+    *vec_deque_at_##T( self, self->meta.size++ ) = val;                                                     \
+    return self;                                                                                            \
+}                                                                                                           \
+/* Adds a new element before the first one */                                                               \
+static inline vec_deque_##T* vec_deque_push_front_##T( vec_deque_##T* self, T val )                         \
+{                                                                                                           \
+    if ( VEC_UNLIKELY( self->meta.size == self->meta.capacity ) )                                           \
+    {                                                                                                       \
+        self = vec_deque_grow_##T( self, self->meta.size + 1 );                                             \
+    }                                                                                                       \
+    self->head = ( self->head - 1 ) & ( self->meta.capacity - 1 );                                          \
+    self->meta.size++;                                                                                      \
+    self->data[ self->head ] = val;                                                                         \
+    return self;                                                                                            \
+}                                                                                                           \
+/* remove the first element and store it in *out ( NULL to drop it ), VEC_ERR_EMPTY when there is none */   \
+static inline int vec_deque_try_pop_front_##T( vec_deque_##T* self, T* out )                                \
+{                                                                                                           \
+    if ( VEC_UNLIKELY( self->meta.size == 0 ) ) return VEC_ERR_EMPTY;                                       \
+    if ( out != NULL ) *out = self->data[ self->head ];                                                     \
+    self->head = ( self->head + 1 ) & ( self->meta.capacity - 1 );                                          \
+    self->meta.size--;                                                                                      \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+/* remove the last element and store it in *out ( NULL to drop it ), VEC_ERR_EMPTY when there is none */    \
+static inline int vec_deque_try_pop_back_##T( vec_deque_##T* self, T* out )                                 \
+{                                                                                                           \
+    if ( VEC_UNLIKELY( self->meta.size == 0 ) ) return VEC_ERR_EMPTY;                                       \
+    self->meta.size--;                                                                                      \
+    if ( out != NULL ) *out = *vec_deque_at_##T( self, self->meta.size );                                   \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+/* Removes and returns the first element, the deque must not be empty */                                    \
+static inline T vec_deque_pop_front_##T( vec_deque_##T* self )                                              \
+{                                                                                                           \
+    T val;                                                                                                  \
+    int err = vec_deque_try_pop_front_##T( self, &val );                                                    \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return val;                                                                                             \
+}                                                                                                           \
+/* Removes and returns the last element, the deque must not be empty */                                     \
+static inline T vec_deque_pop_back_##T( vec_deque_##T* self )                                               \
+{                                                                                                           \
+    T val;                                                                                                  \
+    int err = vec_deque_try_pop_back_##T( self, &val );                                                     \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return val;                                                                                             \
+}                                                                                                           \
+/* the contiguous run of elements starting at index, *span points at it, 0 when index is past the end */    \
+/* vec_deque_span_##T( self, 0, &span ) and then vec_deque_span_##T( self, n, &span ) cover the deque */    \
+static inline size_t vec_deque_span_##T( vec_deque_##T* self, size_t index, T** span )                      \
+{                                                                                                           \
+    if ( index >= self->meta.size ) return 0;                                                               \
+    size_t start = ( self->head + index ) & ( self->meta.capacity - 1 );                                    \
+    size_t count = self->meta.size - index;                                                                 \
+    *span = &self->data[ start ];                                                                           \
+    return count < self->meta.capacity - start ? count : self->meta.capacity - start;                       \
+}                                                                                                           \
+/* remove the first count elements, at most the size, a consumer calls it after processing a span */        \
+static inline void vec_deque_drop_front_##T( vec_deque_##T* self, size_t count )                            \
+{                                                                                                           \
+    if ( count > self->meta.size ) count = self->meta.size;                                                 \
+    self->head = ( self->head + count ) & ( self->meta.capacity - 1 );                                      \
+    self->meta.size -= count;                                                                               \
+}                                                                                                           \
+/* remove the last count elements, at most the size */                                                      \
+static inline void vec_deque_drop_back_##T( vec_deque_##T* self, size_t count )                             \
+{                                                                                                           \
+    self->meta.size -= count < self->meta.size ? count : self->meta.size;                                   \
+}                                                                                                           \
+
+
+// generate the deque for T
+#ifndef VECTOR_IMPLEMENTATION
+#define using_deque( T )                                                                                    \
+vec_deque_common_( T )                                                                                      \
+vec_deque_##T* vec_deque_new_##T( size_t capacity );                                                        \
+vec_deque_##T* vec_deque_new_with_alloc_##T( size_t capacity, const vec_allocator* alloc );                 \
+vec_deque_##T* vec_deque_reserve_##T( vec_deque_##T* self, size_t size );                                   \
+vec_deque_##T* vec_deque_shrink_to_fit_##T( vec_deque_##T* self );                                          \
+vec_deque_##T* vec_deque_push_back_arr_##T( vec_deque_##T* self, const T* arr, size_t size );               \
+size_t vec_deque_pop_front_arr_##T( vec_deque_##T* self, T* out, size_t size );                             \
+void vec_deque_clear_##T( vec_deque_##T* self );                                                            \
+void vec_deque_destroy_##T( vec_deque_##T* self );                                                          \
+int vec_deque_try_new_##T( vec_deque_##T** self, size_t capacity );                                         \
+int vec_deque_try_new_with_alloc_##T( vec_deque_##T** self, size_t capacity, const vec_allocator* alloc );  \
+int vec_deque_try_reserve_##T( vec_deque_##T** self, size_t size );                                         \
+int vec_deque_try_push_back_##T( vec_deque_##T** self, T val );                                             \
+int vec_deque_try_push_front_##T( vec_deque_##T** self, T val );                                            \
+int vec_deque_try_push_back_arr_##T( vec_deque_##T** self, const T* arr, size_t size );                     \
+
+#endif  // VECTOR_IMPLEMENTATION
+#endif  // __VEC_DEQUE_H__
+
+
+#ifdef VECTOR_IMPLEMENTATION
+#define using_deque( T )                                                                                    \
+vec_deque_common_( T )                                                                                      \
+/* bytes of a deque block holding capacity elements */                                                      \
+static inline size_t vec_deque_bytes_##T( size_t capacity )                                                 \
+{                                                                                                           \
+    return sizeof ( vec_deque_##T ) + capacity * sizeof ( T );                                              \
+}                                                                                                           \
+static inline size_t vec_deque_align_##T( void )                                                            \
+{                                                                                                           \
+    return VEC_ALIGNMENT( _Alignof( vec_deque_##T ) );                                                      \
+}                                                                                                           \
+/* smallest power of two capacity holding size elements, 0 when there is none */                            \
+static inline size_t vec_deque_round_##T( size_t size )                                                     \
+{                                                                                                           \
+    size_t capacity = VEC_MIN_CAPACITY;                                                                     \
+    while ( capacity < size )                                                                               \
+    {                                                                                                       \
+        if ( capacity > ( SIZE_MAX - sizeof ( vec_deque_##T ) ) / sizeof ( T ) / 2 ) return 0;              \
+        capacity *= 2;                                                                                      \
+    }                                                                                                       \
+    return capacity;                                                                                        \
+}                                                                                                           \
+/* reallocate to capacity elements, capacity is a bigger power of two, NULL and untouched on failure */     \
+static vec_deque_##T* vec_deque_expand_##T( vec_deque_##T* self, size_t capacity )                          \
+{                                                                                                           \
+    size_t old = self->meta.capacity;                                                                       \
+    vec_deque_##T* grown = vec_mem_realloc( self->meta.alloc, self, vec_deque_bytes_##T( old ),             \
+                                            vec_deque_bytes_##T( capacity ), vec_deque_align_##T() );       \
+    if ( VEC_UNLIKELY( grown == NULL ) ) return NULL;                                                       \
+    /* a wrapped deque continues at data[ 0 ], move whichever of its two parts is shorter */                \
+    size_t first = old - grown->head;                                                                       \
+    if ( grown->meta.size > first )                                                                         \
+    {                                                                                                       \
+        size_t wrapped = grown->meta.size - first;                                                          \
+        if ( wrapped <= first ) memcpy( &grown->data[ old ], grown->data, wrapped * sizeof ( T ) );         \
+        else                                                                                                \
+        {                                                                                                   \
+            memcpy( &grown->data[ capacity - first ], &grown->data[ grown->head ], first * sizeof ( T ) );  \
+            grown->head = capacity - first;                                                                 \
+        }                                                                                                   \
+    }                                                                                                       \
+    grown->meta.capacity = capacity;                                                                        \
+    return grown;                                                                                           \
+}                                                                                                           \
+/* grow *self to hold at least size elements, *self is untouched on failure */                              \
+static int vec_deque_try_grow_##T( vec_deque_##T** self, size_t size )                                      \
+{                                                                                                           \
+    size_t capacity = ( *self )->meta.capacity;                                                             \
+    if ( size <= capacity ) return VEC_OK;                                                                  \
+    capacity = vec_deque_round_##T( size > capacity * 2 ? size : capacity * 2 );                            \
+    if ( VEC_UNLIKELY( capacity == 0 ) ) return VEC_ERR_NOMEM;                                              \
+    vec_deque_##T* grown = vec_deque_expand_##T( *self, capacity );                                         \
+    if ( VEC_UNLIKELY( grown == NULL ) ) return VEC_ERR_NOMEM;                                              \
+    *self = grown;                                                                                          \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+/* slow path of the pushes, only taken when the deque is full */                                            \
+VEC_COLD vec_deque_##T* vec_deque_grow_##T( vec_deque_##T* self, size_t size )                              \
+{                                                                                                           \
+    int err = vec_deque_try_grow_##T( &self, size );                                                        \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* create an empty deque with room for capacity elements, its memory comes from alloc ( NULL for malloc ) */ \
+int vec_deque_try_new_with_alloc_##T( vec_deque_##T** self, size_t capacity, const vec_allocator* alloc )   \
+{                                                                                                           \
+    capacity = vec_deque_round_##T( capacity );                                                             \
+    if ( VEC_UNLIKELY( capacity == 0 ) ) return VEC_ERR_NOMEM;                                              \
+    vec_deque_##T* deque = vec_mem_alloc( alloc, vec_deque_bytes_##T( capacity ), vec_deque_align_##T() );  \
+    if ( VEC_UNLIKELY( deque == NULL ) ) return VEC_ERR_NOMEM;                                              \
+    deque->meta = (vec_meta) { .size = 0, .capacity = capacity, .alloc = alloc, .flags = 0 };               \
+    deque->head = 0;                                                                                        \
+    *self = deque;                                                                                          \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+vec_deque_##T* vec_deque_new_with_alloc_##T( size_t capacity, const vec_allocator* alloc )                  \
+{                                                                                                           \
+    vec_deque_##T* self;                                                                                    \
+    int err = vec_deque_try_new_with_alloc_##T( &self, capacity, alloc );                                   \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* create an empty deque with room for capacity elements */                                                 \
+int vec_deque_try_new_##T( vec_deque_##T** self, size_t capacity )                                          \
+{                                                                                                           \
+    return vec_deque_try_new_with_alloc_##T( self, capacity, NULL );                                        \
+}                                                                                                           \
+vec_deque_##T* vec_deque_new_##T( size_t capacity )                                                         \
+{                                                                                                           \
+    return vec_deque_new_with_alloc_##T( capacity, NULL );                                                  \
+}                                                                                                           \
+/* Requests that the deque capacity be at least enough to contain size elements */                          \
+int vec_deque_try_reserve_##T( vec_deque_##T** self, size_t size )                                          \
+{                                                                                                           \
+    size_t capacity = ( *self )->meta.capacity;                                                             \
+    if ( size <= capacity ) return VEC_OK;                                                                  \
+    capacity = vec_deque_round_##T( size );                                                                 \
+    if ( VEC_UNLIKELY( capacity == 0 ) ) return VEC_ERR_NOMEM;                                              \
+    vec_deque_##T* grown = vec_deque_expand_##T( *self, capacity );                                         \
+    if ( VEC_UNLIKELY( grown == NULL ) ) return VEC_ERR_NOMEM;                                              \
+    *self = grown;                                                                                          \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+vec_deque_##T* vec_deque_reserve_##T( vec_deque_##T* self, size_t size )                                    \
+{                                                                                                           \
+    int err = vec_deque_try_reserve_##T( &self, size );                                                     \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* move the elements to the smallest power of two block holding them, the front ends up at data[ 0 ] */     \
+/* a smaller block that cannot be allocated keeps the current one */                                        \
+vec_deque_##T* vec_deque_shrink_to_fit_##T( vec_deque_##T* self )                                           \
+{                                                                                                           \
+    size_t capacity = vec_deque_round_##T( self->meta.size );                                               \
+    if ( capacity >= self->meta.capacity ) return self;                                                     \
+    vec_deque_##T* deque = vec_mem_alloc( self->meta.alloc, vec_deque_bytes_##T( capacity ),                \
+                                          vec_deque_align_##T() );                                          \
+    if ( VEC_UNLIKELY( deque == NULL ) ) return self;                                                       \
+    deque->meta = self->meta;                                                                               \
+    deque->meta.capacity = capacity;                                                                        \
+    deque->head = 0;                                                                                        \
+    T* span = self->data;                                                                                   \
+    size_t first = vec_deque_span_##T( self, 0, &span );                                                    \
+    memcpy( deque->data, span, first * sizeof ( T ) );                                                      \
+    size_t rest = vec_deque_span_##T( self, first, &span );                                                 \
+    memcpy( &deque->data[ first ], span, rest * sizeof ( T ) );                                             \
+    vec_mem_free( self->meta.alloc, self, vec_deque_bytes_##T( self->meta.capacity ),                       \
+                  vec_deque_align_##T() );                                                                  \
+    return deque;                                                                                           \
+}                                                                                                           \
+/* push_back reporting VEC_ERR_NOMEM instead of exiting, *self is untouched on failure */                   \
+int vec_deque_try_push_back_##T( vec_deque_##T** self, T val )                                              \
+{                                                                                                           \
+    int err = vec_deque_try_grow_##T( self, ( *self )->meta.size + 1 );                                     \
+    if ( VEC_UNLIKELY( err ) ) return err;                                                                  \
+    *self = vec_deque_push_back_##T( *self, val );                                                          \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+/* push_front reporting VEC_ERR_NOMEM instead of exiting, *self is untouched on failure */                  \
+int vec_deque_try_push_front_##T( vec_deque_##T** self, T val )                                             \
+{                                                                                                           \
+    int err = vec_deque_try_grow_##T( self, ( *self )->meta.size + 1 );                                     \
+    if ( VEC_UNLIKELY( err ) ) return err;                                                                  \
+    *self = vec_deque_push_front_##T( *self, val );                                                         \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+/* append size elements of arr after the last one, with at most two copies */                               \
+int vec_deque_try_push_back_arr_##T( vec_deque_##T** self, const T* arr, size_t size )                      \
+{                                                                                                           \
+    vec_deque_##T* deque = *self;                                                                           \
+    if ( VEC_UNLIKELY( size > SIZE_MAX - deque->meta.size ) ) return VEC_ERR_NOMEM;                         \
+    int err = vec_deque_try_grow_##T( &deque, deque->meta.size + size );                                    \
+    if ( VEC_UNLIKELY( err ) ) return err;                                                                  \
+    size_t mask = deque->meta.capacity - 1;                                                                 \
+    size_t tail = ( deque->head + deque->meta.size ) & mask;                                                \
+    size_t first = deque->meta.capacity - tail < size ? deque->meta.capacity - tail : size;                 \
+    memcpy( &deque->data[ tail ], arr, first * sizeof ( T ) );                                              \
+    memcpy( deque->data, arr + first, ( size - first ) * sizeof ( T ) );                                    \
+    deque->meta.size += size;                                                                               \
+    *self = deque;                                                                                          \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+vec_deque_##T* vec_deque_push_back_arr_##T( vec_deque_##T* self, const T* arr, size_t size )                \
+{                                                                                                           \
+    int err = vec_deque_try_push_back_arr_##T( &self, arr, size );                                          \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* move up to size elements from the front into out, returns how many were moved */                         \
+size_t vec_deque_pop_front_arr_##T( vec_deque_##T* self, T* out, size_t size )                              \
+{                                                                                                           \
+    size_t done = 0;                                                                                        \
+    T* span;                                                                                                \
+    size_t count;                                                                                           \
+    while ( done < size && ( count = vec_deque_span_##T( self, 0, &span ) ) > 0 )                           \
+    {                                                                                                       \
+        if ( count > size - done ) count = size - done;                                                     \
+        memcpy( out + done, span, count * sizeof ( T ) );                                                   \
+        vec_deque_drop_front_##T( self, count );                                                            \
+        done += count;                                                                                      \
+    }                                                                                                       \
+    return done;                                                                                            \
+}                                                                                                           \
+/* remove every element, keeps the capacity */                                                              \
+void vec_deque_clear_##T( vec_deque_##T* self )                                                             \
+{                                                                                                           \
+    self->meta.size = 0;                                                                                    \
+    self->head = 0;                                                                                         \
+}                                                                                                           \
+void vec_deque_destroy_##T( vec_deque_##T* self )                                                           \
+{                                                                                                           \
+    vec_mem_free( self->meta.alloc, self, vec_deque_bytes_##T( self->meta.capacity ),                       \
+                  vec_deque_align_##T() );                                                                  \
+}                                                                                                           \
+
+#endif  // VECTOR_IMPLEMENTATION
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
+#include <ctype.h>
 #define VECTOR_IMPLEMENTATION
 #include "vector.h"
 
@@ -11,310 +13,782 @@ typedef struct cstr
     size_t length;
 } cstr;
 
+// one element type of the manifest and its options
+typedef struct gen_type
+{
+    char* name;
+    char* align;                // aligned=N, NULL for VEC_HEADER_ALIGN
+    char* alloc;                // alloc=EXPR, a `const vec_allocator*` used by vec_new / vec_try_new, NULL for malloc
+    char* policy;               // policy=FN, NULL for VEC_GROWTH_DEFAULT
+    char* less;                 // sort or sort=LESS, NULL for no sorting
+    char* radix;                // radix=KEY, NULL for no radix sort
+    char* soa;                  // the ( type, field ) columns of a structure-of-arrays vector, NULL for the others
+    char* map;                  // the K, V, HASH, EQ arguments of a flat map named K_V, NULL for the others
+    bool inline_mode;           // inline or extern
+    bool numeric;               // numeric, on by default for the arithmetic types below
+} gen_type;
+
 
 using_vector( cstr )
+using_vector( char )
+using_vector( gen_type )
+
+
+// element types that get the bulk kernels of vec_simd.h
+static const char* numeric_types[] = {
+    "char", "short", "int", "long", "float", "double", "size_t",
+    "int8_t", "int16_t", "int32_t", "int64_t", "uint8_t", "uint16_t", "uint32_t", "uint64_t",
+};
+
+static bool is_numeric( const char* type )
+{
+    for ( size_t i = 0; i < sizeof ( numeric_types ) / sizeof ( numeric_types[0] ); i++ )
+    {
+        if ( strcmp( type, numeric_types[i] ) == 0 ) return true;
+    }
+    return false;
+}
+
+// the type name is pasted into function names, so it has to be an identifier
+static bool is_identifier( const char* name )
+{
+    if ( !isalpha( (unsigned char) name[0] ) && name[0] != '_' ) return false;
+    for ( const char* c = name; *c; c++ )
+    {
+        if ( !isalnum( (unsigned char) *c ) && *c != '_' ) return false;
+    }
+    return true;
+}
+
+static char* copy_str( const char* str )
+{
+    size_t length = strlen( str ) + 1;
+    char* copy = malloc( length );
+    if ( copy == NULL )
+    {
+        fprintf( stderr, "[ERRO]: out of memory\n" );
+        exit(1);
+    }
+    return memcpy( copy, str, length );
+}
 
 
+// which types a dispatcher covers
+enum { GROUP_ALL, GROUP_NUMERIC, GROUP_SORT, GROUP_RADIX, GROUP_SOA, GROUP_MAP };
+
+// one `_Generic` dispatcher: `#define name( params ) _Generic( (on), T<suffix>: name_T, ... )( params )`
+typedef struct gen_op
+{
+    const char* proto;          // the signature in the comment above the macro
+    const char* name;
+    const char* params;
+    const char* on;             // the argument whose type picks the function
+    const char* suffix;         // "" when `on` is an element or a view, "*" for a vector or a view address,
+                                // "**" for the address of a vector
+    int group;
+    bool uses_alloc;            // goes through the manifest allocator of the type when it has one
+    bool soa;                   // GROUP_ALL operation that vec_soa.h provides too, keyed on Name_row for `val`
+} gen_op;
+
+static bool in_group( const gen_type* type, const gen_op* op )
+{
+    switch ( op->group )
+    {
+        case GROUP_NUMERIC: return type->numeric;
+        case GROUP_SORT:    return type->less != NULL;
+        case GROUP_RADIX:   return type->radix != NULL;
+        case GROUP_SOA:     return type->soa != NULL;
+        case GROUP_MAP:     return type->map != NULL;
+        default:            return type->map == NULL && ( type->soa == NULL || op->soa );
+    }
+}
+
+static const gen_op ops[] = {
+    { "T* vec_new( size_t size, T val );", "vec_new", "size, val", "val", "", GROUP_ALL, true, true },
+    { "T* vec_new_with_alloc( size_t size, T val, const vec_allocator* alloc );",
+      "vec_new_with_alloc", "size, val, alloc", "val", "", GROUP_ALL, false, true },
+    { "T* vec_resize( T* self, size_t size, T val );",
+      "vec_resize", "self, size, val", "self", "*", GROUP_ALL, false, true },
+    { "T* vec_clear( T* self );", "vec_clear", "self", "self", "*", GROUP_ALL, false, true },
+    { "T* vec_trim( T* self, size_t max_cap );", "vec_trim", "self, max_cap", "self", "*", GROUP_ALL, false, false },
+    { "T* vec_release( T* self );", "vec_release", "self", "self", "*", GROUP_ALL, false, false },
+    { "T* vec_assign( T* self, size_t size, T val );",
+      "vec_assign", "self, size, val", "self", "*", GROUP_ALL, false, false },
+    { "T* vec_front( T* self );", "vec_front", "self", "self", "*", GROUP_ALL, false, false },
+    { "T* vec_back( T* self );", "vec_back", "self", "self", "*", GROUP_ALL, false, false },
+    { "T* vec_shrink_to_fit( T* self );", "vec_shrink_to_fit", "self", "self", "*", GROUP_ALL, false, true },
+    { "T* vec_reserve( T* self, size_t size );", "vec_reserve", "self, size", "self", "*", GROUP_ALL, false, true },
+    { "T* vec_insert( T* self, size_t position, T val );",
+      "vec_insert", "self, position, val", "self", "*", GROUP_ALL, false, false },
+    { "T* vec_insert_arr( T* self, size_t position, const T* arr, size_t size );",
+      "vec_insert_arr", "self, position, arr, size", "self", "*", GROUP_ALL, false, false },
+    { "T* vec_append_arr( T* self, const T* arr, size_t size );",
+      "vec_append_arr", "self, arr, size", "self", "*", GROUP_ALL, false, false },
+    { "T* vec_append_vec( T* self, T* other );", "vec_append_vec", "self, other", "self", "*", GROUP_ALL, false, false },
+    { "T* vec_erase_range( T* self, size_t position, size_t count );",
+      "vec_erase_range", "self, position, count", "self", "*", GROUP_ALL, false, false },
+    { "T* vec_swap_remove( T* self, size_t position );",
+      "vec_swap_remove", "self, position", "self", "*", GROUP_ALL, false, true },
+    { "T* vec_truncate( T* self, size_t size );", "vec_truncate", "self, size", "self", "*", GROUP_ALL, false, false },
+    { "T* vec_push_back( T* self, T val );", "vec_push_back", "self, val", "self", "*", GROUP_ALL, false, true },
+    { "T* vec_emplace_back( T* self );", "vec_emplace_back", "self", "self", "*", GROUP_ALL, false, false },
+    { "T* vec_pop_back( T* self );", "vec_pop_back", "self", "self", "*", GROUP_ALL, false, true },
+    { "size_t vec_size( T* self );", "vec_size", "self", "self", "*", GROUP_ALL, false, true },
+    { "size_t vec_capacity( T* self );", "vec_capacity", "self", "self", "*", GROUP_ALL, false, true },
+    { "void vec_destroy( T* self );", "vec_destroy", "self", "self", "*", GROUP_ALL, false, true },
+    { "void vec_scratch_put( T* self );", "vec_scratch_put", "self", "self", "*", GROUP_ALL, false, false },
+
+    // the vec_try_* functions take the address of the vector and return VEC_OK or a VEC_ERR_* code
+    { "int vec_try_new( T** self, size_t size, T val );",
+      "vec_try_new", "self, size, val", "self", "**", GROUP_ALL, true, true },
+    { "int vec_try_new_with_alloc( T** self, size_t size, T val, const vec_allocator* alloc );",
+      "vec_try_new_with_alloc", "self, size, val, alloc", "self", "**", GROUP_ALL, false, true },
+    { "int vec_try_push_back( T** self, T val );", "vec_try_push_back", "self, val", "self", "**", GROUP_ALL, false, true },
+    { "int vec_try_emplace_back( T** self );", "vec_try_emplace_back", "self", "self", "**", GROUP_ALL, false, false },
+    { "int vec_try_pop_back( T** self );", "vec_try_pop_back", "self", "self", "**", GROUP_ALL, false, true },
+    { "int vec_try_resize( T** self, size_t size, T val );",
+      "vec_try_resize", "self, size, val", "self", "**", GROUP_ALL, false, true },
+    { "int vec_try_assign( T** self, size_t size, T val );",
+      "vec_try_assign", "self, size, val", "self", "**", GROUP_ALL, false, false },
+    { "int vec_try_reserve( T** self, size_t size );",
+      "vec_try_reserve", "self, size", "self", "**", GROUP_ALL, false, true },
+    { "int vec_try_insert( T** self, size_t position, T val );",
+      "vec_try_insert", "self, position, val", "self", "**", GROUP_ALL, false, false },
+    { "int vec_try_insert_arr( T** self, size_t position, const T* arr, size_t size );",
+      "vec_try_insert_arr", "self, position, arr, size", "self", "**", GROUP_ALL, false, false },
+    { "int vec_try_append_arr( T** self, const T* arr, size_t size );",
+      "vec_try_append_arr", "self, arr, size", "self", "**", GROUP_ALL, false, false },
+    { "int vec_try_append_vec( T** self, T* other );",
+      "vec_try_append_vec", "self, other", "self", "**", GROUP_ALL, false, false },
+    { "int vec_try_erase_range( T** self, size_t position, size_t count );",
+      "vec_try_erase_range", "self, position, count", "self", "**", GROUP_ALL, false, false },
+    { "int vec_try_swap_remove( T** self, size_t position );",
+      "vec_try_swap_remove", "self, position", "self", "**", GROUP_ALL, false, true },
+
+    // views, a vec_view_T is passed by value and dispatched on as `view`
+    { "vec_view_T vec_view_of( T* self );", "vec_view_of", "self", "self", "*", GROUP_ALL, false, false },
+    { "vec_view_T vec_view_arr( T* arr, size_t size );",
+      "vec_view_arr", "arr, size", "arr", "*", GROUP_ALL, false, false },
+    { "vec_view_T vec_view_range( T* self, size_t position, size_t count );",
+      "vec_view_range", "self, position, count", "self", "*", GROUP_ALL, false, false },
+    { "vec_view_T vec_view_sub( vec_view_T view, size_t position, size_t count );",
+      "vec_view_sub", "view, position, count", "view", "", GROUP_ALL, false, false },
+    { "int vec_view_try_sub( vec_view_T* view, size_t position, size_t count );",
+      "vec_view_try_sub", "view, position, count", "view", "*", GROUP_ALL, false, false },
+    { "size_t vec_view_size( vec_view_T view );", "vec_view_size", "view", "view", "", GROUP_ALL, false, false },
+    { "T* vec_view_at( vec_view_T view, size_t position );",
+      "vec_view_at", "view, position", "view", "", GROUP_ALL, false, false },
+    { "T* vec_view_front( vec_view_T view );", "vec_view_front", "view", "view", "", GROUP_ALL, false, false },
+    { "T* vec_view_back( vec_view_T view );", "vec_view_back", "view", "view", "", GROUP_ALL, false, false },
+
+    // bulk kernels, only for the numeric types
+    { "T* vec_fill( T* self, T val );", "vec_fill", "self, val", "self", "*", GROUP_NUMERIC, false, false },
+    { "T vec_sum( T* self );", "vec_sum", "self", "self", "*", GROUP_NUMERIC, false, false },
+    { "bool vec_minmax( T* self, T* min, T* max );",
+      "vec_minmax", "self, min, max", "self", "*", GROUP_NUMERIC, false, false },
+    { "T vec_dot( T* a, T* b );", "vec_dot", "a, b", "a", "*", GROUP_NUMERIC, false, false },
+    { "T* vec_axpy( T* y, T a, T* x );", "vec_axpy", "y, a, x", "y", "*", GROUP_NUMERIC, false, false },
+    { "T* vec_scale( T* self, T a );", "vec_scale", "self, a", "self", "*", GROUP_NUMERIC, false, false },
+    { "void vec_view_fill( vec_view_T view, T val );",
+      "vec_view_fill", "view, val", "view", "", GROUP_NUMERIC, false, false },
+    { "T vec_view_sum( vec_view_T view );", "vec_view_sum", "view", "view", "", GROUP_NUMERIC, false, false },
+    { "bool vec_view_minmax( vec_view_T view, T* min, T* max );",
+      "vec_view_minmax", "view, min, max", "view", "", GROUP_NUMERIC, false, false },
+    { "T vec_view_dot( vec_view_T view, vec_view_T other );",
+      "vec_view_dot", "view, other", "view", "", GROUP_NUMERIC, false, false },
+    { "void vec_view_axpy( vec_view_T view, T a, vec_view_T other );",
+      "vec_view_axpy", "view, a, other", "view", "", GROUP_NUMERIC, false, false },
+    { "void vec_view_scale( vec_view_T view, T a );",
+      "vec_view_scale", "view, a", "view", "", GROUP_NUMERIC, false, false },
+
+    // sorting and searching, only for the types with a sort or radix key
+    { "T* vec_sort( T* self );", "vec_sort", "self", "self", "*", GROUP_SORT, false, false },
+    { "T* vec_stable_sort( T* self );", "vec_stable_sort", "self", "self", "*", GROUP_SORT, false, false },
+    { "int vec_try_stable_sort( T* self );", "vec_try_stable_sort", "self", "self", "*", GROUP_SORT, false, false },
+    { "size_t vec_lower_bound( T* self, T val );", "vec_lower_bound", "self, val", "self", "*", GROUP_SORT, false, false },
+    { "size_t vec_upper_bound( T* self, T val );", "vec_upper_bound", "self, val", "self", "*", GROUP_SORT, false, false },
+    { "bool vec_binary_search( T* self, T val );",
+      "vec_binary_search", "self, val", "self", "*", GROUP_SORT, false, false },
+    { "T* vec_unique( T* self );", "vec_unique", "self", "self", "*", GROUP_SORT, false, false },
+    { "T* vec_radix_sort( T* self );", "vec_radix_sort", "self", "self", "*", GROUP_RADIX, false, false },
+    { "int vec_try_radix_sort( T* self );", "vec_try_radix_sort", "self", "self", "*", GROUP_RADIX, false, false },
+    { "void vec_view_sort( vec_view_T view );", "vec_view_sort", "view", "view", "", GROUP_SORT, false, false },
+    { "void vec_view_stable_sort( vec_view_T view );",
+      "vec_view_stable_sort", "view", "view", "", GROUP_SORT, false, false },
+    { "int vec_view_try_stable_sort( vec_view_T view );",
+      "vec_view_try_stable_sort", "view", "view", "", GROUP_SORT, false, false },
+    { "size_t vec_view_lower_bound( vec_view_T view, T val );",
+      "vec_view_lower_bound", "view, val", "view", "", GROUP_SORT, false, false },
+    { "size_t vec_view_upper_bound( vec_view_T view, T val );",
+      "vec_view_upper_bound", "view, val", "view", "", GROUP_SORT, false, false },
+    { "bool vec_view_binary_search( vec_view_T view, T val );",
+      "vec_view_binary_search", "view, val", "view", "", GROUP_SORT, false, false },
+    { "vec_view_T vec_view_unique( vec_view_T view );",
+      "vec_view_unique", "view", "view", "", GROUP_SORT, false, false },
+    { "void vec_view_radix_sort( vec_view_T view );",
+      "vec_view_radix_sort", "view", "view", "", GROUP_RADIX, false, false },
+    { "int vec_view_try_radix_sort( vec_view_T view );",
+      "vec_view_try_radix_sort", "view", "view", "", GROUP_RADIX, false, false },
+
+    // rows of the structure-of-arrays vectors, the other SoA operations are the ones marked above
+    { "T_row vec_get( T* self, size_t position );",
+      "vec_get", "self, position", "self", "*", GROUP_SOA, false, false },
+    { "void vec_set( T* self, size_t position, T_row val );",
+      "vec_set", "self, position, val", "self", "*", GROUP_SOA, false, false },
+
+    // flat maps, the map from K to V is vec_map_K_V
+    { "vec_map_T* vec_map_put( vec_map_T* self, K key, V val );",
+      "vec_map_put", "self, key, val", "self", "*", GROUP_MAP, false, false },
+    { "V* vec_map_get( vec_map_T* self, K key );", "vec_map_get", "self, key", "self", "*", GROUP_MAP, false, false },
+    { "bool vec_map_contains( vec_map_T* self, K key );",
+      "vec_map_contains", "self, key", "self", "*", GROUP_MAP, false, false },
+    { "bool vec_map_remove( vec_map_T* self, K key );",
+      "vec_map_remove", "self, key", "self", "*", GROUP_MAP, false, false },
+    { "size_t vec_map_get_batch( vec_map_T* self, const K* keys, size_t size, V** out );",
+      "vec_map_get_batch", "self, keys, size, out", "self", "*", GROUP_MAP, false, false },
+    { "vec_map_entry_T* vec_map_next( vec_map_T* self, size_t* iter );",
+      "vec_map_next", "self, iter", "self", "*", GROUP_MAP, false, false },
+    { "vec_map_T* vec_map_reserve( vec_map_T* self, size_t size );",
+      "vec_map_reserve", "self, size", "self", "*", GROUP_MAP, false, false },
+    { "vec_map_T* vec_map_rehash( vec_map_T* self, size_t size );",
+      "vec_map_rehash", "self, size", "self", "*", GROUP_MAP, false, false },
+    { "size_t vec_map_size( vec_map_T* self );", "vec_map_size", "self", "self", "*", GROUP_MAP, false, false },
+    { "size_t vec_map_capacity( vec_map_T* self );",
+      "vec_map_capacity", "self", "self", "*", GROUP_MAP, false, false },
+    { "void vec_map_clear( vec_map_T* self );", "vec_map_clear", "self", "self", "*", GROUP_MAP, false, false },
+    { "void vec_map_destroy( vec_map_T* self );", "vec_map_destroy", "self", "self", "*", GROUP_MAP, false, false },
+    { "int vec_map_try_put( vec_map_T** self, K key, V val );",
+      "vec_map_try_put", "self, key, val", "self", "**", GROUP_MAP, false, false },
+    { "int vec_map_try_reserve( vec_map_T** self, size_t size );",
+      "vec_map_try_reserve", "self, size", "self", "**", GROUP_MAP, false, false },
+    { "int vec_map_try_rehash( vec_map_T** self, size_t size );",
+      "vec_map_try_rehash", "self, size", "self", "**", GROUP_MAP, false, false },
+};
+
+
+// formatted append to a growing text buffer
+static char* emit( char* out, const char* fmt, ... )
+{
+    va_list args, again;
+    va_start( args, fmt );
+    va_copy( again, args );
+    int length = vsnprintf( NULL, 0, fmt, args );
+    va_end( args );
+    size_t size = vec_size_char( out );
+    out = vec_resize_char( out, size + length + 1, 0 );
+    vsnprintf( out + size, length + 1, fmt, again );
+    va_end( again );
+    return vec_pop_back_char( out );
+}
+
+static char* emit_dispatch( char* out, const gen_op* op, gen_type* types )
+{
+    size_t last = SIZE_MAX;
+    for ( size_t i = 0; i < vec_size_gen_type( types ); i++ )
+    {
+        if ( in_group( &types[i], op ) ) last = i;
+    }
+    if ( last == SIZE_MAX ) return out;
+
+    out = emit( out, "// %s\n", op->proto );
+    if ( strcmp( op->on, "val" ) == 0 )
+    {
+        out = emit( out, "// dispatches on the type of val, cast it to the element type\n" );
+    }
+    out = emit( out, "#define %s( %s ) _Generic( (%s), \\\n", op->name, op->params, op->on );
+    for ( size_t i = 0; i <= last; i++ )
+    {
+        if ( !in_group( &types[i], op ) ) continue;
+        const char* name = types[i].name;
+        const char* prefix = types[i].map ? "vec_map_" : strcmp( op->on, "view" ) == 0 ? "vec_view_" : "";
+        const char* key = types[i].soa && op->suffix[0] == '\0' ? "_row" : "";
+        const char* tail = op->uses_alloc && types[i].alloc ? "_alloc_" : "";
+        out = emit( out, "    %s%s%s%s: %s_%s%s%s \\\n", prefix, name, key, op->suffix, op->name, name, tail,
+                    i < last ? "," : "" );
+    }
+    return emit( out, ")( %s ) \\\n\n", op->params );
+}
+
+// the using_* lines of one type, the same in the header and in its .c
+static char* emit_using( char* out, const gen_type* type )
+{
+    if ( type->soa ) return emit( out, "using_soa_vector( %s, %s )\n", type->name, type->soa );
+    if ( type->map ) return emit( out, "using_flat_map( %s )\n", type->map );
+    out = emit( out, "using_vector_ex( %s, %s, %s, %s )\n", type->name, type->policy ? type->policy : "VEC_GROWTH_DEFAULT",
+                type->align ? type->align : "VEC_HEADER_ALIGN", type->inline_mode ? "inline" : "extern" );
+    if ( type->numeric ) out = emit( out, "using_vector_numeric( %s )\n", type->name );
+    if ( type->less ) out = emit( out, "using_vector_sort( %s, %s )\n", type->name, type->less );
+    if ( type->radix ) out = emit( out, "using_vector_radix( %s, %s )\n", type->name, type->radix );
+    return out;
+}
+
+static char* emit_includes( char* out, cstr* includes, bool numeric, bool sorted, bool soa, bool map )
+{
+    out = emit( out, "#include \"vector.h\"\n" );
+    if ( numeric ) out = emit( out, "#include \"vec_simd.h\"\n" );
+    if ( sorted ) out = emit( out, "#include \"vec_sort.h\"\n" );
+    if ( soa ) out = emit( out, "#include \"vec_soa.h\"\n" );
+    if ( map ) out = emit( out, "#include \"vec_map.h\"\n" );
+    for ( size_t i = 0; i < vec_size_cstr( includes ); i++ )
+    {
+        out = emit( out, "#include %s\n", includes[i].cstr );
+    }
+    return emit( out, "\n" );
+}
+
+// write text to path unless the file already holds exactly that, so make and ninja see no change
+// returns false when the file could not be written
+static bool write_if_changed( const char* path, const char* text, size_t size )
+{
+    FILE* file = fopen( path, "rb" );
+    if ( file != NULL )
+    {
+        bool same = true;
+        size_t at = 0;
+        char buffer[ 4096 ];
+        size_t got;
+        while ( same && ( got = fread( buffer, 1, sizeof buffer, file ) ) > 0 )
+        {
+            same = at + got <= size && memcmp( buffer, text + at, got ) == 0;
+            at += got;
+        }
+        fclose( file );
+        if ( same && at == size ) return true;
+    }
+    file = fopen( path, "wb" );
+    if ( file == NULL ) return false;
+    bool ok = fwrite( text, 1, size, file ) == size;
+    return fclose( file ) == 0 && ok;
+}
+
+
+// parse one `key` or `key=value` option of a manifest type line, false when it is unknown
+static bool parse_option( gen_type* type, char* option )
+{
+    char* value = strchr( option, '=' );
+    if ( value != NULL ) *value++ = '\0';
+    if ( strcmp( option, "inline" ) == 0 && value == NULL ) type->inline_mode = true;
+    else if ( strcmp( option, "extern" ) == 0 && value == NULL ) type->inline_mode = false;
+    else if ( strcmp( option, "numeric" ) == 0 && value == NULL ) type->numeric = true;
+    else if ( strcmp( option, "sort" ) == 0 ) type->less = copy_str( value ? value : "VEC_LESS" );
+    else if ( strcmp( option, "aligned" ) == 0 && value ) type->align = copy_str( value );
+    else if ( strcmp( option, "alloc" ) == 0 && value ) type->alloc = copy_str( value );
+    else if ( strcmp( option, "policy" ) == 0 && value ) type->policy = copy_str( value );
+    else if ( strcmp( option, "radix" ) == 0 && value ) type->radix = copy_str( value );
+    else return false;
+    return true;
+}
+
+static gen_type* add_type( gen_type* types, const char* name, bool inline_mode, const char* where )
+{
+    if ( !is_identifier( name ) )
+    {
+        fprintf( stderr, "[ERRO]: %s: type '%s' is not an identifier, typedef it first\n", where, name );
+        exit(1);
+    }
+    for ( size_t i = 0; i < vec_size_gen_type( types ); i++ )
+    {
+        if ( strcmp( types[i].name, name ) == 0 )
+        {
+            fprintf( stderr, "[ERRO]: %s: type '%s' listed twice\n", where, name );
+            exit(1);
+        }
+    }
+    return vec_push_back_gen_type( types, (gen_type) {
+        .name = copy_str( name ), .inline_mode = inline_mode, .numeric = is_numeric( name ) } );
+}
+
+// the rest of a `soa <Name> <type>:<field>...` line, the columns become the using_soa_vector arguments
+// the only option of a SoA vector is alloc=EXPR
+static void parse_soa( gen_type* type, const char* where )
+{
+    char* columns = vec_new_char( 0, 0 );
+    int count = 0;
+    char* token;
+    while ( ( token = strtok( NULL, " \t\r\n" ) ) != NULL )
+    {
+        char* field = strrchr( token, ':' );
+        if ( field == NULL )
+        {
+            if ( strncmp( token, "alloc=", 6 ) == 0 && token[6] != '\0' && type->alloc == NULL )
+            {
+                type->alloc = copy_str( token + 6 );
+                continue;
+            }
+            fprintf( stderr, "[ERRO]: %s: unknown option '%s' for soa '%s'\n", where, token, type->name );
+            exit(1);
+        }
+        *field++ = '\0';
+        if ( token[0] == '\0' || !is_identifier( field ) )
+        {
+            fprintf( stderr, "[ERRO]: %s: column '%s:%s' of soa '%s' is not <type>:<field>\n",
+                     where, token, field, type->name );
+            exit(1);
+        }
+        columns = emit( columns, "%s( %s, %s )", count > 0 ? ", " : "", token, field );
+        count++;
+    }
+    if ( count == 0 || count > 16 )
+    {
+        fprintf( stderr, "[ERRO]: %s: soa '%s' needs 1 to 16 columns\n", where, type->name );
+        exit(1);
+    }
+    columns = vec_push_back_char( columns, '\0' );
+    type->soa = copy_str( columns );
+    type->numeric = false;
+    vec_destroy_char( columns );
+}
+
+// the rest of a `map <K> <V> [hash=FN] [eq=FN]` line, the map is named K_V
+static gen_type* parse_map( gen_type* types, bool inline_mode, const char* where )
+{
+    char* key = strtok( NULL, " \t\r\n" );
+    char* val = key ? strtok( NULL, " \t\r\n" ) : NULL;
+    if ( val == NULL || !is_identifier( key ) || !is_identifier( val ) )
+    {
+        fprintf( stderr, "[ERRO]: %s: map needs a key and a value type, both identifiers\n", where );
+        exit(1);
+    }
+    const char* hash = "VEC_HASH";
+    const char* eq = "VEC_EQ";
+    char* token;
+    while ( ( token = strtok( NULL, " \t\r\n" ) ) != NULL )
+    {
+        if ( strncmp( token, "hash=", 5 ) == 0 && token[5] != '\0' ) hash = token + 5;
+        else if ( strncmp( token, "eq=", 3 ) == 0 && token[3] != '\0' ) eq = token + 3;
+        else
+        {
+            fprintf( stderr, "[ERRO]: %s: unknown option '%s' for map %s %s\n", where, token, key, val );
+            exit(1);
+        }
+    }
+    char* name = vec_new_char( 0, 0 );
+    name = emit( name, "%s_%s", key, val );
+    name = vec_push_back_char( name, '\0' );
+    types = add_type( types, name, inline_mode, where );
+    vec_destroy_char( name );
+    gen_type* type = vec_back_gen_type( types );
+    char* args = vec_new_char( 0, 0 );
+    args = emit( args, "%s, %s, %s, %s", key, val, hash, eq );
+    args = vec_push_back_char( args, '\0' );
+    type->map = copy_str( args );
+    type->numeric = false;
+    vec_destroy_char( args );
+    return types;
+}
+
+// manifest format, one entry per line, '#' starts a comment:
+//     include "point.h"                                   added to every generated file
+//     <type> [option...]                                  inline extern numeric aligned=N alloc=EXPR
+//                                                         policy=FN sort[=LESS] radix=KEY
+//     soa <Name> <type>:<field>... [alloc=EXPR]           a structure-of-arrays vector, see vec_soa.h
+//     map <K> <V> [hash=FN] [eq=FN]                       a flat hash map vec_map_K_V, see vec_map.h
+static gen_type* read_manifest( gen_type* types, cstr* includes[], const char* path, bool inline_mode )
+{
+    FILE* file = fopen( path, "r" );
+    if ( file == NULL )
+    {
+        fprintf( stderr, "[ERRO]: cannot open manifest " );
+        perror( path );
+        exit(1);
+    }
+    char line[ 4096 ];
+    char where[ 4200 ];
+    for ( int number = 1; fgets( line, sizeof line, file ) != NULL; number++ )
+    {
+        snprintf( where, sizeof where, "%s:%d", path, number );
+        if ( strchr( line, '\n' ) == NULL && !feof( file ) )
+        {
+            fprintf( stderr, "[ERRO]: %s: line too long\n", where );
+            exit(1);
+        }
+        char* comment = strchr( line, '#' );
+        if ( comment != NULL && strncmp( comment, "#include", 8 ) != 0 ) *comment = '\0';
+        char* token = strtok( line, " \t\r\n" );
+        if ( token == NULL ) continue;
+        if ( strcmp( token, "include" ) == 0 || strcmp( token, "#include" ) == 0 )
+        {
+            token = strtok( NULL, " \t\r\n" );
+            if ( token == NULL )
+            {
+                fprintf( stderr, "[ERRO]: %s: include needs a header\n", where );
+                exit(1);
+            }
+            *includes = vec_push_back_cstr( *includes, (cstr) { .length = strlen( token ), .cstr = copy_str( token ) } );
+            continue;
+        }
+        if ( strcmp( token, "soa" ) == 0 )
+        {
+            token = strtok( NULL, " \t\r\n" );
+            if ( token == NULL )
+            {
+                fprintf( stderr, "[ERRO]: %s: soa needs a name\n", where );
+                exit(1);
+            }
+            types = add_type( types, token, inline_mode, where );
+            parse_soa( vec_back_gen_type( types ), where );
+            continue;
+        }
+        if ( strcmp( token, "map" ) == 0 )
+        {
+            types = parse_map( types, inline_mode, where );
+            continue;
+        }
+        types = add_type( types, token, inline_mode, where );
+        gen_type* type = vec_back_gen_type( types );
+        while ( ( token = strtok( NULL, " \t\r\n" ) ) != NULL )
+        {
+            if ( !parse_option( type, token ) )
+            {
+                fprintf( stderr, "[ERRO]: %s: unknown option '%s' for type '%s'\n", where, token, type->name );
+                exit(1);
+            }
+        }
+    }
+    fclose( file );
+    return types;
+}
+
 
 int main( int argc, char** argv )
 {
     if ( argc == 1 )
     {
-        fprintf( stderr, "[usage]: %s <types> [optional... output name]\n", argv[0] );
+        fprintf( stderr, "[usage]: %s [-m manifest] <types> [optional... output name]\n", argv[0] );
         exit(1);
     }
 
-    cstr* types = vec_new_cstr( 0, (cstr) { 0 } );
+    gen_type* types = vec_new_gen_type( 0, (gen_type) { 0 } );
+    cstr* includes = vec_new_cstr( 0, (cstr) { 0 } );
+    cstr* manifests = vec_new_cstr( 0, (cstr) { 0 } );
     cstr target = { .length = 3, .cstr = "vec" };
-    
+    bool inline_mode = false;
+
     for ( int i = 1; i < argc; i++ )
     {
         char* curr = argv[i];
         if ( curr[0] != '-' )
         {
-            vec_push_back_cstr( types, (cstr) { .length = strlen(curr), .cstr = curr } );
+            types = add_type( types, curr, false, "command line" );
             continue;
         }
-        if ( curr[1] == 'o' )
+        if ( curr[1] == 'o' || curr[1] == 'm' )
         {
+            char flag = curr[1];
             curr = argv[++i];
-            if ( curr != NULL )
+            if ( curr == NULL )
             {
-                target.length = strlen( curr );
-                target.cstr = curr;
-                continue;
+                fprintf( stderr, "[ERRO]: -%c given without a file name\n", flag );
+                exit(1);
             }
-            fprintf( stderr, "fatel error: output file flag specified but no file name given\n" );
-            vec_destroy_cstr( types );
-            exit(1);
+            if ( flag == 'o' ) target = (cstr) { .length = strlen( curr ), .cstr = curr };
+            else manifests = vec_push_back_cstr( manifests, (cstr) { .length = strlen( curr ), .cstr = curr } );
+            continue;
+        }
+        if ( curr[1] == 'i' )
+        {
+            inline_mode = true;
+            continue;
         }
         if ( curr[1] == 'h' )
         {
-            curr++;
             // print man page
-            fprintf( stderr, "[usage]: ./%s <type>\n", argv[0] );
+            fprintf( stderr, "[usage]: %s [-m manifest] <types> [-o name] [-i]\n", argv[0] );
+            fprintf( stderr, "    writes name.h with the declarations and _Generic wrappers of every type,\n" );
+            fprintf( stderr, "    and name_<type>.c with the definitions of one type, files whose content\n" );
+            fprintf( stderr, "    did not change are left alone, the .c files are listed on stdout\n" );
             fprintf( stderr, "    optional arguments:\n" );
             fprintf( stderr, "          -h          print this manual\n" );
-            fprintf( stderr, "          -o          specify output file name, will generage \"*.c\" and \"*.h\" file. \n" );
-            vec_destroy_cstr( types );
+            fprintf( stderr, "          -o          output name, default \"vec\"\n" );
+            fprintf( stderr, "          -m          read types and their options from a manifest file, see vec_gen.c\n" );
+            fprintf( stderr, "          -i          inline accessors and push/pop fast paths into the header, for every type\n" );
+            fprintf( stderr, "                      that does not say extern in the manifest\n" );
             exit(0);
         }
+        fprintf( stderr, "[ERRO]: unknown flag '%s', see -h\n", curr );
+        exit(1);
     }
-    char* file_c = malloc( target.length + 3 );
-    char* file_h = malloc( target.length + 3 );
-    strcpy( file_c, target.cstr );
-    strcat( file_c, ".c" );
-    strcpy( file_h, target.cstr );
-    strcat( file_h, ".h" );
-    
-    FILE* fpc = fopen( file_c, "w+" );
-    FILE* fph = fopen( file_h, "w+" );
-
-    free( file_c );
-    free( file_h );
-
-    size_t size = vec_size_cstr( types );
-
-    // include header .h
-    fprintf( fph, "#include \"vector.h\"\n\n" );
-
-    // include header .c
-    fprintf( fpc, "#define VECTOR_IMPLEMENTATION\n" );
-    fprintf( fpc, "#include \"vector.h\"\n\n" );
-
-
-    // add using types
-    for ( size_t i = 0; i < size; i++ )
+    if ( inline_mode )
     {
-        fprintf( fph, "using_vector(%s)\n", types[i].cstr );
-        fprintf( fpc, "using_vector(%s)\n", types[i].cstr );
-        // printf( "%s\n", types[i].cstr );
+        for ( size_t i = 0; i < vec_size_gen_type( types ); i++ ) types[i].inline_mode = true;
     }
-    fprintf( fph, "\n" ); 
-
-
-    // add macros for .h file
-
-    // T* vec_resize( T* self, size_t size, T val );
-    fprintf( fph, "// T* vec_resize( T* self, size_t size, T val );\n" );
-    fprintf( fph, "#define vec_resize( self, size, val ) _Generic( (self), \\\n" );
-    for ( size_t i = 0; i < size - 1; i++ )
+    for ( size_t i = 0; i < vec_size_cstr( manifests ); i++ )
     {
-        fprintf( fph, "    %s*: vec_resize_%s, \\\n", types[i].cstr, types[i].cstr );
+        types = read_manifest( types, &includes, manifests[i].cstr, inline_mode );
     }
-    fprintf( fph, "    %s*: vec_resize_%s \\\n", types[size-1].cstr, types[size-1].cstr );
-    fprintf( fph, ")( self, size, val ) \\\n\n" );
 
-    // T* vec_clear( T* self );
-    fprintf( fph, "// T* vec_clear( T* self );\n" );
-    fprintf( fph, "#define vec_clear( self ) _Generic( (self), \\\n" );
-    for ( size_t i = 0; i < size - 1; i++ )
+    size_t size = vec_size_gen_type( types );
+    if ( size == 0 )
     {
-        fprintf( fph, "    %s*: vec_clear_%s, \\\n", types[i].cstr, types[i].cstr );
+        fprintf( stderr, "[ERRO]: no types given\n" );
+        exit(1);
     }
-    fprintf( fph, "    %s*: vec_clear_%s \\\n", types[size-1].cstr, types[size-1].cstr );
-    fprintf( fph, ")( self ) \\\n\n" );
-
-    // T* vec_assign( T* self, size_t size, T val );
-    fprintf( fph, "// T* vec_assign( T* self, size_t size, T val );\n" );
-    fprintf( fph, "#define vec_assign( self, size, val ) _Generic( (self), \\\n" );
-    for ( size_t i = 0; i < size - 1; i++ )
+    bool numeric = false, sorted = false, soa = false, map = false;
+    for ( size_t i = 0; i < size; i++ )
     {
-        fprintf( fph, "    %s*: vec_assign_%s, \\\n", types[i].cstr, types[i].cstr );
+        numeric |= types[i].numeric;
+        sorted |= types[i].less != NULL || types[i].radix != NULL;
+        soa |= types[i].soa != NULL;
+        map |= types[i].map != NULL;
     }
-    fprintf( fph, "    %s*: vec_assign_%s \\\n", types[size-1].cstr, types[size-1].cstr );
-    fprintf( fph, ")( self, size, val ) \\\n\n" );
 
-    // T* vec_back( T* self );
-    fprintf( fph, "// T* vec_back( T* self );\n" );
-    fprintf( fph, "#define vec_back( self ) _Generic( (self), \\\n" );
-    for ( size_t i = 0; i < size - 1; i++ )
-    {
-        fprintf( fph, "    %s*: vec_back_%s, \\\n", types[i].cstr, types[i].cstr );
-    }
-    fprintf( fph, "    %s*: vec_back_%s \\\n", types[size-1].cstr, types[size-1].cstr );
-    fprintf( fph, ")( self ) \\\n\n" );
+    char* path = malloc( target.length + 4 );
+    strcpy( path, target.cstr );
+    strcat( path, ".h" );
+    char* out = vec_new_char( 0, 0 );
 
-    // T* vec_shrink_to_fit( T* self );
-    fprintf( fph, "// T* vec_shrink_to_fit( T* self );\n" );
-    fprintf( fph, "#define vec_shrink_to_fit( self ) _Generic( (self), \\\n" );
-    for ( size_t i = 0; i < size - 1; i++ )
+    // the header: every declaration and the _Generic wrappers
+    out = emit( out, "// generated by vec_gen, do not edit\n" );
+    char* guard = copy_str( target.cstr );
+    for ( char* c = guard; *c; c++ )
     {
-        fprintf( fph, "    %s*: vec_shrink_to_fit_%s, \\\n", types[i].cstr, types[i].cstr );
+        *c = isalnum( (unsigned char) *c ) ? (char) toupper( (unsigned char) *c ) : '_';
     }
-    fprintf( fph, "    %s*: vec_shrink_to_fit_%s \\\n", types[size-1].cstr, types[size-1].cstr );
-    fprintf( fph, ")( self ) \\\n\n" );
-
-    // T* vec_reserve( T* self, size_t size );
-    fprintf( fph, "// T* vec_reserve( T* self, size_t size );\n" );
-    fprintf( fph, "#define vec_reserve( self, size ) _Generic( (self), \\\n" );
-    for ( size_t i = 0; i < size - 1; i++ )
+    out = emit( out, "#ifndef __VEC_GEN_%s_H__\n#define __VEC_GEN_%s_H__\n\n", guard, guard );
+    free( guard );
+    out = emit_includes( out, includes, numeric, sorted, soa, map );
+    for ( size_t i = 0; i < size; i++ )
     {
-        fprintf( fph, "    %s*: vec_reserve_%s, \\\n", types[i].cstr, types[i].cstr );
+        out = emit_using( out, &types[i] );
     }
-    fprintf( fph, "    %s*: vec_reserve_%s \\\n", types[size-1].cstr, types[size-1].cstr );
-    fprintf( fph, ")( self, size ) \\\n\n" );
+    out = emit( out, "\n" );
 
-    // T* vec_insert( T* self, size_t position, T val );
-    fprintf( fph, "// T* vec_insert( T* self, size_t position, T val );\n" );
-    fprintf( fph, "#define vec_insert( self, position, val ) _Generic( (self), \\\n" );
-    for ( size_t i = 0; i < size - 1; i++ )
+    // types with a manifest allocator get their vec_new / vec_try_new through these
+    for ( size_t i = 0; i < size; i++ )
     {
-        fprintf( fph, "    %s*: vec_insert_%s, \\\n", types[i].cstr, types[i].cstr );
+        if ( types[i].alloc == NULL ) continue;
+        const char* T = types[i].name;
+        const char* row = types[i].soa ? "_row" : "";
+        out = emit( out, "static inline %s* vec_new_%s_alloc_( size_t size, %s%s val )\n{\n", T, T, T, row );
+        out = emit( out, "    return vec_new_with_alloc_%s( size, val, %s );\n}\n", T, types[i].alloc );
+        out = emit( out, "static inline int vec_try_new_%s_alloc_( %s** self, size_t size, %s%s val )\n{\n",
+                    T, T, T, row );
+        out = emit( out, "    return vec_try_new_with_alloc_%s( self, size, val, %s );\n}\n\n", T, types[i].alloc );
     }
-    fprintf( fph, "    %s*: vec_insert_%s \\\n", types[size-1].cstr, types[size-1].cstr );
-    fprintf( fph, ")( self, position, val ) \\\n\n" );
-
-    // T* vec_append( T* self, T val );
-    fprintf( fph, "// T* vec_append( T* self, T val );\n" );
-    fprintf( fph, "#define vec_append( self, val ) vec_push_back( self, val )\n" );
 
-    // T* vec_push_back( T* self, T val );
-    fprintf( fph, "// T* vec_push_back( T* self, T val );\n" );
-    fprintf( fph, "#define vec_push_back( self, val ) _Generic( (self), \\\n" );
-    for ( size_t i = 0; i < size - 1; i++ )
+    for ( size_t i = 0; i < sizeof ( ops ) / sizeof ( ops[0] ); i++ )
     {
-        fprintf( fph, "    %s*: vec_push_back_%s, \\\n", types[i].cstr, types[i].cstr );
+        out = emit_dispatch( out, &ops[i], types );
+        if ( strcmp( ops[i].name, "vec_truncate" ) == 0 )
+        {
+            out = emit( out, "// T* vec_append( T* self, T val );\n" );
+            out = emit( out, "#define vec_append( self, val ) vec_push_back( self, val )\n\n" );
+        }
+        if ( strcmp( ops[i].name, "vec_capacity" ) == 0 )
+        {
+            out = emit( out, "// void vec_free( T* self );\n" );
+            out = emit( out, "#define vec_free( self ) vec_destroy( self )\n\n" );
+        }
     }
-    fprintf( fph, "    %s*: vec_push_back_%s \\\n", types[size-1].cstr, types[size-1].cstr );
-    fprintf( fph, ")( self, val ) \\\n\n" );
+    out = emit( out, "#endif\n" );
 
-    // T* vec_pop_back( T* self );
-    fprintf( fph, "// T* vec_pop_back( T* self );\n" );
-    fprintf( fph, "#define vec_pop_back( self ) _Generic( (self), \\\n" );
-    for ( size_t i = 0; i < size - 1; i++ )
+    int status = 0;
+    if ( !write_if_changed( path, out, vec_size_char( out ) ) )
     {
-        fprintf( fph, "    %s*: vec_pop_back_%s, \\\n", types[i].cstr, types[i].cstr );
+        perror( path );
+        status = 1;
     }
-    fprintf( fph, "    %s*: vec_pop_back_%s \\\n", types[size-1].cstr, types[size-1].cstr );
-    fprintf( fph, ")( self ) \\\n\n" );
 
-    // size_t vec_size( T* self );
-    fprintf( fph, "// size_t vec_size( T* self );\n" );
-    fprintf( fph, "#define vec_size( self ) _Generic( (self), \\\n" );
-    for ( size_t i = 0; i < size - 1; i++ )
+    // one .c per type, so a change to one type only rebuilds that type
+    for ( size_t i = 0; i < size; i++ )
     {
-        fprintf( fph, "    %s*: vec_size_%s, \\\n", types[i].cstr, types[i].cstr );
+        free( path );
+        path = malloc( target.length + strlen( types[i].name ) + 4 );
+        sprintf( path, "%s_%s.c", target.cstr, types[i].name );
+        out = vec_clear_char( out );
+        out = emit( out, "// generated by vec_gen, do not edit\n" );
+        out = emit( out, "#define VECTOR_IMPLEMENTATION\n" );
+        out = emit_includes( out, includes, types[i].numeric, types[i].less || types[i].radix, types[i].soa,
+                             types[i].map );
+        out = emit_using( out, &types[i] );
+        if ( !write_if_changed( path, out, vec_size_char( out ) ) )
+        {
+            perror( path );
+            status = 1;
+            continue;
+        }
+        printf( "%s\n", path );
     }
-    fprintf( fph, "    %s*: vec_size_%s \\\n", types[size-1].cstr, types[size-1].cstr );
-    fprintf( fph, ")( self ) \\\n\n" );
 
-    // size_t vec_capacity( T* self );
-    fprintf( fph, "// size_t vec_capacity( T* self );\n" );
-    fprintf( fph, "#define vec_capacity( self ) _Generic( (self), \\\n" );
-    for ( size_t i = 0; i < size - 1; i++ )
+    free( path );
+    vec_destroy_char( out );
+    for ( size_t i = 0; i < size; i++ )
     {
-        fprintf( fph, "    %s*: vec_capacity_%s, \\\n", types[i].cstr, types[i].cstr );
+        free( types[i].name );
+        free( types[i].align );
+        free( types[i].alloc );
+        free( types[i].policy );
+        free( types[i].less );
+        free( types[i].radix );
+        free( types[i].soa );
+        free( types[i].map );
     }
-    fprintf( fph, "    %s*: vec_capacity_%s \\\n", types[size-1].cstr, types[size-1].cstr );
-    fprintf( fph, ")( self ) \\\n\n" );
+    vec_destroy_gen_type( types );
+    for ( size_t i = 0; i < vec_size_cstr( includes ); i++ ) free( includes[i].cstr );
+    vec_destroy_cstr( includes );
+    vec_destroy_cstr( manifests );
 
+    return status;
+}
 
-    // void vec_free( T* self );
-    fprintf( fph, "// void vec_free( T* self );\n" );
-    fprintf( fph, "#define vec_free( self ) vec_destroy( self )\n" );
-    // void vec_destroy( T* self );
-    fprintf( fph, "// void vec_destroy( T* self );\n" );
-    fprintf( fph, "#define vec_destroy( self ) _Generic( (self), \\\n" );
-    for ( size_t i = 0; i < size - 1; i++ )
-    {
-        fprintf( fph, "    %s*: vec_destroy_%s, \\\n", types[i].cstr, types[i].cstr );
-    }
-    fprintf( fph, "    %s*: vec_destroy_%s \\\n", types[size-1].cstr, types[size-1].cstr );
-    fprintf( fph, ")( self ) \\\n\n" );
 
+#if 0   // example manifest, `vec_gen -m vec.manifest -o vec` writes vec.h, vec_int.c, vec_double.c,
+// vec_point.c and vec_particles.c
 
-    fclose( fpc );
-    fclose( fph );
-    vec_destroy_cstr( types );
+# vec.manifest
+include "point.h"                   # typedef struct point { int x, y; } point; and point_pool
+int     inline sort radix=VEC_KEY_I32
+double  aligned=64 sort
+point   alloc=&point_pool.allocator policy=vec_growth_2x
+soa particles float:x float:y float:mass int:id
+map uint64_t double
 
-    return 0;
+// vec.h
+#include "vector.h"
+#include "vec_simd.h"
+#include "vec_sort.h"
+#include "vec_soa.h"
+#include "point.h"
+
+using_vector_ex( int, VEC_GROWTH_DEFAULT, VEC_HEADER_ALIGN, inline )
+using_vector_numeric( int )
+using_vector_sort( int, VEC_LESS )
+using_vector_radix( int, VEC_KEY_I32 )
+using_vector_ex( double, VEC_GROWTH_DEFAULT, 64, extern )
+using_vector_numeric( double )
+using_vector_sort( double, VEC_LESS )
+using_vector_ex( point, vec_growth_2x, VEC_HEADER_ALIGN, extern )
+using_soa_vector( particles, ( float, x ), ( float, y ), ( float, mass ), ( int, id ) )
+
+static inline point* vec_new_point_alloc_( size_t size, point val )
+{
+    return vec_new_with_alloc_point( size, val, &point_pool.allocator );
 }
 
+// T* vec_new( size_t size, T val );
+// dispatches on the type of val, cast it to the element type
+#define vec_new( size, val ) _Generic( (val),                                                               \
+    int: vec_new_int,                                                                                       \
+    double: vec_new_double,                                                                                 \
+    point: vec_new_point_alloc_,                                                                            \
+    particles_row: vec_new_particles                                                                        \
+)( size, val )                                                                                              \
+
+// T* vec_sort( T* self );
+#define vec_sort( self ) _Generic( (self),                                                                  \
+    int*: vec_sort_int,                                                                                     \
+    double*: vec_sort_double                                                                                \
+)( self )                                                                                                   \
+
+// vec_double.c
+#define VECTOR_IMPLEMENTATION
+#include "vector.h"
+#include "vec_simd.h"
+#include "vec_sort.h"
+#include "point.h"
 
-#if 0   // example output file
-
-using_vector(int)
-using_vector(char)
-using_vector(double)
-
-#define vec_resize( self, size, val ) _Generic( (self),                                                     \
-    int*:       vec_resize_int,                                                                             \
-    char*:      vec_resize_char,                                                                            \
-    double*:    vec_resize_double                                                                           \
-) ( self, size, val )                                                                                       \
-
-#define vec_clear( self ) _Generic( (self),                                                                 \
-    int*:       vec_clear_int,                                                                              \
-    char*:      vec_clear_char,                                                                             \
-    double*:    vec_clear_double                                                                            \
-) ( self )                                                                                                  \
-
-#define vec_assign( self, size, val ) _Generic( (self),                                                     \
-    int*:       vec_assign_int,                                                                             \
-    char*:      vec_assign_char,                                                                            \
-    double*:    vec_assign_double                                                                           \
-) ( self, size, val )                                                                                       \
-
-#define vec_back( self ) _Generic( (self),                                                                  \
-    int*:       vec_back_int,                                                                               \
-    char*:      vec_back_char,                                                                              \
-    double*:    vec_back_double                                                                             \
-) ( self, size, val )                                                                                       \
-
-#define vec_shrink_to_fit( self ) _Generic( (self),                                                         \
-    int*:       vec_shrink_to_fit_int,                                                                      \
-    char*:      vec_shrink_to_fit_char,                                                                     \
-    double*:    vec_shrink_to_fit_double                                                                    \
-) ( self )                                                                                                  \
-
-#define vec_reserve( self, size ) _Generic( (self),                                                         \
-    int*:       vec_reserve_int,                                                                            \
-    char*:      vec_reserve_char,                                                                           \
-    double*:    vec_reserve_double                                                                          \
-) ( self, size )                                                                                            \
-
-#define vec_insert( self, position, val ) _Generic( (self),                                                 \
-    int*:       vec_insert_int,                                                                             \
-    char*:      vec_insert_char,                                                                            \
-    double*:    vec_insert_double                                                                           \
-) ( self, position, val )                                                                                   \
-
-#define vec_insert_arr( self, position, arr, size ) _Generic( (self),                                       \
-    int*:       vec_insert_arr_int,                                                                         \
-    char*:      vec_insert_arr_char,                                                                        \
-    double*:    vec_insert_arr_double                                                                       \
-) ( self, position, arr, size )                                                                             \
-
-#define vec_append( self, val ) vec_push_back( self, val )
-#define vec_push_back( self, val ) _Generic( (self),                                                        \
-    int*:       vec_push_back_int,                                                                          \
-    char*:      vec_push_back_char,                                                                         \
-    double*:    vec_push_back_double                                                                        \
-) ( self, val )                                                                                             \
-
-#define vec_pop_back( self ) _Generic( (self),                                                              \
-    int*:       vec_pop_back_int,                                                                           \
-    char*:      vec_pop_back_char,                                                                          \
-    double*:    vec_pop_back_double                                                                         \
-) ( self )                                                                                                  \
-
-#define vec_size( self ) _Generic( (self),                                                                  \
-    int*:       vec_size_int,                                                                               \
-    char*:      vec_size_char,                                                                              \
-    double*:    vec_size_double                                                                             \
-) ( self )                                                                                                  \
-
-#define vec_capacity( self ) _Generic( (self),                                                              \
-    int*:       vec_capacity_int,                                                                           \
-    char*:      vec_capacity_char,                                                                          \
-    double*:    vec_capacity_double                                                                         \
-) ( self )                                                                                                  \
-
-#define vec_destroy( self ) _Generic( (self),                                                               \
-    int*:       vec_destroy_int,                                                                            \
-    char*:      vec_destroy_char,                                                                           \
-    double*:    vec_destroy_double                                                                          \
-) ( self )                                                                                                  \
+using_vector_ex( double, VEC_GROWTH_DEFAULT, 64, extern )
+using_vector_numeric( double )
+using_vector_sort( double, VEC_LESS )
 
 #endif  // example
@@ -0,0 +1,411 @@
+#ifndef __VEC_MAP_H__
+#define __VEC_MAP_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "vector.h"
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#include <emmintrin.h>
+#endif
+
+
+// open-addressing hash map in one block: a vec_meta header, one control byte per slot and the key/value slots
+// a control byte is VEC_MAP_EMPTY or the low 7 bits of the key's hash, lookups compare 16 control bytes at a
+// time ( SSE2, or two 64-bit words elsewhere ) and only look at the slots whose byte matches
+// probing is linear from the slot picked by the top bits of the hash, so a key always sits between its home
+// slot and the next empty one, which lets remove shift the following entries back instead of leaving
+// tombstones, the table never fills up with deleted slots and never needs a cleanup rehash
+// `using_flat_map( K, V, HASH, EQ )` needs HASH( key ) to return an integer hash, VEC_HASH for integer keys,
+// and EQ( a, b ) to be true for equal keys, VEC_EQ for anything == compares, both may be macros or functions
+// K and V have to be identifiers, the map is vec_map_K_V and its functions vec_map_*_K_V
+#define VEC_MAP_GROUP 16
+#define VEC_MAP_EMPTY ( (uint8_t) 0x80 )
+
+#ifndef VEC_MAP_MAX_LOAD
+#define VEC_MAP_MAX_LOAD 7              // eighths of the slots in use before the table doubles
+#endif
+#ifndef VEC_MAP_BATCH
+#define VEC_MAP_BATCH 16                // keys hashed and prefetched ahead by vec_map_get_batch
+#endif
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define VEC_MAP_PREFETCH( addr ) __builtin_prefetch( addr )
+#define VEC_MAP_CTZ( x ) ( (unsigned) __builtin_ctz( x ) )
+#else
+#define VEC_MAP_PREFETCH( addr ) ( (void) ( addr ) )
+#define VEC_MAP_CTZ( x ) vec_map_ctz_( x )
+static inline unsigned vec_map_ctz_( uint32_t x )
+{
+    unsigned r = 0;
+    while ( !( x & 1 ) ) { x >>= 1; r++; }
+    return r;
+}
+#endif
+
+#define VEC_EQ( a, b ) ( (a) == (b) )
+#define VEC_HASH( key ) ( (uint64_t) ( key ) )
+
+// spread the hash over all 64 bits, the slot comes from the top bits and the control byte from the low ones
+static inline uint64_t vec_map_mix_( uint64_t hash )
+{
+    hash ^= hash >> 32;
+    return hash * UINT64_C( 0x9E3779B97F4A7C15 );
+}
+
+// bit i set when control byte i of the group at ctrl equals h2
+static inline uint32_t vec_map_match_( const uint8_t* ctrl, uint8_t h2 )
+{
+#if defined( __SSE2__ ) || defined( _M_X64 )
+    __m128i group = _mm_loadu_si128( (const __m128i*) ctrl );
+    return (uint32_t) _mm_movemask_epi8( _mm_cmpeq_epi8( group, _mm_set1_epi8( (char) h2 ) ) );
+#else
+    uint32_t mask = 0;
+    for ( int half = 0; half < 2; half++ )
+    {
+        uint64_t word;
+        memcpy( &word, ctrl + 8 * half, 8 );
+        word ^= UINT64_C( 0x0101010101010101 ) * h2;
+        /* high bit of every zero byte, the byte above a zero byte may be flagged too, the key compare drops it */
+        uint64_t zero = ( word - UINT64_C( 0x0101010101010101 ) ) & ~word & UINT64_C( 0x8080808080808080 );
+        mask |= (uint32_t) ( ( ( zero >> 7 ) * UINT64_C( 0x0102040810204080 ) ) >> 56 ) << ( 8 * half );
+    }
+    return mask;
+#endif
+}
+
+// bit i set when control byte i of the group at ctrl is VEC_MAP_EMPTY
+static inline uint32_t vec_map_match_empty_( const uint8_t* ctrl )
+{
+#if defined( __SSE2__ ) || defined( _M_X64 )
+    return (uint32_t) _mm_movemask_epi8( _mm_loadu_si128( (const __m128i*) ctrl ) );
+#else
+    uint32_t mask = 0;
+    for ( int half = 0; half < 2; half++ )
+    {
+        uint64_t word;
+        memcpy( &word, ctrl + 8 * half, 8 );
+        word &= UINT64_C( 0x8080808080808080 );
+        mask |= (uint32_t) ( ( ( word >> 7 ) * UINT64_C( 0x0102040810204080 ) ) >> 56 ) << ( 8 * half );
+    }
+    return mask;
+#endif
+}
+
+
+// the map struct and the lookups, the same in the declaration and the implementation
+#define vec_map_common_( K, V, HASH, EQ, N )                                                                \
+typedef struct vec_map_entry_##N                                                                            \
+{                                                                                                           \
+    K key;                                                                                                  \
+    V val;                                                                                                  \
+} vec_map_entry_##N;                                                                                        \
+typedef struct vec_map_##N                                                                                  \
+{                                                                                                           \
+    vec_meta meta;                  /* size is the number of keys, capacity the number of slots */          \
+    unsigned shift;                 /* 64 - log2( capacity ), the home slot is hash >> shift */             \
+    vec_map_entry_##N* slots;                                                                               \
+    uint8_t ctrl[];                 /* capacity bytes, then a copy of the first VEC_MAP_GROUP of them */    \
+} vec_map_##N;                                                                                              \
+/* Returns the number of keys in the map */                                                                 \
+static inline size_t vec_map_size_##N( vec_map_##N* self )                                                  \
+{                                                                                                           \
+    return self->meta.size;                                                                                 \
+}                                                                                                           \
+/* get the number of slots, a power of two */                                                               \
+static inline size_t vec_map_capacity_##N( vec_map_##N* self )                                              \
+{                                                                                                           \
+    return self->meta.capacity;                                                                             \
+}                                                                                                           \
+/* the slot holding key, whose mixed hash is hash, or SIZE_MAX */                                           \
+static inline size_t vec_map_find_##N( vec_map_##N* self, K key, uint64_t hash )                            \
+{                                                                                                           \
+    size_t mask = self->meta.capacity - 1;                                                                  \
+    size_t pos = (size_t) ( hash >> self->shift );                                                          \
+    uint8_t h2 = (uint8_t) ( hash & 0x7F );                                                                 \
+    for ( ;; )                                                                                              \
+    {                                                                                                       \
+        const uint8_t* group = &self->ctrl[ pos ];                                                          \
+        for ( uint32_t match = vec_map_match_( group, h2 ); match; match &= match - 1 )                     \
+        {                                                                                                   \
+            size_t slot = ( pos + VEC_MAP_CTZ( match ) ) & mask;                                            \
+            if ( VEC_LIKELY( EQ( self->slots[ slot ].key, key ) ) ) return slot;                            \
+        }                                                                                                   \
+        if ( VEC_LIKELY( vec_map_match_empty_( group ) ) ) return SIZE_MAX;                                 \
+        pos = ( pos + VEC_MAP_GROUP ) & mask;                                                               \
+    }                                                                                                       \
+}                                                                                                           \
+/* get the reference of the value of key, NULL when the key is not in the map */                            \
+/* the reference stays valid until the next put or remove */                                                \
+static inline V* vec_map_get_##N( vec_map_##N* self, K key )                                                \
+{                                                                                                           \
+    size_t slot = vec_map_find_##N( self, key, vec_map_mix_( (uint64_t) HASH( key ) ) );                    \
+    return slot == SIZE_MAX ? NULL : &self->slots[ slot ].val;                                              \
+}                                                                                                           \
+static inline bool vec_map_contains_##N( vec_map_##N* self, K key )                                         \
+{                                                                                                           \
+    return vec_map_get_##N( self, key ) != NULL;                                                            \
+}                                                                                                           \
+
+
+// generate the map from K to V
+#ifndef VECTOR_IMPLEMENTATION
+#define using_flat_map( K, V, HASH, EQ ) vec_map_declare_( K, V, HASH, EQ, K##_##V )
+#define vec_map_declare_( K, V, HASH, EQ, N )                                                               \
+vec_map_common_( K, V, HASH, EQ, N )                                                                        \
+vec_map_##N* vec_map_new_##N( size_t size );                                                                \
+vec_map_##N* vec_map_new_with_alloc_##N( size_t size, const vec_allocator* alloc );                         \
+vec_map_##N* vec_map_put_##N( vec_map_##N* self, K key, V val );                                            \
+bool vec_map_remove_##N( vec_map_##N* self, K key );                                                        \
+vec_map_##N* vec_map_reserve_##N( vec_map_##N* self, size_t size );                                         \
+vec_map_##N* vec_map_rehash_##N( vec_map_##N* self, size_t size );                                          \
+size_t vec_map_get_batch_##N( vec_map_##N* self, const K* keys, size_t size, V** out );                     \
+vec_map_entry_##N* vec_map_next_##N( vec_map_##N* self, size_t* iter );                                     \
+void vec_map_clear_##N( vec_map_##N* self );                                                                \
+void vec_map_destroy_##N( vec_map_##N* self );                                                              \
+int vec_map_try_new_##N( vec_map_##N** self, size_t size );                                                 \
+int vec_map_try_new_with_alloc_##N( vec_map_##N** self, size_t size, const vec_allocator* alloc );          \
+int vec_map_try_put_##N( vec_map_##N** self, K key, V val );                                                \
+int vec_map_try_reserve_##N( vec_map_##N** self, size_t size );                                             \
+int vec_map_try_rehash_##N( vec_map_##N** self, size_t size );                                              \
+
+#endif  // VECTOR_IMPLEMENTATION
+#endif  // __VEC_MAP_H__
+
+
+#ifdef VECTOR_IMPLEMENTATION
+#define using_flat_map( K, V, HASH, EQ ) vec_map_define_( K, V, HASH, EQ, K##_##V )
+#define vec_map_define_( K, V, HASH, EQ, N )                                                                \
+vec_map_common_( K, V, HASH, EQ, N )                                                                        \
+static inline size_t vec_map_align_##N( void )                                                              \
+{                                                                                                           \
+    return VEC_ALIGNMENT( _Alignof( vec_map_entry_##N ) );                                                  \
+}                                                                                                           \
+/* offset of the slots in a block of capacity slots, after the header and the control bytes */              \
+static inline size_t vec_map_slots_at_##N( size_t capacity )                                                \
+{                                                                                                           \
+    size_t align = vec_map_align_##N();                                                                     \
+    return ( sizeof ( vec_map_##N ) + capacity + VEC_MAP_GROUP + align - 1 ) / align * align;               \
+}                                                                                                           \
+static inline size_t vec_map_bytes_##N( size_t capacity )                                                   \
+{                                                                                                           \
+    return vec_map_slots_at_##N( capacity ) + capacity * sizeof ( vec_map_entry_##N );                      \
+}                                                                                                           \
+/* slots needed to hold size keys under the load limit, a power of two, 0 when too large */                 \
+static inline size_t vec_map_slots_for_##N( size_t size )                                                   \
+{                                                                                                           \
+    size_t capacity = VEC_MAP_GROUP;                                                                        \
+    while ( capacity / 8 * VEC_MAP_MAX_LOAD < size )                                                        \
+    {                                                                                                       \
+        if ( capacity > SIZE_MAX / 4 / sizeof ( vec_map_entry_##N ) ) return 0;                             \
+        capacity *= 2;                                                                                      \
+    }                                                                                                       \
+    return capacity;                                                                                        \
+}                                                                                                           \
+static inline void vec_map_set_ctrl_##N( vec_map_##N* self, size_t slot, uint8_t ctrl )                     \
+{                                                                                                           \
+    self->ctrl[ slot ] = ctrl;                                                                              \
+    if ( slot < VEC_MAP_GROUP ) self->ctrl[ self->meta.capacity + slot ] = ctrl;                            \
+}                                                                                                           \
+/* an empty table of capacity slots */                                                                      \
+static vec_map_##N* vec_map_alloc_##N( size_t capacity, const vec_allocator* alloc )                        \
+{                                                                                                           \
+    vec_map_##N* map = vec_mem_alloc( alloc, vec_map_bytes_##N( capacity ), vec_map_align_##N() );          \
+    if ( VEC_UNLIKELY( map == NULL ) ) return NULL;                                                         \
+    map->meta = (vec_meta) { .size = 0, .capacity = capacity, .alloc = alloc, .flags = 0 };                 \
+    map->shift = 64;                                                                                        \
+    for ( size_t c = capacity; c > 1; c >>= 1 ) map->shift--;                                               \
+    map->slots = (vec_map_entry_##N*) ( (char*) map + vec_map_slots_at_##N( capacity ) );                   \
+    memset( map->ctrl, VEC_MAP_EMPTY, capacity + VEC_MAP_GROUP );                                           \
+    return map;                                                                                             \
+}                                                                                                           \
+/* the first empty slot at or after the home slot of hash, there always is one under the load limit */      \
+static inline size_t vec_map_find_empty_##N( vec_map_##N* self, uint64_t hash )                             \
+{                                                                                                           \
+    size_t mask = self->meta.capacity - 1;                                                                  \
+    size_t pos = (size_t) ( hash >> self->shift );                                                          \
+    uint32_t empty;                                                                                         \
+    while ( ( empty = vec_map_match_empty_( &self->ctrl[ pos ] ) ) == 0 )                                   \
+    {                                                                                                       \
+        pos = ( pos + VEC_MAP_GROUP ) & mask;                                                               \
+    }                                                                                                       \
+    return ( pos + VEC_MAP_CTZ( empty ) ) & mask;                                                           \
+}                                                                                                           \
+/* move every entry of self into a table of capacity slots, self is freed, NULL and untouched on failure */ \
+static vec_map_##N* vec_map_move_##N( vec_map_##N* self, size_t capacity )                                  \
+{                                                                                                           \
+    vec_map_##N* map = vec_map_alloc_##N( capacity, self->meta.alloc );                                     \
+    if ( VEC_UNLIKELY( map == NULL ) ) return NULL;                                                         \
+    for ( size_t i = 0; i < self->meta.capacity; i++ )                                                      \
+    {                                                                                                       \
+        if ( self->ctrl[i] == VEC_MAP_EMPTY ) continue;                                                     \
+        uint64_t hash = vec_map_mix_( (uint64_t) HASH( self->slots[i].key ) );                              \
+        size_t slot = vec_map_find_empty_##N( map, hash );                                                  \
+        vec_map_set_ctrl_##N( map, slot, (uint8_t) ( hash & 0x7F ) );                                       \
+        map->slots[ slot ] = self->slots[i];                                                                \
+    }                                                                                                       \
+    map->meta.size = self->meta.size;                                                                       \
+    vec_mem_free( self->meta.alloc, self, vec_map_bytes_##N( self->meta.capacity ), vec_map_align_##N() );  \
+    return map;                                                                                             \
+}                                                                                                           \
+/* create a map with room for size keys, its memory comes from alloc ( NULL for malloc ) */                 \
+int vec_map_try_new_with_alloc_##N( vec_map_##N** self, size_t size, const vec_allocator* alloc )           \
+{                                                                                                           \
+    size_t capacity = vec_map_slots_for_##N( size );                                                        \
+    if ( VEC_UNLIKELY( capacity == 0 ) ) return VEC_ERR_NOMEM;                                              \
+    vec_map_##N* map = vec_map_alloc_##N( capacity, alloc );                                                \
+    if ( VEC_UNLIKELY( map == NULL ) ) return VEC_ERR_NOMEM;                                                \
+    *self = map;                                                                                            \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+vec_map_##N* vec_map_new_with_alloc_##N( size_t size, const vec_allocator* alloc )                          \
+{                                                                                                           \
+    vec_map_##N* self;                                                                                      \
+    int err = vec_map_try_new_with_alloc_##N( &self, size, alloc );                                         \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* create a map with room for size keys */                                                                  \
+int vec_map_try_new_##N( vec_map_##N** self, size_t size )                                                  \
+{                                                                                                           \
+    return vec_map_try_new_with_alloc_##N( self, size, NULL );                                              \
+}                                                                                                           \
+vec_map_##N* vec_map_new_##N( size_t size )                                                                 \
+{                                                                                                           \
+    return vec_map_new_with_alloc_##N( size, NULL );                                                        \
+}                                                                                                           \
+/* rebuild the table with room for size keys, or for the keys it holds when that is more */                 \
+/* a smaller table gives memory back, *self is untouched on failure */                                      \
+int vec_map_try_rehash_##N( vec_map_##N** self, size_t size )                                               \
+{                                                                                                           \
+    size_t capacity = vec_map_slots_for_##N( size > ( *self )->meta.size ? size : ( *self )->meta.size );   \
+    if ( VEC_UNLIKELY( capacity == 0 ) ) return VEC_ERR_NOMEM;                                              \
+    if ( capacity == ( *self )->meta.capacity ) return VEC_OK;                                              \
+    vec_map_##N* map = vec_map_move_##N( *self, capacity );                                                 \
+    if ( VEC_UNLIKELY( map == NULL ) ) return VEC_ERR_NOMEM;                                                \
+    *self = map;                                                                                            \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+vec_map_##N* vec_map_rehash_##N( vec_map_##N* self, size_t size )                                           \
+{                                                                                                           \
+    int err = vec_map_try_rehash_##N( &self, size );                                                        \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* make room for size keys without another rehash, never shrinks */                                         \
+int vec_map_try_reserve_##N( vec_map_##N** self, size_t size )                                              \
+{                                                                                                           \
+    if ( ( *self )->meta.capacity / 8 * VEC_MAP_MAX_LOAD >= size ) return VEC_OK;                           \
+    return vec_map_try_rehash_##N( self, size );                                                            \
+}                                                                                                           \
+vec_map_##N* vec_map_reserve_##N( vec_map_##N* self, size_t size )                                          \
+{                                                                                                           \
+    int err = vec_map_try_reserve_##N( &self, size );                                                       \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* set the value of key, adding the key when it is not in the map yet */                                    \
+/* VEC_ERR_NOMEM when the table had to grow and could not, *self is untouched then */                       \
+int vec_map_try_put_##N( vec_map_##N** self, K key, V val )                                                 \
+{                                                                                                           \
+    vec_map_##N* map = *self;                                                                               \
+    uint64_t hash = vec_map_mix_( (uint64_t) HASH( key ) );                                                 \
+    size_t slot = vec_map_find_##N( map, key, hash );                                                       \
+    if ( slot != SIZE_MAX )                                                                                 \
+    {                                                                                                       \
+        map->slots[ slot ].val = val;                                                                       \
+        return VEC_OK;                                                                                      \
+    }                                                                                                       \
+    if ( VEC_UNLIKELY( map->meta.size >= map->meta.capacity / 8 * VEC_MAP_MAX_LOAD ) )                      \
+    {                                                                                                       \
+        int err = vec_map_try_rehash_##N( &map, map->meta.size + 1 );                                       \
+        if ( VEC_UNLIKELY( err ) ) return err;                                                              \
+    }                                                                                                       \
+    slot = vec_map_find_empty_##N( map, hash );                                                             \
+    vec_map_set_ctrl_##N( map, slot, (uint8_t) ( hash & 0x7F ) );                                           \
+    map->slots[ slot ] = (vec_map_entry_##N) { key, val };                                                  \
+    map->meta.size++;                                                                                       \
+    *self = map;                                                                                            \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+vec_map_##N* vec_map_put_##N( vec_map_##N* self, K key, V val )                                             \
+{                                                                                                           \
+    int err = vec_map_try_put_##N( &self, key, val );                                                       \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* remove key, false when it was not in the map */                                                          \
+/* backward-shift deletion: scan the probe run after the hole up to the next empty slot and move */         \
+/* back every entry whose home slot allows it into the hole, which then moves to that entry's old slot */   \
+bool vec_map_remove_##N( vec_map_##N* self, K key )                                                         \
+{                                                                                                           \
+    size_t hole = vec_map_find_##N( self, key, vec_map_mix_( (uint64_t) HASH( key ) ) );                    \
+    if ( hole == SIZE_MAX ) return false;                                                                   \
+    size_t mask = self->meta.capacity - 1;                                                                  \
+    for ( size_t next = ( hole + 1 ) & mask; self->ctrl[ next ] != VEC_MAP_EMPTY; next = ( next + 1 ) & mask ) \
+    {                                                                                                       \
+        /* the entry at next may fill the hole when the hole lies between its home slot and next */         \
+        uint64_t hash = vec_map_mix_( (uint64_t) HASH( self->slots[ next ].key ) );                         \
+        size_t home = (size_t) ( hash >> self->shift );                                                     \
+        if ( ( ( next - home ) & mask ) >= ( ( next - hole ) & mask ) )                                     \
+        {                                                                                                   \
+            self->slots[ hole ] = self->slots[ next ];                                                      \
+            vec_map_set_ctrl_##N( self, hole, self->ctrl[ next ] );                                         \
+            hole = next;                                                                                    \
+        }                                                                                                   \
+    }                                                                                                       \
+    vec_map_set_ctrl_##N( self, hole, VEC_MAP_EMPTY );                                                      \
+    self->meta.size--;                                                                                      \
+    return true;                                                                                            \
+}                                                                                                           \
+/* hash keys[i] and prefetch its home control bytes and slot, the hash goes to hashes[ i % VEC_MAP_BATCH ] */ \
+static inline void vec_map_prefetch_##N( vec_map_##N* self, const K* keys, size_t i, uint64_t* hashes )     \
+{                                                                                                           \
+    uint64_t hash = vec_map_mix_( (uint64_t) HASH( keys[i] ) );                                             \
+    size_t home = (size_t) ( hash >> self->shift );                                                         \
+    VEC_MAP_PREFETCH( &self->ctrl[ home ] );                                                                \
+    VEC_MAP_PREFETCH( &self->slots[ home ] );                                                               \
+    hashes[ i % VEC_MAP_BATCH ] = hash;                                                                     \
+}                                                                                                           \
+/* look up size keys, out[i] gets the reference of the value of keys[i] or NULL */                          \
+/* returns how many were found, key i + VEC_MAP_BATCH is hashed and prefetched while key i is probed, */    \
+/* so the cache misses of the batch overlap instead of adding up */                                         \
+size_t vec_map_get_batch_##N( vec_map_##N* self, const K* keys, size_t size, V** out )                      \
+{                                                                                                           \
+    uint64_t hashes[ VEC_MAP_BATCH ];                                                                       \
+    size_t found = 0;                                                                                       \
+    for ( size_t i = 0; i < size && i < VEC_MAP_BATCH; i++ ) vec_map_prefetch_##N( self, keys, i, hashes ); \
+    for ( size_t i = 0; i < size; i++ )                                                                     \
+    {                                                                                                       \
+        uint64_t hash = hashes[ i % VEC_MAP_BATCH ];                                                        \
+        if ( i + VEC_MAP_BATCH < size ) vec_map_prefetch_##N( self, keys, i + VEC_MAP_BATCH, hashes );      \
+        size_t slot = vec_map_find_##N( self, keys[i], hash );                                              \
+        out[i] = slot == SIZE_MAX ? NULL : &self->slots[ slot ].val;                                        \
+        found += slot != SIZE_MAX;                                                                          \
+    }                                                                                                       \
+    return found;                                                                                           \
+}                                                                                                           \
+/* walk the entries in slot order, start with *iter = 0, NULL once every entry was visited */               \
+/* no put or remove while walking, both can move entries to slots the walk already passed */                \
+vec_map_entry_##N* vec_map_next_##N( vec_map_##N* self, size_t* iter )                                      \
+{                                                                                                           \
+    while ( *iter < self->meta.capacity )                                                                   \
+    {                                                                                                       \
+        size_t slot = ( *iter )++;                                                                          \
+        if ( self->ctrl[ slot ] != VEC_MAP_EMPTY ) return &self->slots[ slot ];                             \
+    }                                                                                                       \
+    return NULL;                                                                                            \
+}                                                                                                           \
+/* remove every key, keeps the capacity */                                                                  \
+void vec_map_clear_##N( vec_map_##N* self )                                                                 \
+{                                                                                                           \
+    memset( self->ctrl, VEC_MAP_EMPTY, self->meta.capacity + VEC_MAP_GROUP );                               \
+    self->meta.size = 0;                                                                                    \
+}                                                                                                           \
+void vec_map_destroy_##N( vec_map_##N* self )                                                               \
+{                                                                                                           \
+    vec_mem_free( self->meta.alloc, self, vec_map_bytes_##N( self->meta.capacity ), vec_map_align_##N() );  \
+}                                                                                                           \
+
+#endif  // VECTOR_IMPLEMENTATION
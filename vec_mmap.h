@@ -0,0 +1,256 @@
+#ifndef __VEC_MMAP_H__
+#define __VEC_MMAP_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "vector.h"
+
+
+// vectors saved to and mapped from files
+// a file holds a vec_file_header, padding up to VEC_FILE_DATA_OFFSET and the elements, in native byte order
+// the vec_meta of a mapped vector sits in that padding right before the data, so the mapping is used in place
+// define _GNU_SOURCE before any include on Linux so writable maps grow with mremap instead of munmap + mmap
+#define VEC_FILE_MAGIC "VECFILE"
+#define VEC_FILE_VERSION 1
+#define VEC_FILE_DATA_OFFSET ( (size_t) 4096 )
+
+typedef struct vec_file_header
+{
+    char magic[8];              // VEC_FILE_MAGIC
+    uint32_t version;           // VEC_FILE_VERSION
+    uint32_t data_offset;       // VEC_FILE_DATA_OFFSET
+    uint64_t elem_size;         // sizeof ( T ) of the vector that was saved
+    uint64_t size;              // number of elements
+} vec_file_header;
+
+// how to map a file
+#define VEC_MAP_READ    0       // private copy-on-write map, zero-copy until written, changes never reach the file
+#define VEC_MAP_WRITE   1       // shared map, changes go to the file, growing grows the file
+#define VEC_MAP_CREATE  2       // with VEC_MAP_WRITE, start an empty vector file if there is none
+
+// the allocator of a mapped vector, one per mapping, it frees itself when the vector is destroyed
+typedef struct vec_mapping
+{
+    vec_allocator allocator;
+    char* base;                 // start of the mapping, NULL once a private map moved to the heap
+    size_t length;              // bytes mapped
+    int fd;                     // open for shared maps, -1 otherwise
+} vec_mapping;
+
+static inline vec_meta* vec_mapping_meta_( vec_mapping* map )
+{
+    return (vec_meta*) ( map->base + VEC_FILE_DATA_OFFSET - sizeof ( vec_meta ) );
+}
+
+// write the size back into the file header and flush the mapping
+static inline int vec_mapping_sync_( vec_mapping* map )
+{
+    ( (vec_file_header*) map->base )->size = vec_mapping_meta_( map )->size;
+    return msync( map->base, map->length, MS_SYNC ) == 0 ? VEC_OK : VEC_ERR_IO;
+}
+
+static inline void* vec_mapping_allocate_( void* ctx, size_t size, size_t align )
+{
+    // a mapping only ever backs the vector it was created for
+    (void) ctx;
+    (void) size;
+    (void) align;
+    return NULL;
+}
+
+static inline void* vec_mapping_reallocate_( void* ctx, void* ptr, size_t old_size, size_t new_size, size_t align )
+{
+    vec_mapping* map = ctx;
+    if ( map->base == NULL ) return vec_default_realloc( ptr, old_size, new_size, align );
+    if ( map->fd < 0 )
+    {
+        // private map, keep it while shrinking, copy to the heap once it has to grow
+        if ( new_size <= old_size ) return ptr;
+        void* p = vec_default_alloc( new_size, align );
+        if ( p == NULL ) return NULL;
+        memcpy( p, ptr, old_size );
+        munmap( map->base, map->length );
+        map->base = NULL;
+        map->length = 0;
+        return p;
+    }
+    // shared map, the file follows the capacity
+    size_t offset = (size_t) ( (char*) ptr - map->base );
+    size_t length = offset + new_size;
+    if ( length <= map->length ) return ptr;
+    if ( ftruncate( map->fd, (off_t) length ) != 0 ) return NULL;
+#if defined( __linux__ ) && defined( MREMAP_MAYMOVE )
+    char* base = mremap( map->base, map->length, length, MREMAP_MAYMOVE );
+    if ( base == MAP_FAILED ) return NULL;
+#else
+    char* base = mmap( NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, map->fd, 0 );
+    if ( base == MAP_FAILED ) return NULL;
+    munmap( map->base, map->length );
+#endif
+    map->base = base;
+    map->length = length;
+    return base + offset;
+}
+
+static inline void vec_mapping_deallocate_( void* ctx, void* ptr, size_t size, size_t align )
+{
+    vec_mapping* map = ctx;
+    (void) size;
+    (void) align;
+    if ( map->base == NULL ) free( ptr );
+    else if ( map->fd < 0 ) munmap( map->base, map->length );
+    else
+    {
+        // leave the file exactly as long as its elements
+        vec_meta* meta = vec_mapping_meta_( map );
+        size_t used = VEC_FILE_DATA_OFFSET + meta->size * ( (vec_file_header*) map->base )->elem_size;
+        vec_mapping_sync_( map );
+        munmap( map->base, map->length );
+        if ( ftruncate( map->fd, (off_t) used ) != 0 ) perror( "[WARN]: vector file" );
+        close( map->fd );
+    }
+    free( map );
+}
+
+// the mapping behind a vector's allocator, NULL if it is not a mapped vector
+static inline vec_mapping* vec_mapping_of_( const vec_allocator* alloc )
+{
+    if ( alloc == NULL || alloc->reallocate != vec_mapping_reallocate_ ) return NULL;
+    return alloc->ctx;
+}
+
+// map path as a vector file of elem_size elements aligned to align, the data starts at *data
+static inline int vec_mapping_open_( const char* path, int mode, size_t elem_size, size_t header_size,
+                                     char** data )
+{
+    bool write = mode & VEC_MAP_WRITE;
+    int fd = open( path, write ? ( O_RDWR | ( ( mode & VEC_MAP_CREATE ) ? O_CREAT : 0 ) ) : O_RDONLY, 0644 );
+    if ( fd < 0 ) return VEC_ERR_IO;
+    struct stat st;
+    if ( fstat( fd, &st ) != 0 )
+    {
+        close( fd );
+        return VEC_ERR_IO;
+    }
+    size_t length = (size_t) st.st_size;
+    if ( length == 0 && write && ( mode & VEC_MAP_CREATE ) )
+    {
+        // a fresh file, write the header of an empty vector
+        vec_file_header header = { VEC_FILE_MAGIC, VEC_FILE_VERSION, VEC_FILE_DATA_OFFSET, elem_size, 0 };
+        length = VEC_FILE_DATA_OFFSET;
+        if ( ftruncate( fd, (off_t) length ) != 0 || pwrite( fd, &header, sizeof header, 0 ) != sizeof header )
+        {
+            close( fd );
+            return VEC_ERR_IO;
+        }
+    }
+    vec_file_header header;
+    if ( length < VEC_FILE_DATA_OFFSET || pread( fd, &header, sizeof header, 0 ) != sizeof header
+         || memcmp( header.magic, VEC_FILE_MAGIC, sizeof header.magic ) != 0 || header.version != VEC_FILE_VERSION
+         || header.data_offset != VEC_FILE_DATA_OFFSET || header.elem_size != elem_size
+         || header_size > VEC_FILE_DATA_OFFSET
+         || header.size > ( length - VEC_FILE_DATA_OFFSET ) / elem_size )
+    {
+        close( fd );
+        return VEC_ERR_FORMAT;
+    }
+    vec_mapping* map = malloc( sizeof ( vec_mapping ) );
+    if ( map == NULL )
+    {
+        close( fd );
+        return VEC_ERR_NOMEM;
+    }
+    map->base = mmap( NULL, length, PROT_READ | PROT_WRITE, write ? MAP_SHARED : MAP_PRIVATE, fd, 0 );
+    if ( map->base == MAP_FAILED )
+    {
+        free( map );
+        close( fd );
+        return VEC_ERR_IO;
+    }
+    if ( !write ) close( fd );
+    map->allocator = (vec_allocator) {
+        .allocate = vec_mapping_allocate_,
+        .reallocate = vec_mapping_reallocate_,
+        .deallocate = vec_mapping_deallocate_,
+        .ctx = map,
+    };
+    map->length = length;
+    map->fd = write ? fd : -1;
+    vec_meta* meta = vec_mapping_meta_( map );
+    meta->size = header.size;
+    meta->capacity = ( length - VEC_FILE_DATA_OFFSET ) / elem_size;
+    meta->alloc = &map->allocator;
+    meta->flags = 0;
+    VEC_COW_( atomic_init( &meta->shares, 0 ); )
+    *data = map->base + VEC_FILE_DATA_OFFSET;
+    return VEC_OK;
+}
+
+// write the header page and size elements of elem_size bytes to path
+static inline int vec_file_save_( const char* path, const void* data, size_t size, size_t elem_size )
+{
+    FILE* file = fopen( path, "wb" );
+    if ( file == NULL ) return VEC_ERR_IO;
+    static const char zeros[ VEC_FILE_DATA_OFFSET ];
+    vec_file_header header = { VEC_FILE_MAGIC, VEC_FILE_VERSION, VEC_FILE_DATA_OFFSET, elem_size, size };
+    bool ok = fwrite( &header, sizeof header, 1, file ) == 1
+              && fwrite( zeros, VEC_FILE_DATA_OFFSET - sizeof header, 1, file ) == 1
+              && ( size == 0 || fwrite( data, elem_size, size, file ) == size );
+    ok = fclose( file ) == 0 && ok;
+    return ok ? VEC_OK : VEC_ERR_IO;
+}
+
+
+// generate the file functions for T, `using_vector( T )` must come first
+#ifndef VECTOR_IMPLEMENTATION
+#define using_vector_mmap( T )                                                                              \
+int vec_save_##T( T* self, const char* path );                                                              \
+int vec_try_map_file_##T( T** self, const char* path, int mode );                                           \
+T* vec_map_file_##T( const char* path, int mode );                                                          \
+int vec_sync_##T( T* self );                                                                                \
+
+#endif  // VECTOR_IMPLEMENTATION
+#endif  // __VEC_MMAP_H__
+
+
+#ifdef VECTOR_IMPLEMENTATION
+#define using_vector_mmap( T )                                                                              \
+/* write the vector to path, VEC_ERR_IO if that fails */                                                    \
+int vec_save_##T( T* self, const char* path )                                                               \
+{                                                                                                           \
+    return vec_file_save_( path, self, vec_size_##T( self ), sizeof ( T ) );                                \
+}                                                                                                           \
+/* map a file written by vec_save as a vector, mode is VEC_MAP_READ or VEC_MAP_WRITE ( | VEC_MAP_CREATE ) */ \
+/* the vector is used like any other, vec_destroy unmaps it */                                              \
+int vec_try_map_file_##T( T** self, const char* path, int mode )                                            \
+{                                                                                                           \
+    char* data;                                                                                             \
+    int err = vec_mapping_open_( path, mode, sizeof ( T ), vec_header_size_##T(), &data );                  \
+    if ( VEC_UNLIKELY( err ) ) return err;                                                                  \
+    *self = (void*) data;                                                                                   \
+    VEC_STATS_( vec_stats_alloc_( &vec_stats_of_##T, vec_bytes_##T( vec_get_meta_##T( *self )->capacity ), 0 ); ) \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+T* vec_map_file_##T( const char* path, int mode )                                                           \
+{                                                                                                           \
+    T* self;                                                                                                \
+    int err = vec_try_map_file_##T( &self, path, mode );                                                    \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* flush a VEC_MAP_WRITE vector to its file, nothing to do for any other vector */                          \
+int vec_sync_##T( T* self )                                                                                 \
+{                                                                                                           \
+    vec_mapping* map = vec_mapping_of_( vec_get_meta_##T( self )->alloc );                                  \
+    if ( map == NULL || map->base == NULL || map->fd < 0 ) return VEC_OK;                                   \
+    return vec_mapping_sync_( map );                                                                        \
+}                                                                                                           \
+
+#endif  // VECTOR_IMPLEMENTATION
@@ -0,0 +1,480 @@
+#ifndef __VEC_PACK_H__
+#define __VEC_PACK_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "vector.h"
+#include "vec_simd.h"
+
+
+// compressed vector of integers, kept as blocks of VEC_PACK_BLOCK values that each store a 64-bit base and the
+// values relative to it in the fewest bits that fit the block, in one of two formats:
+//     VEC_PACK_FOR      frame of reference, value - the smallest value of the block, for any integers
+//     VEC_PACK_DELTA    value - the value VEC_PACK_LANES before it, the base is the first value, for sorted
+//                       sequences ( ids, offsets, timestamps ) where the steps are much smaller than the values
+// value i of a block sits in 32-bit lane i % VEC_PACK_LANES, so decoding is the same shift and mask on all
+// lanes at once and the delta prefix sum runs down the lanes instead of across them, the deltas are 3 bits
+// wider than deltas to the previous value but the whole decode vectorizes
+// a block that would need more than 32 bits per value keeps its values as they are
+// the values after the last full block wait in the tail uncompressed, push only stores on the fast path
+// reads go by value or by block, the scans decode one block at a time into a buffer on the stack and skip the
+// blocks whose range rules them out, nothing is ever decompressed as a whole
+#define VEC_PACK_BLOCK 256              // values per block
+#define VEC_PACK_LANES 8                // lanes a block is packed across, a block of width w is 8 * w words
+#define VEC_PACK_RAW 64                 // width of a block stored uncompressed, only for 64-bit types
+
+enum { VEC_PACK_FOR, VEC_PACK_DELTA };
+
+// one full block, its packed values are VEC_PACK_LANES * width words starting at offset
+typedef struct vec_pack_block
+{
+    uint64_t base;                      // smallest value ( FOR ) or first value ( DELTA ), as uint64_t
+    size_t offset;
+    uint32_t width;                     // bits per value, 0 when every value is the base
+} vec_pack_block;
+
+// bits needed to write x, 0 for 0
+static inline uint32_t vec_pack_width_( uint64_t x )
+{
+#if defined( __GNUC__ ) || defined( __clang__ )
+    return x ? 64 - (uint32_t) __builtin_clzll( x ) : 0;
+#else
+    uint32_t width = 0;
+    for ( ; x; x >>= 1 ) width++;
+    return width;
+#endif
+}
+
+static inline uint32_t vec_pack_mask_( uint32_t width )
+{
+    return width >= 32 ? ~(uint32_t) 0 : ( (uint32_t) 1 << width ) - 1;
+}
+
+// value i of the packed block at words, width <= 32
+static inline uint32_t vec_pack_extract_( const uint32_t* words, uint32_t width, size_t i )
+{
+    if ( width == 0 ) return 0;
+    size_t bit = i / VEC_PACK_LANES * width;
+    const uint32_t* lane = words + bit / 32 * VEC_PACK_LANES + i % VEC_PACK_LANES;
+    uint32_t shift = bit % 32;
+    uint32_t val = lane[0] >> shift;
+    if ( shift + width > 32 ) val |= lane[ VEC_PACK_LANES ] << ( 32 - shift );
+    return val & vec_pack_mask_( width );
+}
+
+// pack VEC_PACK_BLOCK values of at most width bits into VEC_PACK_LANES * width words, 0 < width <= 32
+static inline void vec_pack_encode_( const uint32_t* values, uint32_t width, uint32_t* words )
+{
+    memset( words, 0, VEC_PACK_LANES * width * sizeof ( uint32_t ) );
+    for ( size_t k = 0; k < VEC_PACK_BLOCK / VEC_PACK_LANES; k++ )
+    {
+        size_t bit = k * width;
+        uint32_t* lane = words + bit / 32 * VEC_PACK_LANES;
+        uint32_t shift = bit % 32;
+        const uint32_t* val = values + k * VEC_PACK_LANES;
+        for ( size_t l = 0; l < VEC_PACK_LANES; l++ ) lane[l] |= val[l] << shift;
+        if ( shift + width > 32 )
+        {
+            for ( size_t l = 0; l < VEC_PACK_LANES; l++ ) lane[ VEC_PACK_LANES + l ] |= val[l] >> ( 32 - shift );
+        }
+    }
+}
+
+// grow the array ptr of *capacity elements to hold size, allocating it when ptr is NULL
+// returns the array, or NULL with ptr and *capacity untouched when out of memory
+static inline void* vec_pack_grow_( const vec_allocator* alloc, void* ptr, size_t* capacity, size_t size,
+                                    size_t elem_size )
+{
+    if ( size <= *capacity ) return ptr;
+    size_t cap = vec_grow_capacity( *capacity, size, elem_size, VEC_GROWTH_DEFAULT );
+    if ( VEC_UNLIKELY( cap > SIZE_MAX / elem_size ) ) return NULL;
+    void* grown = ptr == NULL
+                ? vec_mem_alloc( alloc, cap * elem_size, VEC_HEADER_ALIGN )
+                : vec_mem_realloc( alloc, ptr, *capacity * elem_size, cap * elem_size, VEC_HEADER_ALIGN );
+    if ( VEC_UNLIKELY( grown == NULL ) ) return NULL;
+    *capacity = cap;
+    return grown;
+}
+
+
+// the struct and the append fast path, the same in the declaration and the implementation
+#define vec_packed_common_( T )                                                                             \
+typedef struct vec_packed_##T                                                                               \
+{                                                                                                           \
+    vec_meta meta;                  /* size is the number of values, capacity the words allocated */        \
+    int format;                     /* VEC_PACK_FOR or VEC_PACK_DELTA */                                    \
+    size_t words_used;                                                                                      \
+    uint32_t* words;                /* the packed values of every block */                                  \
+    size_t block_count;             /* full blocks, size / VEC_PACK_BLOCK */                                \
+    size_t block_capacity;                                                                                  \
+    vec_pack_block* blocks;                                                                                 \
+    T tail[ VEC_PACK_BLOCK ];       /* the size % VEC_PACK_BLOCK values after the last block */             \
+} vec_packed_##T;                                                                                           \
+int vec_packed_seal_##T( vec_packed_##T* self, const T* values );                                           \
+/* Returns the number of values */                                                                          \
+static inline size_t vec_packed_size_##T( vec_packed_##T* self )                                            \
+{                                                                                                           \
+    return self->meta.size;                                                                                 \
+}                                                                                                           \
+/* number of blocks vec_packed_get_block hands out, the last one is the tail when it is not empty */        \
+static inline size_t vec_packed_blocks_##T( vec_packed_##T* self )                                          \
+{                                                                                                           \
+    return ( self->meta.size + VEC_PACK_BLOCK - 1 ) / VEC_PACK_BLOCK;                                       \
+}                                                                                                           \
+/* bytes taken by the values: the packed words, the block headers and the tail */                           \
+static inline size_t vec_packed_bytes_##T( vec_packed_##T* self )                                           \
+{                                                                                                           \
+    return self->words_used * sizeof ( uint32_t ) + self->block_count * sizeof ( vec_pack_block ) +         \
+           self->meta.size % VEC_PACK_BLOCK * sizeof ( T );                                                 \
+}                                                                                                           \
+/* append val, the tail is compressed into a block once it is full */                                       \
+/* VEC_ERR_NOMEM when that block could not be stored, the vector is untouched then */                       \
+static inline int vec_packed_try_push_##T( vec_packed_##T* self, T val )                                    \
+{                                                                                                           \
+    size_t at = self->meta.size % VEC_PACK_BLOCK;                                                           \
+    self->tail[ at ] = val;                                                                                 \
+    if ( VEC_UNLIKELY( at == VEC_PACK_BLOCK - 1 ) )                                                         \
+    {                                                                                                       \
+        int err = vec_packed_seal_##T( self, self->tail );                                                  \
+        if ( VEC_UNLIKELY( err ) ) return err;                                                              \
+    }                                                                                                       \
+    self->meta.size++;                                                                                      \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+static inline void vec_packed_push_##T( vec_packed_##T* self, T val )                                       \
+{                                                                                                           \
+    int err = vec_packed_try_push_##T( self, val );                                                         \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+}                                                                                                           \
+
+
+// generate the compressed vector of the integer type T, `using_vector( T )` must come first
+#ifndef VECTOR_IMPLEMENTATION
+#define using_packed_vector( T )                                                                            \
+vec_packed_common_( T )                                                                                     \
+vec_packed_##T* vec_packed_new_##T( int format );                                                           \
+vec_packed_##T* vec_packed_new_with_alloc_##T( int format, const vec_allocator* alloc );                    \
+void vec_packed_append_arr_##T( vec_packed_##T* self, const T* arr, size_t size );                          \
+T vec_packed_get_##T( vec_packed_##T* self, size_t index );                                                 \
+size_t vec_packed_get_block_##T( vec_packed_##T* self, size_t block, T* out );                              \
+T* vec_packed_decode_##T( vec_packed_##T* self, T* out );                                                   \
+size_t vec_packed_count_range_##T( vec_packed_##T* self, T lo, T hi );                                      \
+size_t vec_packed_lower_bound_##T( vec_packed_##T* self, T val );                                           \
+void vec_packed_clear_##T( vec_packed_##T* self );                                                          \
+void vec_packed_destroy_##T( vec_packed_##T* self );                                                        \
+int vec_packed_try_new_##T( vec_packed_##T** self, int format );                                            \
+int vec_packed_try_new_with_alloc_##T( vec_packed_##T** self, int format, const vec_allocator* alloc );     \
+int vec_packed_try_append_arr_##T( vec_packed_##T* self, const T* arr, size_t size );                       \
+int vec_packed_try_decode_##T( vec_packed_##T* self, T** out );                                             \
+
+#endif  // VECTOR_IMPLEMENTATION
+#endif  // __VEC_PACK_H__
+
+
+#ifdef VECTOR_IMPLEMENTATION
+#define using_packed_vector( T )                                                                            \
+vec_packed_common_( T )                                                                                     \
+/* an empty vector in the given format, its memory comes from alloc ( NULL for malloc ) */                  \
+/* nothing but the vector itself is allocated until the first block is full */                              \
+int vec_packed_try_new_with_alloc_##T( vec_packed_##T** self, int format, const vec_allocator* alloc )      \
+{                                                                                                           \
+    vec_packed_##T* packed = vec_mem_alloc( alloc, sizeof ( vec_packed_##T ),                               \
+                                            VEC_ALIGNMENT( _Alignof( vec_packed_##T ) ) );                  \
+    if ( VEC_UNLIKELY( packed == NULL ) ) return VEC_ERR_NOMEM;                                             \
+    packed->meta = (vec_meta) { .size = 0, .capacity = 0, .alloc = alloc, .flags = 0 };                     \
+    packed->format = format;                                                                                \
+    packed->words_used = 0;                                                                                 \
+    packed->words = NULL;                                                                                   \
+    packed->block_count = 0;                                                                                \
+    packed->block_capacity = 0;                                                                             \
+    packed->blocks = NULL;                                                                                  \
+    *self = packed;                                                                                         \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+vec_packed_##T* vec_packed_new_with_alloc_##T( int format, const vec_allocator* alloc )                     \
+{                                                                                                           \
+    vec_packed_##T* self;                                                                                   \
+    int err = vec_packed_try_new_with_alloc_##T( &self, format, alloc );                                    \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+int vec_packed_try_new_##T( vec_packed_##T** self, int format )                                             \
+{                                                                                                           \
+    return vec_packed_try_new_with_alloc_##T( self, format, NULL );                                         \
+}                                                                                                           \
+vec_packed_##T* vec_packed_new_##T( int format )                                                            \
+{                                                                                                           \
+    return vec_packed_new_with_alloc_##T( format, NULL );                                                   \
+}                                                                                                           \
+/* compress the VEC_PACK_BLOCK values at values into a block after the others, self is untouched on failure */ \
+/* the differences are taken modulo 2^bits of T, so a signed or unsorted input still round-trips */         \
+int vec_packed_seal_##T( vec_packed_##T* self, const T* values )                                            \
+{                                                                                                           \
+    uint64_t mask = ~(uint64_t) 0 >> ( 64 - sizeof ( T ) * 8 );                                             \
+    uint64_t base = (uint64_t) values[0];                                                                   \
+    if ( self->format == VEC_PACK_FOR )                                                                     \
+    {                                                                                                       \
+        T min = values[0];                                                                                  \
+        for ( size_t i = 1; i < VEC_PACK_BLOCK; i++ ) min = values[i] < min ? values[i] : min;              \
+        base = (uint64_t) min;                                                                              \
+    }                                                                                                       \
+    uint32_t packed[ VEC_PACK_BLOCK ];                                                                      \
+    uint64_t bits = 0;                                                                                      \
+    for ( size_t i = 0; i < VEC_PACK_BLOCK; i++ )                                                           \
+    {                                                                                                       \
+        bool first = self->format == VEC_PACK_FOR || i < VEC_PACK_LANES;                                    \
+        uint64_t from = first ? base : (uint64_t) values[ i - VEC_PACK_LANES ];                             \
+        uint64_t delta = ( (uint64_t) values[i] - from ) & mask;                                            \
+        packed[i] = (uint32_t) delta;                                                                       \
+        bits |= delta;                                                                                      \
+    }                                                                                                       \
+    uint32_t width = vec_pack_width_( bits );                                                               \
+    if ( width > 32 ) width = VEC_PACK_RAW;                                                                 \
+    size_t offset = self->words_used, count = VEC_PACK_LANES * width;                                       \
+    vec_pack_block* blocks = vec_pack_grow_( self->meta.alloc, self->blocks, &self->block_capacity,         \
+                                             self->block_count + 1, sizeof ( vec_pack_block ) );            \
+    if ( VEC_UNLIKELY( blocks == NULL ) ) return VEC_ERR_NOMEM;                                             \
+    self->blocks = blocks;                                                                                  \
+    uint32_t* words = vec_pack_grow_( self->meta.alloc, self->words, &self->meta.capacity, offset + count,  \
+                                      sizeof ( uint32_t ) );                                                \
+    if ( VEC_UNLIKELY( words == NULL ) ) return VEC_ERR_NOMEM;                                              \
+    self->words = words;                                                                                    \
+    /* a raw block is VEC_PACK_BLOCK * 8 bytes, exactly VEC_PACK_LANES * VEC_PACK_RAW words */              \
+    if ( width == VEC_PACK_RAW ) memcpy( words + offset, values, VEC_PACK_BLOCK * sizeof ( T ) );           \
+    else if ( width > 0 ) vec_pack_encode_( packed, width, words + offset );                                \
+    self->blocks[ self->block_count++ ] = (vec_pack_block) { .base = base, .offset = offset, .width = width }; \
+    self->words_used += count;                                                                              \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+/* append size values of arr, whole blocks of arr are compressed straight from it */                        \
+/* VEC_ERR_NOMEM when a block could not be stored, the values before that block are kept */                 \
+int vec_packed_try_append_arr_##T( vec_packed_##T* self, const T* arr, size_t size )                        \
+{                                                                                                           \
+    size_t i = 0;                                                                                           \
+    while ( i < size )                                                                                      \
+    {                                                                                                       \
+        size_t at = self->meta.size % VEC_PACK_BLOCK;                                                       \
+        size_t count = size - i < VEC_PACK_BLOCK - at ? size - i : VEC_PACK_BLOCK - at;                     \
+        const T* block = arr + i;                                                                           \
+        if ( at > 0 || count < VEC_PACK_BLOCK )                                                             \
+        {                                                                                                   \
+            memcpy( self->tail + at, arr + i, count * sizeof ( T ) );                                       \
+            block = self->tail;                                                                             \
+        }                                                                                                   \
+        if ( at + count == VEC_PACK_BLOCK )                                                                 \
+        {                                                                                                   \
+            int err = vec_packed_seal_##T( self, block );                                                   \
+            if ( VEC_UNLIKELY( err ) ) return err;                                                          \
+        }                                                                                                   \
+        self->meta.size += count;                                                                           \
+        i += count;                                                                                         \
+    }                                                                                                       \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+void vec_packed_append_arr_##T( vec_packed_##T* self, const T* arr, size_t size )                           \
+{                                                                                                           \
+    int err = vec_packed_try_append_arr_##T( self, arr, size );                                             \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+}                                                                                                           \
+/* decode a packed block of VEC_PACK_BLOCK values into out */                                               \
+/* for each group of VEC_PACK_LANES values the shift is the same in every lane, so the lane loops vectorize */ \
+VEC_SIMD_CLONES static void vec_packed_unpack_##T( const uint32_t* words, uint32_t width, uint64_t base,    \
+                                                   bool delta, T* out )                                     \
+{                                                                                                           \
+    static const uint32_t zeros[ 2 * VEC_PACK_LANES ];                                                      \
+    if ( width == 0 ) words = zeros;                                                                        \
+    uint32_t mask = vec_pack_mask_( width );                                                                \
+    /* the running sums of the delta lanes stay in registers, reading them back from out would wait on the */ \
+    /* stores every step */                                                                                 \
+    T run[ VEC_PACK_LANES ];                                                                                \
+    for ( size_t l = 0; l < VEC_PACK_LANES; l++ ) run[l] = (T) base;                                        \
+    for ( size_t k = 0; k < VEC_PACK_BLOCK / VEC_PACK_LANES; k++ )                                          \
+    {                                                                                                       \
+        size_t bit = k * width;                                                                             \
+        const uint32_t* lane = words + bit / 32 * VEC_PACK_LANES;                                           \
+        uint32_t shift = bit % 32;                                                                          \
+        uint32_t val[ VEC_PACK_LANES ];                                                                     \
+        if ( shift + width <= 32 )                                                                          \
+        {                                                                                                   \
+            for ( size_t l = 0; l < VEC_PACK_LANES; l++ ) val[l] = ( lane[l] >> shift ) & mask;             \
+        }                                                                                                   \
+        else                                                                                                \
+        {                                                                                                   \
+            for ( size_t l = 0; l < VEC_PACK_LANES; l++ )                                                   \
+            {                                                                                               \
+                val[l] = ( ( lane[l] >> shift ) | ( lane[ VEC_PACK_LANES + l ] << ( 32 - shift ) ) ) & mask; \
+            }                                                                                               \
+        }                                                                                                   \
+        T* dst = out + k * VEC_PACK_LANES;                                                                  \
+        if ( delta )                                                                                        \
+        {                                                                                                   \
+            for ( size_t l = 0; l < VEC_PACK_LANES; l++ ) dst[l] = run[l] = (T) ( (uint64_t) run[l] + val[l] ); \
+        }                                                                                                   \
+        else                                                                                                \
+        {                                                                                                   \
+            for ( size_t l = 0; l < VEC_PACK_LANES; l++ ) dst[l] = (T) ( base + val[l] );                   \
+        }                                                                                                   \
+    }                                                                                                       \
+}                                                                                                           \
+/* decode block number block into out, which has room for VEC_PACK_BLOCK values */                          \
+/* returns the number of values, VEC_PACK_BLOCK for a full block, fewer for the tail, 0 past the end */     \
+size_t vec_packed_get_block_##T( vec_packed_##T* self, size_t block, T* out )                               \
+{                                                                                                           \
+    if ( block < self->block_count )                                                                        \
+    {                                                                                                       \
+        vec_pack_block* b = &self->blocks[ block ];                                                         \
+        if ( b->width == VEC_PACK_RAW ) memcpy( out, self->words + b->offset, VEC_PACK_BLOCK * sizeof ( T ) ); \
+        else vec_packed_unpack_##T( self->words + b->offset, b->width, b->base,                             \
+                                    self->format == VEC_PACK_DELTA, out );                                  \
+        return VEC_PACK_BLOCK;                                                                              \
+    }                                                                                                       \
+    if ( block > self->block_count ) return 0;                                                              \
+    size_t size = self->meta.size % VEC_PACK_BLOCK;                                                         \
+    memcpy( out, self->tail, size * sizeof ( T ) );                                                         \
+    return size;                                                                                            \
+}                                                                                                           \
+/* get the value at index, index < size */                                                                  \
+/* O(1) for VEC_PACK_FOR, a DELTA value adds up the at most 32 deltas above it in its lane */               \
+T vec_packed_get_##T( vec_packed_##T* self, size_t index )                                                  \
+{                                                                                                           \
+    size_t block = index / VEC_PACK_BLOCK, at = index % VEC_PACK_BLOCK;                                     \
+    if ( block == self->block_count ) return self->tail[ at ];                                              \
+    vec_pack_block* b = &self->blocks[ block ];                                                             \
+    const uint32_t* words = self->words + b->offset;                                                        \
+    if ( b->width == VEC_PACK_RAW )                                                                         \
+    {                                                                                                       \
+        T val;                                                                                              \
+        memcpy( &val, (const char*) words + at * sizeof ( T ), sizeof ( T ) );                              \
+        return val;                                                                                         \
+    }                                                                                                       \
+    if ( self->format == VEC_PACK_FOR ) return (T) ( b->base + vec_pack_extract_( words, b->width, at ) );  \
+    uint64_t val = b->base;                                                                                 \
+    for ( size_t i = at % VEC_PACK_LANES; i <= at; i += VEC_PACK_LANES )                                    \
+    {                                                                                                       \
+        val += vec_pack_extract_( words, b->width, i );                                                     \
+    }                                                                                                       \
+    return (T) val;                                                                                         \
+}                                                                                                           \
+/* append every value to the vector *out, decoded block by block straight into its storage */               \
+/* VEC_ERR_NOMEM when *out could not grow, it is untouched then */                                          \
+int vec_packed_try_decode_##T( vec_packed_##T* self, T** out )                                              \
+{                                                                                                           \
+    size_t size = vec_size_##T( *out );                                                                     \
+    if ( VEC_UNLIKELY( self->meta.size > SIZE_MAX - size ) ) return VEC_ERR_NOMEM;                          \
+    int err = VEC_OK;                                                                                       \
+    /* reserve only copies a shared block when it has to grow, the values are written in place */           \
+    VEC_COW_( err = vec_try_unshare_##T( out ); )                                                           \
+    VEC_COW_( if ( VEC_UNLIKELY( err ) ) return err; )                                                      \
+    err = vec_try_reserve_##T( out, size + self->meta.size );                                               \
+    if ( VEC_UNLIKELY( err ) ) return err;                                                                  \
+    T* dst = *out + size;                                                                                   \
+    for ( size_t block = 0; block <= self->block_count; block++ )                                           \
+    {                                                                                                       \
+        vec_packed_get_block_##T( self, block, dst + block * VEC_PACK_BLOCK );                              \
+    }                                                                                                       \
+    vec_get_meta_##T( *out )->size = size + self->meta.size;                                                \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+T* vec_packed_decode_##T( vec_packed_##T* self, T* out )                                                    \
+{                                                                                                           \
+    int err = vec_packed_try_decode_##T( self, &out );                                                      \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return out;                                                                                             \
+}                                                                                                           \
+/* number of values of a decoded block within [ lo, hi ], the fixed trip count and the 32-bit count let */  \
+/* the loop vectorize even at -O2 */                                                                        \
+VEC_SIMD_CLONES static size_t vec_packed_count_block_##T( const T* block, T lo, T hi )                      \
+{                                                                                                           \
+    uint32_t count = 0;                                                                                     \
+    for ( size_t i = 0; i < VEC_PACK_BLOCK; i++ ) count += ( block[i] >= lo ) & ( block[i] <= hi );         \
+    return count;                                                                                           \
+}                                                                                                           \
+/* number of values v with lo <= v <= hi */                                                                 \
+/* a FOR block knows its range from the base and the width, so blocks outside [ lo, hi ] are skipped and */ \
+/* blocks inside it counted whole, only the blocks straddling lo or hi are decoded */                       \
+size_t vec_packed_count_range_##T( vec_packed_##T* self, T lo, T hi )                                       \
+{                                                                                                           \
+    T buffer[ VEC_PACK_BLOCK ];                                                                             \
+    size_t count = 0;                                                                                       \
+    for ( size_t block = 0; block <= self->block_count; block++ )                                           \
+    {                                                                                                       \
+        if ( block < self->block_count && self->format == VEC_PACK_FOR && self->blocks[ block ].width <= 32 ) \
+        {                                                                                                   \
+            vec_pack_block* b = &self->blocks[ block ];                                                     \
+            T min = (T) b->base, max = (T) ( b->base + vec_pack_mask_( b->width ) );                        \
+            if ( min > hi ) continue;                                                                       \
+            /* max wraps around when the block may reach past the largest T, the bound is no use then */    \
+            if ( max >= min && max < lo ) continue;                                                         \
+            if ( max >= min && min >= lo && max <= hi )                                                     \
+            {                                                                                               \
+                count += VEC_PACK_BLOCK;                                                                    \
+                continue;                                                                                   \
+            }                                                                                               \
+        }                                                                                                   \
+        if ( block == self->block_count )                                                                   \
+        {                                                                                                   \
+            size_t size = self->meta.size % VEC_PACK_BLOCK;                                                 \
+            for ( size_t i = 0; i < size; i++ ) count += self->tail[i] >= lo && self->tail[i] <= hi;        \
+            break;                                                                                          \
+        }                                                                                                   \
+        vec_packed_get_block_##T( self, block, buffer );                                                    \
+        count += vec_packed_count_block_##T( buffer, lo, hi );                                              \
+    }                                                                                                       \
+    return count;                                                                                           \
+}                                                                                                           \
+/* index of the first value >= val, size when there is none, the values must be sorted */                   \
+/* a binary search over the first values of the blocks, which both formats keep as the base when sorted, */ \
+/* then a search in the one block decoded */                                                                \
+size_t vec_packed_lower_bound_##T( vec_packed_##T* self, T val )                                            \
+{                                                                                                           \
+    size_t lo = 0, hi = self->block_count;                                                                  \
+    while ( lo < hi )                                                                                       \
+    {                                                                                                       \
+        size_t mid = lo + ( hi - lo ) / 2;                                                                  \
+        if ( (T) self->blocks[ mid ].base < val ) lo = mid + 1;                                             \
+        else hi = mid;                                                                                      \
+    }                                                                                                       \
+    /* the blocks before lo start below val, the answer is in block lo - 1 or it is the start of block lo, */ \
+    /* block lo is the tail when every full block starts below val */                                       \
+    T buffer[ VEC_PACK_BLOCK ];                                                                             \
+    for ( size_t block = lo > 0 ? lo - 1 : 0; block <= lo; block++ )                                        \
+    {                                                                                                       \
+        if ( block == lo && lo < self->block_count ) break;                                                 \
+        size_t first = 0, last = vec_packed_get_block_##T( self, block, buffer );                           \
+        while ( first < last )                                                                              \
+        {                                                                                                   \
+            size_t mid = first + ( last - first ) / 2;                                                      \
+            if ( buffer[ mid ] < val ) first = mid + 1;                                                     \
+            else last = mid;                                                                                \
+        }                                                                                                   \
+        if ( first < VEC_PACK_BLOCK && ( block < self->block_count || first < self->meta.size % VEC_PACK_BLOCK ) ) \
+        {                                                                                                   \
+            return block * VEC_PACK_BLOCK + first;                                                          \
+        }                                                                                                   \
+    }                                                                                                       \
+    return lo < self->block_count ? lo * VEC_PACK_BLOCK : self->meta.size;                                  \
+}                                                                                                           \
+/* remove every value, keeps the memory */                                                                  \
+void vec_packed_clear_##T( vec_packed_##T* self )                                                           \
+{                                                                                                           \
+    self->meta.size = 0;                                                                                    \
+    self->words_used = 0;                                                                                   \
+    self->block_count = 0;                                                                                  \
+}                                                                                                           \
+void vec_packed_destroy_##T( vec_packed_##T* self )                                                         \
+{                                                                                                           \
+    const vec_allocator* alloc = self->meta.alloc;                                                          \
+    if ( self->words != NULL )                                                                              \
+    {                                                                                                       \
+        vec_mem_free( alloc, self->words, self->meta.capacity * sizeof ( uint32_t ), VEC_HEADER_ALIGN );    \
+    }                                                                                                       \
+    if ( self->blocks != NULL )                                                                             \
+    {                                                                                                       \
+        vec_mem_free( alloc, self->blocks, self->block_capacity * sizeof ( vec_pack_block ), VEC_HEADER_ALIGN ); \
+    }                                                                                                       \
+    vec_mem_free( alloc, self, sizeof ( vec_packed_##T ), VEC_ALIGNMENT( _Alignof( vec_packed_##T ) ) );    \
+}                                                                                                           \
+
+#endif  // VECTOR_IMPLEMENTATION
@@ -0,0 +1,499 @@
+#ifndef __VEC_PARALLEL_H__
+#define __VEC_PARALLEL_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "vector.h"
+
+
+// opt-in parallel layer, link with -pthread
+// a vec_thread_pool runs a job over [ 0, size ) cut into chunks, every participant ( the workers and the
+// calling thread ) owns a range of chunks, pops chunks from its front and steals half of another range
+// from the back once its own is empty
+// pass NULL as pool for the process-wide pool, it starts on first use with one participant per online
+// cpu, or VEC_PAR_THREADS from the environment
+// jobs must not start other jobs on the same pool
+#ifndef VEC_PAR_GRAIN
+#define VEC_PAR_GRAIN ( (size_t) 16384 )       // smallest chunk in elements
+#endif
+#ifndef VEC_PAR_MAX_CHUNKS
+#define VEC_PAR_MAX_CHUNKS ( (size_t) 4096 )   // a job is never cut into more chunks than this
+#endif
+
+// process elements [ begin, end ) of the job, always one chunk: begin is a multiple of the chunk size
+typedef void (*vec_par_task)( void* ctx, size_t begin, size_t end );
+
+typedef struct vec_par_slot_
+{
+    _Alignas( 64 ) _Atomic uint64_t range;     // chunks [ low 32 bits, high 32 bits ) left to this participant
+} vec_par_slot_;
+
+typedef struct vec_thread_pool
+{
+    size_t threads;                 // participants, the calling thread included
+    pthread_t* workers;             // threads - 1 of them
+    vec_par_slot_* slots;           // one per participant, slot 0 is the calling thread
+    pthread_mutex_t run;            // one job at a time
+    pthread_mutex_t lock;           // guards everything below
+    pthread_cond_t start;           // a new job is up or the pool stops
+    pthread_cond_t finish;          // the last worker left the job
+    unsigned long generation;       // bumped for every job
+    size_t running;                 // workers still inside the job
+    bool stop;
+    vec_par_task task;              // the current job
+    void* ctx;
+    size_t size;
+    size_t chunk;
+} vec_thread_pool;
+
+// start a pool of threads participants, 0 for one per online cpu, false when a thread cannot be started
+bool vec_thread_pool_init( vec_thread_pool* pool, size_t threads );
+// stop and join the workers
+void vec_thread_pool_destroy( vec_thread_pool* pool );
+// the process-wide pool behind NULL
+vec_thread_pool* vec_thread_pool_default( void );
+// number of participants of pool, NULL for the process-wide pool
+size_t vec_par_threads( vec_thread_pool* pool );
+// chunk size for a job over size elements, only depends on size so results do not change with the pool
+size_t vec_par_chunk_size( size_t size );
+// run task over [ 0, size ) in chunks of chunk elements and return once every chunk is done,
+// chunk is raised so that there are at most UINT32_MAX chunks, the work ranges hold chunk indices in 32 bits
+void vec_par_run( vec_thread_pool* pool, size_t size, size_t chunk, vec_par_task task, void* ctx );
+
+
+// generate the parallel algorithms for T, `using_vector( T )` must come first
+// callbacks get whole chunks, so the loop inside them can be vectorized
+// `using_vector_par_sort( T, LESS )` also needs `using_vector_sort( T, LESS )` from vec_sort.h
+#ifndef VECTOR_IMPLEMENTATION
+#define using_vector_parallel( T )                                                                          \
+T* vec_par_for_each_##T( vec_thread_pool* pool, T* self, void (*each)( T* arr, size_t size, void* ctx ),    \
+                         void* ctx );                                                                       \
+T* vec_par_transform_##T( vec_thread_pool* pool, T* dst, T* src,                                            \
+                          void (*transform)( T* dst, const T* src, size_t size, void* ctx ), void* ctx );   \
+T vec_par_reduce_##T( vec_thread_pool* pool, T* self, T init, T (*reduce)( const T* arr, size_t size, void* ctx ), \
+                      T (*combine)( T a, T b, void* ctx ), void* ctx );                                     \
+
+#define using_vector_par_sort( T, LESS )                                                                    \
+void vec_par_sort_arr_##T( vec_thread_pool* pool, T* arr, size_t size );                                    \
+T* vec_par_sort_##T( vec_thread_pool* pool, T* self );                                                      \
+
+#endif  // VECTOR_IMPLEMENTATION
+#endif  // __VEC_PARALLEL_H__
+
+
+#ifdef VECTOR_IMPLEMENTATION
+#ifndef __VEC_PARALLEL_IMPL__
+#define __VEC_PARALLEL_IMPL__
+
+#include <unistd.h>
+
+// every VECTOR_IMPLEMENTATION translation unit defines the pool and its functions, the linker keeps one
+// of each, so one-.c-per-type builds link and share a single process-wide pool
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define VEC_PAR_WEAK __attribute__(( weak ))
+#else
+#define VEC_PAR_WEAK
+#endif
+
+static inline uint64_t vec_par_range_( size_t begin, size_t end )
+{
+    return (uint64_t) begin | ( (uint64_t) end << 32 );
+}
+
+// take the next chunk of participant id's own range
+static bool vec_par_pop_( vec_thread_pool* pool, size_t id, size_t* chunk )
+{
+    _Atomic uint64_t* slot = &pool->slots[ id ].range;
+    uint64_t range = atomic_load_explicit( slot, memory_order_relaxed );
+    for ( ;; )
+    {
+        size_t begin = (size_t) ( range & 0xffffffffu );
+        size_t end = (size_t) ( range >> 32 );
+        if ( begin >= end ) return false;
+        if ( atomic_compare_exchange_weak_explicit( slot, &range, vec_par_range_( begin + 1, end ),
+                                                    memory_order_acq_rel, memory_order_relaxed ) )
+        {
+            *chunk = begin;
+            return true;
+        }
+    }
+}
+
+// move the back half of some other participant's range into participant id's empty one
+static bool vec_par_steal_( vec_thread_pool* pool, size_t id )
+{
+    for ( size_t k = 1; k < pool->threads; k++ )
+    {
+        size_t victim = ( id + k ) % pool->threads;
+        _Atomic uint64_t* slot = &pool->slots[ victim ].range;
+        uint64_t range = atomic_load_explicit( slot, memory_order_relaxed );
+        for ( ;; )
+        {
+            size_t begin = (size_t) ( range & 0xffffffffu );
+            size_t end = (size_t) ( range >> 32 );
+            if ( begin >= end ) break;
+            size_t split = end - ( end - begin + 1 ) / 2;
+            if ( atomic_compare_exchange_weak_explicit( slot, &range, vec_par_range_( begin, split ),
+                                                        memory_order_acq_rel, memory_order_relaxed ) )
+            {
+                atomic_store_explicit( &pool->slots[ id ].range, vec_par_range_( split, end ), memory_order_release );
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// participant id works until no chunk is left anywhere
+static void vec_par_work_( vec_thread_pool* pool, size_t id )
+{
+    size_t chunk;
+    do
+    {
+        while ( vec_par_pop_( pool, id, &chunk ) )
+        {
+            size_t begin = chunk * pool->chunk;
+            size_t end = pool->size - begin < pool->chunk ? pool->size : begin + pool->chunk;
+            pool->task( pool->ctx, begin, end );
+        }
+    }
+    while ( vec_par_steal_( pool, id ) );
+}
+
+typedef struct vec_par_worker_
+{
+    vec_thread_pool* pool;
+    size_t id;
+} vec_par_worker_;
+
+static void* vec_par_worker_main_( void* arg )
+{
+    vec_par_worker_ self = *(vec_par_worker_*) arg;
+    free( arg );
+    vec_thread_pool* pool = self.pool;
+    unsigned long seen = 0;
+    for ( ;; )
+    {
+        pthread_mutex_lock( &pool->lock );
+        while ( !pool->stop && pool->generation == seen ) pthread_cond_wait( &pool->start, &pool->lock );
+        if ( pool->stop )
+        {
+            pthread_mutex_unlock( &pool->lock );
+            return NULL;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock( &pool->lock );
+
+        vec_par_work_( pool, self.id );
+
+        pthread_mutex_lock( &pool->lock );
+        if ( --pool->running == 0 ) pthread_cond_signal( &pool->finish );
+        pthread_mutex_unlock( &pool->lock );
+    }
+}
+
+VEC_PAR_WEAK bool vec_thread_pool_init( vec_thread_pool* pool, size_t threads )
+{
+    if ( threads == 0 )
+    {
+        long cpus = sysconf( _SC_NPROCESSORS_ONLN );
+        threads = cpus > 0 ? (size_t) cpus : 1;
+    }
+    pool->threads = threads;
+    pool->generation = 0;
+    pool->running = 0;
+    pool->stop = false;
+    pool->workers = malloc( threads * sizeof ( pthread_t ) );
+    pool->slots = vec_default_alloc( threads * sizeof ( vec_par_slot_ ), _Alignof( vec_par_slot_ ) );
+    if ( pool->workers == NULL || pool->slots == NULL )
+    {
+        free( pool->workers );
+        free( pool->slots );
+        return false;
+    }
+    for ( size_t i = 0; i < threads; i++ ) atomic_init( &pool->slots[i].range, 0 );
+    pthread_mutex_init( &pool->run, NULL );
+    pthread_mutex_init( &pool->lock, NULL );
+    pthread_cond_init( &pool->start, NULL );
+    pthread_cond_init( &pool->finish, NULL );
+    for ( size_t i = 1; i < threads; i++ )
+    {
+        vec_par_worker_* arg = malloc( sizeof ( vec_par_worker_ ) );
+        if ( arg != NULL ) *arg = (vec_par_worker_) { pool, i };
+        if ( arg == NULL || pthread_create( &pool->workers[i], NULL, vec_par_worker_main_, arg ) != 0 )
+        {
+            free( arg );
+            pool->threads = i;
+            vec_thread_pool_destroy( pool );
+            return false;
+        }
+    }
+    return true;
+}
+
+VEC_PAR_WEAK void vec_thread_pool_destroy( vec_thread_pool* pool )
+{
+    pthread_mutex_lock( &pool->lock );
+    pool->stop = true;
+    pthread_cond_broadcast( &pool->start );
+    pthread_mutex_unlock( &pool->lock );
+    for ( size_t i = 1; i < pool->threads; i++ ) pthread_join( pool->workers[i], NULL );
+    pthread_mutex_destroy( &pool->run );
+    pthread_mutex_destroy( &pool->lock );
+    pthread_cond_destroy( &pool->start );
+    pthread_cond_destroy( &pool->finish );
+    free( pool->workers );
+    free( pool->slots );
+}
+
+VEC_PAR_WEAK vec_thread_pool vec_par_default_;
+VEC_PAR_WEAK bool vec_par_default_ok_;
+VEC_PAR_WEAK pthread_once_t vec_par_default_once_ = PTHREAD_ONCE_INIT;
+
+static void vec_par_default_init_( void )
+{
+    const char* env = getenv( "VEC_PAR_THREADS" );
+    size_t threads = env ? strtoull( env, NULL, 10 ) : 0;
+    vec_par_default_ok_ = vec_thread_pool_init( &vec_par_default_, threads );
+    if ( !vec_par_default_ok_ ) vec_par_default_ok_ = vec_thread_pool_init( &vec_par_default_, 1 );
+}
+
+VEC_PAR_WEAK vec_thread_pool* vec_thread_pool_default( void )
+{
+    pthread_once( &vec_par_default_once_, vec_par_default_init_ );
+    return vec_par_default_ok_ ? &vec_par_default_ : NULL;
+}
+
+VEC_PAR_WEAK size_t vec_par_threads( vec_thread_pool* pool )
+{
+    if ( pool == NULL ) pool = vec_thread_pool_default();
+    return pool ? pool->threads : 1;
+}
+
+VEC_PAR_WEAK size_t vec_par_chunk_size( size_t size )
+{
+    size_t chunk = ( size + VEC_PAR_MAX_CHUNKS - 1 ) / VEC_PAR_MAX_CHUNKS;
+    return chunk < VEC_PAR_GRAIN ? VEC_PAR_GRAIN : chunk;
+}
+
+VEC_PAR_WEAK void vec_par_run( vec_thread_pool* pool, size_t size, size_t chunk, vec_par_task task, void* ctx )
+{
+    if ( size == 0 ) return;
+    if ( pool == NULL ) pool = vec_thread_pool_default();
+    if ( chunk == 0 ) chunk = 1;
+    if ( ( size - 1 ) / chunk >= UINT32_MAX ) chunk = ( size - 1 ) / UINT32_MAX + 1;
+    size_t chunks = ( size - 1 ) / chunk + 1;
+    if ( pool == NULL || pool->threads == 1 || chunks == 1 )
+    {
+        for ( size_t begin = 0; begin < size; begin += chunk )
+        {
+            task( ctx, begin, size - begin < chunk ? size : begin + chunk );
+        }
+        return;
+    }
+    pthread_mutex_lock( &pool->run );
+    for ( size_t i = 0; i < pool->threads; i++ )
+    {
+        atomic_store_explicit( &pool->slots[i].range,
+                               vec_par_range_( chunks * i / pool->threads, chunks * ( i + 1 ) / pool->threads ),
+                               memory_order_relaxed );
+    }
+    pthread_mutex_lock( &pool->lock );
+    pool->task = task;
+    pool->ctx = ctx;
+    pool->size = size;
+    pool->chunk = chunk;
+    pool->running = pool->threads - 1;
+    pool->generation++;
+    pthread_cond_broadcast( &pool->start );
+    pthread_mutex_unlock( &pool->lock );
+
+    vec_par_work_( pool, 0 );
+
+    pthread_mutex_lock( &pool->lock );
+    while ( pool->running > 0 ) pthread_cond_wait( &pool->finish, &pool->lock );
+    pthread_mutex_unlock( &pool->lock );
+    pthread_mutex_unlock( &pool->run );
+}
+
+#endif  // __VEC_PARALLEL_IMPL__
+
+
+#define using_vector_parallel( T )                                                                          \
+/* what the per-type tasks need, handed to vec_par_run as ctx */                                            \
+typedef struct vec_par_ctx_##T                                                                              \
+{                                                                                                           \
+    T* dst;                                                                                                 \
+    const T* src;                                                                                           \
+    size_t chunk;                                                                                           \
+    void (*each)( T* arr, size_t size, void* ctx );                                                         \
+    void (*transform)( T* dst, const T* src, size_t size, void* ctx );                                      \
+    T (*reduce)( const T* arr, size_t size, void* ctx );                                                    \
+    void* ctx;                                                                                              \
+} vec_par_ctx_##T;                                                                                          \
+static void vec_par_each_task_##T( void* p, size_t begin, size_t end )                                      \
+{                                                                                                           \
+    vec_par_ctx_##T* c = p;                                                                                 \
+    c->each( c->dst + begin, end - begin, c->ctx );                                                         \
+}                                                                                                           \
+static void vec_par_transform_task_##T( void* p, size_t begin, size_t end )                                 \
+{                                                                                                           \
+    vec_par_ctx_##T* c = p;                                                                                 \
+    c->transform( c->dst + begin, c->src + begin, end - begin, c->ctx );                                    \
+}                                                                                                           \
+static void vec_par_reduce_task_##T( void* p, size_t begin, size_t end )                                    \
+{                                                                                                           \
+    vec_par_ctx_##T* c = p;                                                                                 \
+    c->dst[ begin / c->chunk ] = c->reduce( c->src + begin, end - begin, c->ctx );                          \
+}                                                                                                           \
+/* call each on every chunk of the vector, in parallel */                                                   \
+T* vec_par_for_each_##T( vec_thread_pool* pool, T* self, void (*each)( T* arr, size_t size, void* ctx ),    \
+                         void* ctx )                                                                        \
+{                                                                                                           \
+    VEC_COW_( self = vec_unshare_##T( self ); )                                                             \
+    vec_par_ctx_##T c = { .dst = self, .each = each, .ctx = ctx };                                          \
+    size_t size = vec_size_##T( self );                                                                     \
+    vec_par_run( pool, size, vec_par_chunk_size( size ), vec_par_each_task_##T, &c );                       \
+    return self;                                                                                            \
+}                                                                                                           \
+/* resize dst to the size of src and fill it chunk by chunk with transform, in parallel */                  \
+T* vec_par_transform_##T( vec_thread_pool* pool, T* dst, T* src,                                            \
+                          void (*transform)( T* dst, const T* src, size_t size, void* ctx ), void* ctx )    \
+{                                                                                                           \
+    size_t size = vec_size_##T( src );                                                                      \
+    VEC_COW_( dst = vec_own_##T( dst, 0 ); )                                                                \
+    if ( vec_capacity_##T( dst ) < size ) dst = vec_reserve_##T( dst, size );                               \
+    vec_get_meta_##T( dst )->size = size;                                                                   \
+    vec_par_ctx_##T c = { .dst = dst, .src = src, .transform = transform, .ctx = ctx };                     \
+    vec_par_run( pool, size, vec_par_chunk_size( size ), vec_par_transform_task_##T, &c );                  \
+    return dst;                                                                                             \
+}                                                                                                           \
+/* reduce every chunk with reduce in parallel, then fold init and the partial results with combine */       \
+/* in chunk order, so the result does not depend on the number of threads */                                \
+T vec_par_reduce_##T( vec_thread_pool* pool, T* self, T init, T (*reduce)( const T* arr, size_t size, void* ctx ), \
+                      T (*combine)( T a, T b, void* ctx ), void* ctx )                                      \
+{                                                                                                           \
+    size_t size = vec_size_##T( self );                                                                     \
+    if ( size == 0 ) return init;                                                                           \
+    size_t chunk = vec_par_chunk_size( size );                                                              \
+    size_t chunks = ( size - 1 ) / chunk + 1;                                                               \
+    T* partials = vec_default_alloc( chunks * sizeof ( T ), _Alignof( T ) );                                \
+    if ( VEC_UNLIKELY( partials == NULL ) ) vec_fail_( VEC_ERR_NOMEM );                                     \
+    vec_par_ctx_##T c = { .dst = partials, .src = self, .chunk = chunk, .reduce = reduce, .ctx = ctx };     \
+    vec_par_run( pool, size, chunk, vec_par_reduce_task_##T, &c );                                          \
+    T acc = init;                                                                                           \
+    for ( size_t i = 0; i < chunks; i++ ) acc = combine( acc, partials[i], ctx );                           \
+    free( partials );                                                                                       \
+    return acc;                                                                                             \
+}                                                                                                           \
+
+#define using_vector_par_sort( T, LESS )                                                                    \
+/* the sorted blocks and the merge round the tasks work on */                                               \
+typedef struct vec_par_sort_ctx_##T                                                                         \
+{                                                                                                           \
+    T* src;                                                                                                 \
+    T* dst;                                                                                                 \
+    const size_t* bounds;                                                                                   \
+    size_t blocks;                                                                                          \
+    size_t width;                                                                                           \
+} vec_par_sort_ctx_##T;                                                                                     \
+static void vec_par_sort_task_##T( void* p, size_t begin, size_t end )                                      \
+{                                                                                                           \
+    vec_par_sort_ctx_##T* c = p;                                                                            \
+    for ( size_t b = begin; b < end; b++ )                                                                  \
+    {                                                                                                       \
+        vec_sort_arr_##T( c->src + c->bounds[b], c->bounds[ b + 1 ] - c->bounds[b] );                       \
+    }                                                                                                       \
+}                                                                                                           \
+/* how many elements of a go into the first k of the stable merge of a and b */                             \
+static size_t vec_par_corank_##T( size_t k, const T* a, size_t m, const T* b, size_t n )                    \
+{                                                                                                           \
+    size_t lo = k > n ? k - n : 0;                                                                          \
+    size_t hi = k < m ? k : m;                                                                              \
+    while ( lo < hi )                                                                                       \
+    {                                                                                                       \
+        size_t i = lo + ( hi - lo ) / 2;                                                                    \
+        size_t j = k - i;                                                                                   \
+        if ( j > 0 && i < m && !LESS( b[ j - 1 ], a[i] ) ) lo = i + 1;                                      \
+        else hi = i;                                                                                        \
+    }                                                                                                       \
+    return lo;                                                                                              \
+}                                                                                                           \
+/* write output positions [ begin, end ) of the current merge round, which may span several merges */       \
+static void vec_par_merge_task_##T( void* p, size_t begin, size_t end )                                     \
+{                                                                                                           \
+    vec_par_sort_ctx_##T* c = p;                                                                            \
+    size_t pos = begin;                                                                                     \
+    while ( pos < end )                                                                                     \
+    {                                                                                                       \
+        /* the block holding pos, then the pair of runs it is merged in */                                  \
+        size_t lo_b = 0, hi_b = c->blocks;                                                                  \
+        while ( hi_b - lo_b > 1 )                                                                           \
+        {                                                                                                   \
+            size_t m = ( lo_b + hi_b ) / 2;                                                                 \
+            if ( c->bounds[m] <= pos ) lo_b = m;                                                            \
+            else hi_b = m;                                                                                  \
+        }                                                                                                   \
+        size_t first = lo_b / ( 2 * c->width ) * ( 2 * c->width );                                          \
+        size_t lo = c->bounds[ first ];                                                                     \
+        size_t mid = c->bounds[ first + c->width < c->blocks ? first + c->width : c->blocks ];              \
+        size_t hi = c->bounds[ first + 2 * c->width < c->blocks ? first + 2 * c->width : c->blocks ];       \
+        size_t stop = end < hi ? end : hi;                                                                  \
+        const T* a = c->src + lo;                                                                           \
+        const T* b = c->src + mid;                                                                          \
+        size_t m = mid - lo, n = hi - mid;                                                                  \
+        size_t i = vec_par_corank_##T( pos - lo, a, m, b, n );                                              \
+        size_t j = pos - lo - i;                                                                            \
+        size_t i_end = vec_par_corank_##T( stop - lo, a, m, b, n );                                         \
+        size_t j_end = stop - lo - i_end;                                                                   \
+        T* out = c->dst + pos;                                                                              \
+        while ( i < i_end && j < j_end ) *out++ = LESS( b[j], a[i] ) ? b[ j++ ] : a[ i++ ];                 \
+        while ( i < i_end ) *out++ = a[ i++ ];                                                              \
+        while ( j < j_end ) *out++ = b[ j++ ];                                                              \
+        pos = stop;                                                                                         \
+    }                                                                                                       \
+}                                                                                                           \
+/* sort blocks in parallel with vec_sort_arr, then merge them pairwise, every round split across the pool */ \
+/* falls back to vec_sort_arr for small arrays or when the merge buffer cannot be allocated */              \
+void vec_par_sort_arr_##T( vec_thread_pool* pool, T* arr, size_t size )                                     \
+{                                                                                                           \
+    size_t blocks = vec_par_threads( pool );                                                                \
+    if ( blocks < 2 || size < 2 * VEC_PAR_GRAIN )                                                           \
+    {                                                                                                       \
+        vec_sort_arr_##T( arr, size );                                                                      \
+        return;                                                                                             \
+    }                                                                                                       \
+    size_t* bounds = malloc( ( blocks + 1 ) * sizeof ( size_t ) );                                          \
+    T* buf = vec_default_alloc( size * sizeof ( T ), _Alignof( T ) );                                       \
+    if ( bounds == NULL || buf == NULL )                                                                    \
+    {                                                                                                       \
+        free( bounds );                                                                                     \
+        free( buf );                                                                                        \
+        vec_sort_arr_##T( arr, size );                                                                      \
+        return;                                                                                             \
+    }                                                                                                       \
+    for ( size_t b = 0; b <= blocks; b++ ) bounds[b] = size / blocks * b + ( b < size % blocks ? b : size % blocks ); \
+    vec_par_sort_ctx_##T c = { .src = arr, .dst = buf, .bounds = bounds, .blocks = blocks, .width = 1 };    \
+    vec_par_run( pool, blocks, 1, vec_par_sort_task_##T, &c );                                              \
+    for ( ; c.width < blocks; c.width *= 2 )                                                                \
+    {                                                                                                       \
+        vec_par_run( pool, size, vec_par_chunk_size( size ), vec_par_merge_task_##T, &c );                  \
+        T* tmp = c.src;                                                                                     \
+        c.src = c.dst;                                                                                      \
+        c.dst = tmp;                                                                                        \
+    }                                                                                                       \
+    if ( c.src != arr ) memcpy( arr, c.src, size * sizeof ( T ) );                                          \
+    free( bounds );                                                                                         \
+    free( buf );                                                                                            \
+}                                                                                                           \
+T* vec_par_sort_##T( vec_thread_pool* pool, T* self )                                                       \
+{                                                                                                           \
+    VEC_COW_( self = vec_unshare_##T( self ); )                                                             \
+    vec_par_sort_arr_##T( pool, self, vec_size_##T( self ) );                                               \
+    return self;                                                                                            \
+}                                                                                                           \
+
+#endif  // VECTOR_IMPLEMENTATION
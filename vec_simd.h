@@ -0,0 +1,206 @@
+#ifndef __VEC_SIMD_H__
+#define __VEC_SIMD_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "vector.h"
+
+
+// bulk kernels for vectors of arithmetic types ( int, float, double, int64_t, ... )
+// the loops keep VEC_SIMD_LANES independent accumulators so the compiler can vectorize them without
+// reassociating floating point math, and on x86-64 ELF targets every kernel is compiled for AVX-512,
+// AVX2 and the SSE2 baseline with the best one picked at load time, elsewhere the plain loop is used
+#ifndef VEC_SIMD_LANES
+#define VEC_SIMD_LANES 16
+#endif
+
+#if defined( __has_attribute )
+#if __has_attribute( target_clones ) && defined( __x86_64__ ) && defined( __ELF__ ) && !defined( VEC_NO_SIMD_DISPATCH )
+#define VEC_SIMD_CLONES __attribute__(( target_clones( "avx512f", "avx2", "default" ) ))
+#endif
+#endif
+#ifndef VEC_SIMD_CLONES
+#define VEC_SIMD_CLONES
+#endif
+
+// the kernels on a vec_view_##T, the same in the declaration and the implementation
+#define vec_view_numeric_( T )                                                                              \
+/* set every element of the view to val */                                                                  \
+static inline void vec_view_fill_##T( vec_view_##T view, T val )                                            \
+{                                                                                                           \
+    vec_fill_arr_##T( view.data, view.size, val );                                                          \
+}                                                                                                           \
+/* sum of all elements of the view */                                                                       \
+static inline T vec_view_sum_##T( vec_view_##T view )                                                       \
+{                                                                                                           \
+    return vec_sum_arr_##T( view.data, view.size );                                                         \
+}                                                                                                           \
+/* smallest and largest element of the view, false when it is empty */                                      \
+static inline bool vec_view_minmax_##T( vec_view_##T view, T* min, T* max )                                 \
+{                                                                                                           \
+    return vec_minmax_arr_##T( view.data, view.size, min, max );                                            \
+}                                                                                                           \
+/* dot product over the common length of view and other */                                                  \
+static inline T vec_view_dot_##T( vec_view_##T view, vec_view_##T other )                                   \
+{                                                                                                           \
+    return vec_dot_arr_##T( view.data, other.data, view.size < other.size ? view.size : other.size );       \
+}                                                                                                           \
+/* view += a * other over their common length */                                                            \
+static inline void vec_view_axpy_##T( vec_view_##T view, T a, vec_view_##T other )                          \
+{                                                                                                           \
+    vec_axpy_arr_##T( view.data, a, other.data, view.size < other.size ? view.size : other.size );          \
+}                                                                                                           \
+/* multiply every element of the view by a */                                                               \
+static inline void vec_view_scale_##T( vec_view_##T view, T a )                                             \
+{                                                                                                           \
+    vec_scale_arr_##T( view.data, view.size, a );                                                           \
+}                                                                                                           \
+
+
+// generate the kernels for T, `using_vector( T )` must come first
+// the *_arr_##T kernels work on any array, the others on the size elements of a vector
+#ifndef VECTOR_IMPLEMENTATION
+#define using_vector_numeric( T )                                                                           \
+void vec_fill_arr_##T( T* arr, size_t size, T val );                                                        \
+T vec_sum_arr_##T( const T* arr, size_t size );                                                             \
+bool vec_minmax_arr_##T( const T* arr, size_t size, T* min, T* max );                                       \
+T vec_dot_arr_##T( const T* a, const T* b, size_t size );                                                   \
+void vec_axpy_arr_##T( T* y, T a, const T* x, size_t size );                                                \
+void vec_scale_arr_##T( T* arr, size_t size, T a );                                                         \
+T* vec_fill_##T( T* self, T val );                                                                          \
+T vec_sum_##T( T* self );                                                                                   \
+bool vec_minmax_##T( T* self, T* min, T* max );                                                             \
+T vec_dot_##T( T* a, T* b );                                                                                \
+T* vec_axpy_##T( T* y, T a, T* x );                                                                         \
+T* vec_scale_##T( T* self, T a );                                                                           \
+vec_view_numeric_( T )                                                                                      \
+
+#endif  // VECTOR_IMPLEMENTATION
+#endif  // __VEC_SIMD_H__
+
+
+#ifdef VECTOR_IMPLEMENTATION
+#define using_vector_numeric( T )                                                                           \
+/* set every element of arr to val */                                                                       \
+VEC_SIMD_CLONES void vec_fill_arr_##T( T* arr, size_t size, T val )                                         \
+{                                                                                                           \
+    for ( size_t i = 0; i < size; i++ )                                                                     \
+    {                                                                                                       \
+        arr[i] = val;                                                                                       \
+    }                                                                                                       \
+}                                                                                                           \
+/* sum of all elements, 0 when empty */                                                                     \
+VEC_SIMD_CLONES T vec_sum_arr_##T( const T* arr, size_t size )                                              \
+{                                                                                                           \
+    T acc[ VEC_SIMD_LANES ] = { 0 };                                                                        \
+    size_t i = 0;                                                                                           \
+    for ( ; i + VEC_SIMD_LANES <= size; i += VEC_SIMD_LANES )                                               \
+    {                                                                                                       \
+        for ( size_t j = 0; j < VEC_SIMD_LANES; j++ ) acc[j] += arr[ i + j ];                               \
+    }                                                                                                       \
+    T sum = 0;                                                                                              \
+    for ( ; i < size; i++ ) sum += arr[i];                                                                  \
+    for ( size_t j = 0; j < VEC_SIMD_LANES; j++ ) sum += acc[j];                                            \
+    return sum;                                                                                             \
+}                                                                                                           \
+/* smallest and largest element, false and untouched outputs when empty */                                  \
+VEC_SIMD_CLONES bool vec_minmax_arr_##T( const T* arr, size_t size, T* min, T* max )                        \
+{                                                                                                           \
+    if ( size == 0 ) return false;                                                                          \
+    T lo[ VEC_SIMD_LANES ], hi[ VEC_SIMD_LANES ];                                                           \
+    for ( size_t j = 0; j < VEC_SIMD_LANES; j++ ) lo[j] = hi[j] = arr[0];                                   \
+    size_t i = 0;                                                                                           \
+    for ( ; i + VEC_SIMD_LANES <= size; i += VEC_SIMD_LANES )                                               \
+    {                                                                                                       \
+        for ( size_t j = 0; j < VEC_SIMD_LANES; j++ )                                                       \
+        {                                                                                                   \
+            lo[j] = arr[ i + j ] < lo[j] ? arr[ i + j ] : lo[j];                                            \
+            hi[j] = arr[ i + j ] > hi[j] ? arr[ i + j ] : hi[j];                                            \
+        }                                                                                                   \
+    }                                                                                                       \
+    for ( ; i < size; i++ )                                                                                 \
+    {                                                                                                       \
+        lo[0] = arr[i] < lo[0] ? arr[i] : lo[0];                                                            \
+        hi[0] = arr[i] > hi[0] ? arr[i] : hi[0];                                                            \
+    }                                                                                                       \
+    for ( size_t j = 1; j < VEC_SIMD_LANES; j++ )                                                           \
+    {                                                                                                       \
+        lo[0] = lo[j] < lo[0] ? lo[j] : lo[0];                                                              \
+        hi[0] = hi[j] > hi[0] ? hi[j] : hi[0];                                                              \
+    }                                                                                                       \
+    *min = lo[0];                                                                                           \
+    *max = hi[0];                                                                                           \
+    return true;                                                                                            \
+}                                                                                                           \
+/* sum of a[i] * b[i] */                                                                                    \
+VEC_SIMD_CLONES T vec_dot_arr_##T( const T* a, const T* b, size_t size )                                    \
+{                                                                                                           \
+    T acc[ VEC_SIMD_LANES ] = { 0 };                                                                        \
+    size_t i = 0;                                                                                           \
+    for ( ; i + VEC_SIMD_LANES <= size; i += VEC_SIMD_LANES )                                               \
+    {                                                                                                       \
+        for ( size_t j = 0; j < VEC_SIMD_LANES; j++ ) acc[j] += a[ i + j ] * b[ i + j ];                    \
+    }                                                                                                       \
+    T sum = 0;                                                                                              \
+    for ( ; i < size; i++ ) sum += a[i] * b[i];                                                             \
+    for ( size_t j = 0; j < VEC_SIMD_LANES; j++ ) sum += acc[j];                                            \
+    return sum;                                                                                             \
+}                                                                                                           \
+/* y[i] += a * x[i] */                                                                                      \
+VEC_SIMD_CLONES void vec_axpy_arr_##T( T* y, T a, const T* x, size_t size )                                 \
+{                                                                                                           \
+    for ( size_t i = 0; i < size; i++ )                                                                     \
+    {                                                                                                       \
+        y[i] += a * x[i];                                                                                   \
+    }                                                                                                       \
+}                                                                                                           \
+/* arr[i] *= a */                                                                                           \
+VEC_SIMD_CLONES void vec_scale_arr_##T( T* arr, size_t size, T a )                                          \
+{                                                                                                           \
+    for ( size_t i = 0; i < size; i++ )                                                                     \
+    {                                                                                                       \
+        arr[i] *= a;                                                                                        \
+    }                                                                                                       \
+}                                                                                                           \
+/* set every element of the vector to val, the size does not change */                                      \
+T* vec_fill_##T( T* self, T val )                                                                           \
+{                                                                                                           \
+    VEC_COW_( self = vec_unshare_##T( self ); )                                                             \
+    vec_fill_arr_##T( self, vec_size_##T( self ), val );                                                    \
+    return self;                                                                                            \
+}                                                                                                           \
+/* sum of all elements of the vector */                                                                     \
+T vec_sum_##T( T* self )                                                                                    \
+{                                                                                                           \
+    return vec_sum_arr_##T( self, vec_size_##T( self ) );                                                   \
+}                                                                                                           \
+/* smallest and largest element of the vector, false when it is empty */                                    \
+bool vec_minmax_##T( T* self, T* min, T* max )                                                              \
+{                                                                                                           \
+    return vec_minmax_arr_##T( self, vec_size_##T( self ), min, max );                                      \
+}                                                                                                           \
+/* dot product over the common length of a and b */                                                         \
+T vec_dot_##T( T* a, T* b )                                                                                 \
+{                                                                                                           \
+    size_t size = vec_size_##T( a ) < vec_size_##T( b ) ? vec_size_##T( a ) : vec_size_##T( b );            \
+    return vec_dot_arr_##T( a, b, size );                                                                   \
+}                                                                                                           \
+/* y += a * x over the common length of y and x */                                                          \
+T* vec_axpy_##T( T* y, T a, T* x )                                                                          \
+{                                                                                                           \
+    VEC_COW_( y = vec_unshare_##T( y ); )                                                                   \
+    size_t size = vec_size_##T( y ) < vec_size_##T( x ) ? vec_size_##T( y ) : vec_size_##T( x );            \
+    vec_axpy_arr_##T( y, a, x, size );                                                                      \
+    return y;                                                                                               \
+}                                                                                                           \
+/* multiply every element of the vector by a */                                                             \
+T* vec_scale_##T( T* self, T a )                                                                            \
+{                                                                                                           \
+    VEC_COW_( self = vec_unshare_##T( self ); )                                                             \
+    vec_scale_arr_##T( self, vec_size_##T( self ), a );                                                     \
+    return self;                                                                                            \
+}                                                                                                           \
+vec_view_numeric_( T )                                                                                      \
+
+#endif  // VECTOR_IMPLEMENTATION
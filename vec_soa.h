@@ -0,0 +1,361 @@
+#ifndef __VEC_SOA_H__
+#define __VEC_SOA_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "vector.h"
+
+
+// structure-of-arrays vector: `using_soa_vector( Name, ( type, field )... )` stores one contiguous column per
+// field instead of an array of structs, so a scan over one field reads only that field's bytes
+// the vector is a Name* pointing at a header that holds the size, the capacity, the allocator and a pointer
+// to every column, self->field is the column of field and can be handed straight to the vec_simd.h kernels
+// the API follows the AoS one: vec_push_back_##Name, vec_pop_back_##Name, vec_resize_##Name ... take and
+// return Name*, rows go in and out as Name##_row structs, the functions that return a new Name* may move it
+// columns start on VEC_SOA_ALIGN boundaries, one allocation holds the header and all columns
+// the block itself only asks for VEC_HEADER_ALIGN, so growing goes through realloc ( mremap for large
+// blocks ) and the columns are then spread out inside the grown block instead of copied to a new one
+#ifndef VEC_SOA_ALIGN
+#define VEC_SOA_ALIGN 64
+#endif
+#define VEC_SOA_ROUND_( bytes ) ( ( (size_t) ( bytes ) + VEC_SOA_ALIGN - 1 ) / VEC_SOA_ALIGN * VEC_SOA_ALIGN )
+// offset of the first column in a block starting at base
+#define VEC_SOA_START_( base, header ) ( VEC_SOA_ROUND_( (uintptr_t) ( base ) + ( header ) ) - (uintptr_t) ( base ) )
+
+// apply M( Name, type, field ) to every ( type, field ) pair, up to 16 fields
+#define VEC_SOA_CAT_( a, b ) VEC_SOA_CAT__( a, b )
+#define VEC_SOA_CAT__( a, b ) a##b
+#define VEC_SOA_COUNT_( ... ) VEC_SOA_COUNT__( __VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 )
+#define VEC_SOA_COUNT__( _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, N, ... ) N
+#define VEC_SOA_UNPACK_( type, field ) type, field
+#define VEC_SOA_CALL_( M, Name, P ) VEC_SOA_CALL__( M, Name, VEC_SOA_UNPACK_ P )
+#define VEC_SOA_CALL__( M, ... ) M( __VA_ARGS__ )
+#define VEC_SOA_EACH_( M, Name, ... )                                                                       \
+    VEC_SOA_CAT_( VEC_SOA_EACH_, VEC_SOA_COUNT_( __VA_ARGS__ ) )( M, Name, __VA_ARGS__ )
+#define VEC_SOA_EACH_1( M, Name, P ) VEC_SOA_CALL_( M, Name, P )
+#define VEC_SOA_EACH_2( M, Name, P, ... ) VEC_SOA_CALL_( M, Name, P ) VEC_SOA_EACH_1( M, Name, __VA_ARGS__ )
+#define VEC_SOA_EACH_3( M, Name, P, ... ) VEC_SOA_CALL_( M, Name, P ) VEC_SOA_EACH_2( M, Name, __VA_ARGS__ )
+#define VEC_SOA_EACH_4( M, Name, P, ... ) VEC_SOA_CALL_( M, Name, P ) VEC_SOA_EACH_3( M, Name, __VA_ARGS__ )
+#define VEC_SOA_EACH_5( M, Name, P, ... ) VEC_SOA_CALL_( M, Name, P ) VEC_SOA_EACH_4( M, Name, __VA_ARGS__ )
+#define VEC_SOA_EACH_6( M, Name, P, ... ) VEC_SOA_CALL_( M, Name, P ) VEC_SOA_EACH_5( M, Name, __VA_ARGS__ )
+#define VEC_SOA_EACH_7( M, Name, P, ... ) VEC_SOA_CALL_( M, Name, P ) VEC_SOA_EACH_6( M, Name, __VA_ARGS__ )
+#define VEC_SOA_EACH_8( M, Name, P, ... ) VEC_SOA_CALL_( M, Name, P ) VEC_SOA_EACH_7( M, Name, __VA_ARGS__ )
+#define VEC_SOA_EACH_9( M, Name, P, ... ) VEC_SOA_CALL_( M, Name, P ) VEC_SOA_EACH_8( M, Name, __VA_ARGS__ )
+#define VEC_SOA_EACH_10( M, Name, P, ... ) VEC_SOA_CALL_( M, Name, P ) VEC_SOA_EACH_9( M, Name, __VA_ARGS__ )
+#define VEC_SOA_EACH_11( M, Name, P, ... ) VEC_SOA_CALL_( M, Name, P ) VEC_SOA_EACH_10( M, Name, __VA_ARGS__ )
+#define VEC_SOA_EACH_12( M, Name, P, ... ) VEC_SOA_CALL_( M, Name, P ) VEC_SOA_EACH_11( M, Name, __VA_ARGS__ )
+#define VEC_SOA_EACH_13( M, Name, P, ... ) VEC_SOA_CALL_( M, Name, P ) VEC_SOA_EACH_12( M, Name, __VA_ARGS__ )
+#define VEC_SOA_EACH_14( M, Name, P, ... ) VEC_SOA_CALL_( M, Name, P ) VEC_SOA_EACH_13( M, Name, __VA_ARGS__ )
+#define VEC_SOA_EACH_15( M, Name, P, ... ) VEC_SOA_CALL_( M, Name, P ) VEC_SOA_EACH_14( M, Name, __VA_ARGS__ )
+#define VEC_SOA_EACH_16( M, Name, P, ... ) VEC_SOA_CALL_( M, Name, P ) VEC_SOA_EACH_15( M, Name, __VA_ARGS__ )
+
+// the per-field pieces of the generated code
+#define vec_soa_row_field_( Name, type, field ) type field;
+#define vec_soa_column_field_( Name, type, field ) type* field;
+#define vec_soa_bytes_field_( Name, type, field ) + VEC_SOA_ROUND_( capacity * sizeof ( type ) )
+#define vec_soa_layout_field_( Name, type, field )                                                          \
+    self->field = (type*) at;                                                                               \
+    at += VEC_SOA_ROUND_( capacity * sizeof ( type ) );
+#define vec_soa_copy_field_( Name, type, field ) memcpy( to->field, from->field, size * sizeof ( type ) );
+#define vec_soa_offset_field_( Name, type, field )                                                          \
+    width[ count ] = sizeof ( type );                                                                       \
+    old_at[ count ] = old_end;                                                                              \
+    new_at[ count++ ] = new_end;                                                                            \
+    old_end += VEC_SOA_ROUND_( from->capacity * sizeof ( type ) );                                          \
+    new_end += VEC_SOA_ROUND_( capacity * sizeof ( type ) );
+#define vec_soa_store_field_( Name, type, field ) self->field[ position ] = val.field;
+#define vec_soa_load_field_( Name, type, field ) row.field = self->field[ position ];
+#define vec_soa_move_field_( Name, type, field ) data->field[ position ] = data->field[ last ];
+
+// the row and vector types and the hot paths, expanded the same way in the header and in vec.c
+#define vec_soa_common_( Name, ... )                                                                        \
+typedef struct Name##_row                                                                                   \
+{                                                                                                           \
+    VEC_SOA_EACH_( vec_soa_row_field_, Name, __VA_ARGS__ )                                                  \
+} Name##_row;                                                                                               \
+typedef struct Name                                                                                         \
+{                                                                                                           \
+    size_t size;                                                                                            \
+    size_t capacity;                                                                                        \
+    const vec_allocator* alloc;                                                                             \
+    VEC_SOA_EACH_( vec_soa_column_field_, Name, __VA_ARGS__ )                                               \
+} Name;                                                                                                     \
+/* slow paths of push_back and pop_back, defined with the rest of the vector */                             \
+int vec_try_grow_##Name( Name** self, size_t size );                                                        \
+Name* vec_grow_##Name( Name* self, size_t size );                                                           \
+Name* vec_shrink_##Name( Name* self );                                                                      \
+/* Returns the number of rows in the vector */                                                              \
+static inline size_t vec_size_##Name( Name* self )                                                          \
+{                                                                                                           \
+    return self->size;                                                                                      \
+}                                                                                                           \
+/* get the allocated size for the vector in terms of rows */                                                \
+static inline size_t vec_capacity_##Name( Name* self )                                                      \
+{                                                                                                           \
+    return self->capacity;                                                                                  \
+}                                                                                                           \
+/* gather the row at position from the columns, position must be below the size */                          \
+static inline Name##_row vec_get_##Name( Name* self, size_t position )                                      \
+{                                                                                                           \
+    Name##_row row;                                                                                         \
+    VEC_SOA_EACH_( vec_soa_load_field_, Name, __VA_ARGS__ )                                                 \
+    return row;                                                                                             \
+}                                                                                                           \
+/* scatter val into the columns at position, position must be below the size */                             \
+static inline void vec_set_##Name( Name* self, size_t position, Name##_row val )                            \
+{                                                                                                           \
+    VEC_SOA_EACH_( vec_soa_store_field_, Name, __VA_ARGS__ )                                                \
+}                                                                                                           \
+/* Adds a new row at the end of the vector */                                                               \
+static inline Name* vec_push_back_##Name( Name* self, Name##_row val )                                      \
+{                                                                                                           \
+    if ( VEC_UNLIKELY( self->size == self->capacity ) ) self = vec_grow_##Name( self, self->size + 1 );     \
+    vec_set_##Name( self, self->size++, val );                                                              \
+    return self;                                                                                            \
+}                                                                                                           \
+/* push_back reporting VEC_ERR_NOMEM instead of exiting, *self is untouched on failure */                   \
+static inline int vec_try_push_back_##Name( Name** self, Name##_row val )                                   \
+{                                                                                                           \
+    if ( VEC_UNLIKELY( ( *self )->size == ( *self )->capacity ) )                                           \
+    {                                                                                                       \
+        int err = vec_try_grow_##Name( self, ( *self )->size + 1 );                                         \
+        if ( VEC_UNLIKELY( err ) ) return err;                                                              \
+    }                                                                                                       \
+    vec_set_##Name( *self, ( *self )->size++, val );                                                        \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+/* pop_back reporting VEC_ERR_EMPTY instead of exiting */                                                   \
+static inline int vec_try_pop_back_##Name( Name** self )                                                    \
+{                                                                                                           \
+    if ( VEC_UNLIKELY( ( *self )->size == 0 ) ) return VEC_ERR_EMPTY;                                       \
+    ( *self )->size--;                                                                                      \
+    if ( VEC_UNLIKELY( ( *self )->size < ( *self )->capacity / VEC_SHRINK_FACTOR ) )                        \
+    {                                                                                                       \
+        if ( ( *self )->capacity > VEC_MIN_CAPACITY ) *self = vec_shrink_##Name( *self );                   \
+    }                                                                                                       \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+/* Removes the last row in the vector */                                                                    \
+static inline Name* vec_pop_back_##Name( Name* self )                                                       \
+{                                                                                                           \
+    int err = vec_try_pop_back_##Name( &self );                                                             \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+
+
+// generate the SoA vector Name with the given ( type, field ) columns, e.g.
+// using_soa_vector( particles, ( float, x ), ( float, y ), ( float, mass ), ( int, id ) )
+#ifndef VECTOR_IMPLEMENTATION
+#define using_soa_vector( Name, ... )                                                                       \
+vec_soa_common_( Name, __VA_ARGS__ )                                                                        \
+Name* vec_new_##Name( size_t size, Name##_row val );                                                        \
+Name* vec_new_with_alloc_##Name( size_t size, Name##_row val, const vec_allocator* alloc );                 \
+Name* vec_resize_##Name( Name* self, size_t size, Name##_row val );                                         \
+Name* vec_clear_##Name( Name* self );                                                                       \
+Name* vec_shrink_to_fit_##Name( Name* self );                                                               \
+Name* vec_reserve_##Name( Name* self, size_t size );                                                        \
+Name* vec_swap_remove_##Name( Name* self, size_t position );                                                \
+void vec_destroy_##Name( Name* self );                                                                      \
+int vec_try_new_##Name( Name** self, size_t size, Name##_row val );                                         \
+int vec_try_new_with_alloc_##Name( Name** self, size_t size, Name##_row val, const vec_allocator* alloc );  \
+int vec_try_resize_##Name( Name** self, size_t size, Name##_row val );                                      \
+int vec_try_reserve_##Name( Name** self, size_t size );                                                     \
+int vec_try_swap_remove_##Name( Name** self, size_t position );                                             \
+
+#endif  // VECTOR_IMPLEMENTATION
+#endif  // __VEC_SOA_H__
+
+
+#ifdef VECTOR_IMPLEMENTATION
+#define using_soa_vector( Name, ... )                                                                       \
+vec_soa_common_( Name, __VA_ARGS__ )                                                                        \
+/* size of the block holding the header and capacity rows, with room to align the first column */           \
+static inline size_t vec_bytes_##Name( size_t capacity )                                                    \
+{                                                                                                           \
+    return sizeof ( Name ) + VEC_SOA_ALIGN VEC_SOA_EACH_( vec_soa_bytes_field_, Name, __VA_ARGS__ );        \
+}                                                                                                           \
+/* point every column of self into its block of capacity rows */                                            \
+static inline void vec_soa_layout_##Name( Name* self, size_t capacity )                                     \
+{                                                                                                           \
+    char* at = (char*) self + VEC_SOA_START_( self, sizeof ( Name ) );                                      \
+    VEC_SOA_EACH_( vec_soa_layout_field_, Name, __VA_ARGS__ )                                               \
+}                                                                                                           \
+/* grow the vector in place to a block of capacity rows, NULL and the vector untouched on failure */        \
+static Name* vec_soa_expand_##Name( Name* from, size_t capacity )                                           \
+{                                                                                                           \
+    size_t width[ 16 ], old_at[ 16 ], new_at[ 16 ];                                                         \
+    size_t count = 0, old_end = 0, new_end = 0;                                                             \
+    VEC_SOA_EACH_( vec_soa_offset_field_, Name, __VA_ARGS__ )                                               \
+    size_t start = VEC_SOA_START_( from, sizeof ( Name ) );                                                 \
+    Name* to = vec_mem_realloc( from->alloc, from, vec_bytes_##Name( from->capacity ),                      \
+                                vec_bytes_##Name( capacity ), VEC_HEADER_ALIGN );                           \
+    if ( VEC_UNLIKELY( to == NULL ) ) return NULL;                                                          \
+    /* the columns only move up, so spreading them from the last one down never overwrites one not yet moved */ \
+    char* base = (char*) to + start;                                                                        \
+    for ( size_t i = count; i-- > 1; )                                                                      \
+    {                                                                                                       \
+        memmove( base + new_at[i], base + old_at[i], to->size * width[i] );                                 \
+    }                                                                                                       \
+    /* a block that moved to a different offset from VEC_SOA_ALIGN shifts every column by the same amount */ \
+    size_t aligned = VEC_SOA_START_( to, sizeof ( Name ) );                                                 \
+    if ( aligned != start ) memmove( (char*) to + aligned, base, new_end );                                 \
+    to->capacity = capacity;                                                                                \
+    vec_soa_layout_##Name( to, capacity );                                                                  \
+    return to;                                                                                              \
+}                                                                                                           \
+/* move the vector to a block of exactly capacity rows, keeping the first capacity rows */                  \
+/* NULL when growing fails, a failed shrink keeps the current block */                                      \
+static Name* vec_set_capacity_##Name( Name* from, size_t capacity )                                         \
+{                                                                                                           \
+    if ( VEC_UNLIKELY( capacity > SIZE_MAX / 2 / sizeof ( Name##_row ) ) ) return NULL;                     \
+    if ( capacity > from->capacity ) return vec_soa_expand_##Name( from, capacity );                        \
+    /* shrinking copies at most a quarter of the old rows into a fresh block */                             \
+    Name* to = vec_mem_alloc( from->alloc, vec_bytes_##Name( capacity ), VEC_HEADER_ALIGN );                \
+    if ( VEC_UNLIKELY( to == NULL ) ) return from;                                                          \
+    size_t size = from->size < capacity ? from->size : capacity;                                            \
+    to->size = size;                                                                                        \
+    to->capacity = capacity;                                                                                \
+    to->alloc = from->alloc;                                                                                \
+    vec_soa_layout_##Name( to, capacity );                                                                  \
+    VEC_SOA_EACH_( vec_soa_copy_field_, Name, __VA_ARGS__ )                                                 \
+    vec_mem_free( from->alloc, from, vec_bytes_##Name( from->capacity ), VEC_HEADER_ALIGN );                \
+    return to;                                                                                              \
+}                                                                                                           \
+/* slow path of try_push_back, grows *self to hold size rows following the growth policy */                 \
+VEC_COLD int vec_try_grow_##Name( Name** self, size_t size )                                                \
+{                                                                                                           \
+    size_t capacity = vec_grow_capacity( ( *self )->capacity, size, sizeof ( Name##_row ),                  \
+                                         VEC_GROWTH_DEFAULT );                                              \
+    Name* grown = vec_set_capacity_##Name( *self, capacity );                                               \
+    if ( VEC_UNLIKELY( grown == NULL ) ) return VEC_ERR_NOMEM;                                              \
+    *self = grown;                                                                                          \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+/* slow path of push_back, only taken when the vector is full */                                            \
+VEC_COLD Name* vec_grow_##Name( Name* self, size_t size )                                                   \
+{                                                                                                           \
+    int err = vec_try_grow_##Name( &self, size );                                                           \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* slow path of pop_back, only taken when the vector dropped below 1 / VEC_SHRINK_FACTOR of its capacity */ \
+VEC_COLD Name* vec_shrink_##Name( Name* self )                                                              \
+{                                                                                                           \
+    return vec_set_capacity_##Name( self, vec_shrink_capacity( self->capacity, self->size ) );              \
+}                                                                                                           \
+/* create a vector of size rows, all set to val, its memory comes from alloc ( NULL for malloc ) */         \
+int vec_try_new_with_alloc_##Name( Name** self, size_t size, Name##_row val, const vec_allocator* alloc )   \
+{                                                                                                           \
+    size_t capacity = vec_grow_capacity( 0, size, sizeof ( Name##_row ), VEC_GROWTH_DEFAULT );              \
+    if ( VEC_UNLIKELY( capacity > SIZE_MAX / 2 / sizeof ( Name##_row ) ) ) return VEC_ERR_NOMEM;            \
+    Name* data = vec_mem_alloc( alloc, vec_bytes_##Name( capacity ), VEC_HEADER_ALIGN );                    \
+    if ( VEC_UNLIKELY( data == NULL ) ) return VEC_ERR_NOMEM;                                               \
+    data->size = size;                                                                                      \
+    data->capacity = capacity;                                                                              \
+    data->alloc = alloc;                                                                                    \
+    vec_soa_layout_##Name( data, capacity );                                                                \
+    for ( size_t i = 0; i < size; i++ )                                                                     \
+    {                                                                                                       \
+        vec_set_##Name( data, i, val );                                                                     \
+    }                                                                                                       \
+    *self = data;                                                                                           \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+Name* vec_new_with_alloc_##Name( size_t size, Name##_row val, const vec_allocator* alloc )                  \
+{                                                                                                           \
+    Name* self;                                                                                             \
+    int err = vec_try_new_with_alloc_##Name( &self, size, val, alloc );                                     \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* create a vector of size rows, all set to val */                                                          \
+int vec_try_new_##Name( Name** self, size_t size, Name##_row val )                                          \
+{                                                                                                           \
+    return vec_try_new_with_alloc_##Name( self, size, val, NULL );                                          \
+}                                                                                                           \
+Name* vec_new_##Name( size_t size, Name##_row val )                                                         \
+{                                                                                                           \
+    return vec_new_with_alloc_##Name( size, val, NULL );                                                    \
+}                                                                                                           \
+/* change vector to size rows, new rows are set to val */                                                   \
+int vec_try_resize_##Name( Name** self, size_t size, Name##_row val )                                       \
+{                                                                                                           \
+    Name* data = *self;                                                                                     \
+    size_t capacity;                                                                                        \
+    if ( size > data->capacity )                                                                            \
+    {                                                                                                       \
+        capacity = vec_grow_capacity( data->capacity, size, sizeof ( Name##_row ), VEC_GROWTH_DEFAULT );    \
+    }                                                                                                       \
+    else capacity = vec_shrink_capacity( data->capacity, size );                                            \
+    if ( capacity != data->capacity )                                                                       \
+    {                                                                                                       \
+        data = vec_set_capacity_##Name( data, capacity );                                                   \
+        if ( VEC_UNLIKELY( data == NULL ) ) return VEC_ERR_NOMEM;                                           \
+    }                                                                                                       \
+    for ( size_t i = data->size; i < size; i++ )                                                            \
+    {                                                                                                       \
+        vec_set_##Name( data, i, val );                                                                     \
+    }                                                                                                       \
+    data->size = size;                                                                                      \
+    *self = data;                                                                                           \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+Name* vec_resize_##Name( Name* self, size_t size, Name##_row val )                                          \
+{                                                                                                           \
+    int err = vec_try_resize_##Name( &self, size, val );                                                    \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* remove every row, keeps the capacity */                                                                  \
+Name* vec_clear_##Name( Name* self )                                                                        \
+{                                                                                                           \
+    self->size = 0;                                                                                         \
+    return self;                                                                                            \
+}                                                                                                           \
+/* give back the capacity above the size */                                                                 \
+Name* vec_shrink_to_fit_##Name( Name* self )                                                                \
+{                                                                                                           \
+    size_t capacity = self->size < VEC_MIN_CAPACITY ? VEC_MIN_CAPACITY : self->size;                        \
+    if ( capacity >= self->capacity ) return self;                                                          \
+    return vec_set_capacity_##Name( self, capacity );                                                       \
+}                                                                                                           \
+/* Requests that the vector capacity be at least enough to contain size rows */                             \
+int vec_try_reserve_##Name( Name** self, size_t size )                                                      \
+{                                                                                                           \
+    if ( size <= ( *self )->capacity ) return VEC_OK;                                                       \
+    Name* data = vec_set_capacity_##Name( *self, size );                                                    \
+    if ( VEC_UNLIKELY( data == NULL ) ) return VEC_ERR_NOMEM;                                               \
+    *self = data;                                                                                           \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+Name* vec_reserve_##Name( Name* self, size_t size )                                                         \
+{                                                                                                           \
+    int err = vec_try_reserve_##Name( &self, size );                                                        \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* remove the row at position by moving the last row into its place, O(1) but does not keep the order */    \
+int vec_try_swap_remove_##Name( Name** self, size_t position )                                              \
+{                                                                                                           \
+    Name* data = *self;                                                                                     \
+    if ( VEC_UNLIKELY( position >= data->size ) ) return VEC_ERR_RANGE;                                     \
+    size_t last = data->size - 1;                                                                           \
+    VEC_SOA_EACH_( vec_soa_move_field_, Name, __VA_ARGS__ )                                                 \
+    return vec_try_pop_back_##Name( self );                                                                 \
+}                                                                                                           \
+Name* vec_swap_remove_##Name( Name* self, size_t position )                                                 \
+{                                                                                                           \
+    int err = vec_try_swap_remove_##Name( &self, position );                                                \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* free the block holding the header and every column */                                                    \
+void vec_destroy_##Name( Name* self )                                                                       \
+{                                                                                                           \
+    vec_mem_free( self->alloc, self, vec_bytes_##Name( self->capacity ), VEC_HEADER_ALIGN );                \
+}                                                                                                           \
+
+#endif  // VECTOR_IMPLEMENTATION
@@ -0,0 +1,403 @@
+#ifndef __VEC_SORT_H__
+#define __VEC_SORT_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "vector.h"
+
+
+// ordering operations specialized per type, the comparison is expanded inline instead of called through
+// a function pointer like qsort does
+// `using_vector_sort( T, LESS )` needs LESS( a, b ) to be true when a goes before b, a function-like macro
+// or a function, e.g. VEC_LESS for arithmetic types or `#define by_id( a, b ) ( (a).id < (b).id )`
+// `using_vector_radix( T, KEY )` needs KEY( x ) to map an element to an unsigned 64-bit key in the same order
+// both need `using_vector( T )` first, the *_arr_##T versions work on any array and the vec_view_*_##T
+// versions on a vec_view_##T
+#ifndef VEC_SORT_INSERTION
+#define VEC_SORT_INSERTION 16           // partitions this small are finished by insertion sort
+#endif
+#ifndef VEC_SORT_RUN
+#define VEC_SORT_RUN 32                 // the stable sort insertion sorts runs this long before merging
+#endif
+
+#define VEC_LESS( a, b ) ( (a) < (b) )
+
+// radix keys for the common element types
+#define VEC_KEY_UNSIGNED( x ) ( (uint64_t) ( x ) )
+#define VEC_KEY_I32( x ) ( (uint64_t) ( (uint32_t) ( x ) ^ UINT32_C( 0x80000000 ) ) )
+#define VEC_KEY_I64( x ) ( (uint64_t) ( x ) ^ ( UINT64_C( 1 ) << 63 ) )
+#define VEC_KEY_FLOAT( x ) vec_key_float_( x )
+#define VEC_KEY_DOUBLE( x ) vec_key_double_( x )
+
+// flip the sign bit of positive floats and every bit of negative ones so they sort as unsigned integers
+static inline uint64_t vec_key_float_( float x )
+{
+    uint32_t u;
+    memcpy( &u, &x, sizeof u );
+    return ( u & UINT32_C( 0x80000000 ) ) ? (uint32_t) ~u : u | UINT32_C( 0x80000000 );
+}
+
+static inline uint64_t vec_key_double_( double x )
+{
+    uint64_t u;
+    memcpy( &u, &x, sizeof u );
+    return ( u & ( UINT64_C( 1 ) << 63 ) ) ? ~u : u | ( UINT64_C( 1 ) << 63 );
+}
+
+// the ordering operations on a vec_view_##T, the same in the declaration and the implementation
+#define vec_view_sort_( T, LESS )                                                                           \
+/* sort the elements of the view, equal elements may be reordered */                                        \
+static inline void vec_view_sort_##T( vec_view_##T view )                                                   \
+{                                                                                                           \
+    vec_sort_arr_##T( view.data, view.size );                                                               \
+}                                                                                                           \
+/* sort the elements of the view keeping equal elements in order, VEC_ERR_NOMEM on failure */               \
+static inline int vec_view_try_stable_sort_##T( vec_view_##T view )                                         \
+{                                                                                                           \
+    return vec_stable_sort_arr_##T( view.data, view.size );                                                 \
+}                                                                                                           \
+static inline void vec_view_stable_sort_##T( vec_view_##T view )                                            \
+{                                                                                                           \
+    int err = vec_view_try_stable_sort_##T( view );                                                         \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+}                                                                                                           \
+/* lower bound in a sorted view, as an index into the view */                                               \
+static inline size_t vec_view_lower_bound_##T( vec_view_##T view, T val )                                   \
+{                                                                                                           \
+    return vec_lower_bound_arr_##T( view.data, view.size, val );                                            \
+}                                                                                                           \
+/* upper bound in a sorted view, as an index into the view */                                               \
+static inline size_t vec_view_upper_bound_##T( vec_view_##T view, T val )                                   \
+{                                                                                                           \
+    return vec_upper_bound_arr_##T( view.data, view.size, val );                                            \
+}                                                                                                           \
+/* whether a sorted view holds an element equal to val */                                                   \
+static inline bool vec_view_binary_search_##T( vec_view_##T view, T val )                                   \
+{                                                                                                           \
+    size_t i = vec_lower_bound_arr_##T( view.data, view.size, val );                                        \
+    return i < view.size && !LESS( val, view.data[i] );                                                     \
+}                                                                                                           \
+/* squeeze runs of equal elements of the view to the front, returns the view of the unique prefix */        \
+static inline vec_view_##T vec_view_unique_##T( vec_view_##T view )                                         \
+{                                                                                                           \
+    view.size = vec_unique_arr_##T( view.data, view.size );                                                 \
+    return view;                                                                                            \
+}                                                                                                           \
+
+#define vec_view_radix_( T )                                                                                \
+/* radix sort the elements of the view, VEC_ERR_NOMEM if the scatter buffer cannot be allocated */          \
+static inline int vec_view_try_radix_sort_##T( vec_view_##T view )                                          \
+{                                                                                                           \
+    return vec_radix_sort_arr_##T( view.data, view.size );                                                  \
+}                                                                                                           \
+static inline void vec_view_radix_sort_##T( vec_view_##T view )                                             \
+{                                                                                                           \
+    int err = vec_view_try_radix_sort_##T( view );                                                          \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+}                                                                                                           \
+
+
+#ifndef VECTOR_IMPLEMENTATION
+#define using_vector_sort( T, LESS )                                                                        \
+void vec_sort_arr_##T( T* arr, size_t size );                                                               \
+int vec_stable_sort_arr_##T( T* arr, size_t size );                                                         \
+size_t vec_lower_bound_arr_##T( const T* arr, size_t size, T val );                                         \
+size_t vec_upper_bound_arr_##T( const T* arr, size_t size, T val );                                         \
+size_t vec_unique_arr_##T( T* arr, size_t size );                                                           \
+T* vec_sort_##T( T* self );                                                                                 \
+T* vec_stable_sort_##T( T* self );                                                                          \
+int vec_try_stable_sort_##T( T* self );                                                                     \
+size_t vec_lower_bound_##T( T* self, T val );                                                               \
+size_t vec_upper_bound_##T( T* self, T val );                                                               \
+bool vec_binary_search_##T( T* self, T val );                                                               \
+T* vec_unique_##T( T* self );                                                                               \
+vec_view_sort_( T, LESS )                                                                                   \
+
+#define using_vector_radix( T, KEY )                                                                        \
+int vec_radix_sort_arr_##T( T* arr, size_t size );                                                          \
+T* vec_radix_sort_##T( T* self );                                                                           \
+int vec_try_radix_sort_##T( T* self );                                                                      \
+vec_view_radix_( T )                                                                                        \
+
+#endif  // VECTOR_IMPLEMENTATION
+#endif  // __VEC_SORT_H__
+
+
+#ifdef VECTOR_IMPLEMENTATION
+#define using_vector_sort( T, LESS )                                                                        \
+/* the base case of both sorts, also the whole sort for short arrays */                                     \
+static inline void vec_insertion_sort_##T( T* arr, size_t size )                                            \
+{                                                                                                           \
+    for ( size_t i = 1; i < size; i++ )                                                                     \
+    {                                                                                                       \
+        T val = arr[i];                                                                                     \
+        size_t j = i;                                                                                       \
+        while ( j > 0 && LESS( val, arr[ j - 1 ] ) )                                                        \
+        {                                                                                                   \
+            arr[j] = arr[ j - 1 ];                                                                          \
+            j--;                                                                                            \
+        }                                                                                                   \
+        arr[j] = val;                                                                                       \
+    }                                                                                                       \
+}                                                                                                           \
+/* move arr[root] down the max-heap of size elements */                                                     \
+static inline void vec_sift_down_##T( T* arr, size_t root, size_t size )                                    \
+{                                                                                                           \
+    T val = arr[ root ];                                                                                    \
+    for ( ;; )                                                                                              \
+    {                                                                                                       \
+        size_t child = 2 * root + 1;                                                                        \
+        if ( child >= size ) break;                                                                         \
+        if ( child + 1 < size && LESS( arr[ child ], arr[ child + 1 ] ) ) child++;                          \
+        if ( !LESS( val, arr[ child ] ) ) break;                                                            \
+        arr[ root ] = arr[ child ];                                                                         \
+        root = child;                                                                                       \
+    }                                                                                                       \
+    arr[ root ] = val;                                                                                      \
+}                                                                                                           \
+/* fallback of the introsort once the partitions keep coming out unbalanced */                              \
+static void vec_heap_sort_##T( T* arr, size_t size )                                                        \
+{                                                                                                           \
+    for ( size_t i = size / 2; i-- > 0; ) vec_sift_down_##T( arr, i, size );                                \
+    for ( size_t end = size; end-- > 1; )                                                                   \
+    {                                                                                                       \
+        T tmp = arr[0];                                                                                     \
+        arr[0] = arr[ end ];                                                                                \
+        arr[ end ] = tmp;                                                                                   \
+        vec_sift_down_##T( arr, 0, end );                                                                   \
+    }                                                                                                       \
+}                                                                                                           \
+/* quicksort with a median of three pivot and Hoare partition, recursing into the smaller half only */      \
+static void vec_introsort_##T( T* arr, size_t size, size_t depth )                                          \
+{                                                                                                           \
+    while ( size > VEC_SORT_INSERTION )                                                                     \
+    {                                                                                                       \
+        if ( depth-- == 0 )                                                                                 \
+        {                                                                                                   \
+            vec_heap_sort_##T( arr, size );                                                                 \
+            return;                                                                                         \
+        }                                                                                                   \
+        /* order first, middle and last, which also puts sentinels at both ends for the scans below */      \
+        size_t mid = ( size - 1 ) / 2;                                                                      \
+        T tmp;                                                                                              \
+        if ( LESS( arr[ mid ], arr[0] ) ) { tmp = arr[ mid ]; arr[ mid ] = arr[0]; arr[0] = tmp; }          \
+        if ( LESS( arr[ size - 1 ], arr[ mid ] ) )                                                          \
+        {                                                                                                   \
+            tmp = arr[ mid ]; arr[ mid ] = arr[ size - 1 ]; arr[ size - 1 ] = tmp;                          \
+            if ( LESS( arr[ mid ], arr[0] ) ) { tmp = arr[ mid ]; arr[ mid ] = arr[0]; arr[0] = tmp; }      \
+        }                                                                                                   \
+        T pivot = arr[ mid ];                                                                               \
+        size_t i = 0, j = size - 1;                                                                         \
+        for ( ;; )                                                                                          \
+        {                                                                                                   \
+            while ( LESS( arr[i], pivot ) ) i++;                                                            \
+            while ( LESS( pivot, arr[j] ) ) j--;                                                            \
+            if ( i >= j ) break;                                                                            \
+            tmp = arr[i]; arr[i] = arr[j]; arr[j] = tmp;                                                    \
+            i++;                                                                                            \
+            j--;                                                                                            \
+        }                                                                                                   \
+        size_t left = j + 1;                                                                                \
+        if ( left < size - left )                                                                           \
+        {                                                                                                   \
+            vec_introsort_##T( arr, left, depth );                                                          \
+            arr += left;                                                                                    \
+            size -= left;                                                                                   \
+        }                                                                                                   \
+        else                                                                                                \
+        {                                                                                                   \
+            vec_introsort_##T( arr + left, size - left, depth );                                            \
+            size = left;                                                                                    \
+        }                                                                                                   \
+    }                                                                                                       \
+    vec_insertion_sort_##T( arr, size );                                                                    \
+}                                                                                                           \
+/* unstable sort in O( n log n ) worst case */                                                              \
+void vec_sort_arr_##T( T* arr, size_t size )                                                                \
+{                                                                                                           \
+    size_t depth = 0;                                                                                       \
+    for ( size_t n = size; n > 1; n /= 2 ) depth += 2;                                                      \
+    vec_introsort_##T( arr, size, depth );                                                                  \
+}                                                                                                           \
+/* one pass of the merge sort, merges src[ lo, mid ) and src[ mid, hi ) into dst[ lo, hi ) */               \
+static inline void vec_merge_##T( const T* src, size_t lo, size_t mid, size_t hi, T* dst )                  \
+{                                                                                                           \
+    size_t i = lo, j = mid, k = lo;                                                                         \
+    while ( i < mid && j < hi ) dst[ k++ ] = LESS( src[j], src[i] ) ? src[ j++ ] : src[ i++ ];              \
+    while ( i < mid ) dst[ k++ ] = src[ i++ ];                                                              \
+    while ( j < hi ) dst[ k++ ] = src[ j++ ];                                                               \
+}                                                                                                           \
+/* stable bottom-up merge sort over runs of VEC_SORT_RUN, VEC_ERR_NOMEM and arr untouched if no buffer */   \
+int vec_stable_sort_arr_##T( T* arr, size_t size )                                                          \
+{                                                                                                           \
+    if ( size <= VEC_SORT_RUN )                                                                             \
+    {                                                                                                       \
+        vec_insertion_sort_##T( arr, size );                                                                \
+        return VEC_OK;                                                                                      \
+    }                                                                                                       \
+    T* buf = vec_default_alloc( size * sizeof ( T ), _Alignof( T ) );                                       \
+    if ( VEC_UNLIKELY( buf == NULL ) ) return VEC_ERR_NOMEM;                                                \
+    for ( size_t lo = 0; lo < size; lo += VEC_SORT_RUN )                                                    \
+    {                                                                                                       \
+        vec_insertion_sort_##T( arr + lo, size - lo < VEC_SORT_RUN ? size - lo : VEC_SORT_RUN );            \
+    }                                                                                                       \
+    T* src = arr;                                                                                           \
+    T* dst = buf;                                                                                           \
+    for ( size_t width = VEC_SORT_RUN; width < size; width *= 2 )                                           \
+    {                                                                                                       \
+        for ( size_t lo = 0; lo < size; lo += 2 * width )                                                   \
+        {                                                                                                   \
+            size_t mid = size - lo < width ? size : lo + width;                                             \
+            size_t hi = size - lo < 2 * width ? size : lo + 2 * width;                                      \
+            vec_merge_##T( src, lo, mid, hi, dst );                                                         \
+        }                                                                                                   \
+        T* tmp = src;                                                                                       \
+        src = dst;                                                                                          \
+        dst = tmp;                                                                                          \
+    }                                                                                                       \
+    if ( src != arr ) memcpy( arr, src, size * sizeof ( T ) );                                              \
+    free( buf );                                                                                            \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+/* index of the first element not less than val in a sorted array, size if there is none */                 \
+size_t vec_lower_bound_arr_##T( const T* arr, size_t size, T val )                                          \
+{                                                                                                           \
+    if ( size == 0 ) return 0;                                                                              \
+    const T* base = arr;                                                                                    \
+    while ( size > 1 )                                                                                      \
+    {                                                                                                       \
+        size_t half = size / 2;                                                                             \
+        base = LESS( base[ half ], val ) ? base + half : base;                                              \
+        size -= half;                                                                                       \
+    }                                                                                                       \
+    return (size_t) ( base - arr ) + LESS( *base, val );                                                    \
+}                                                                                                           \
+/* index of the first element greater than val in a sorted array, size if there is none */                  \
+size_t vec_upper_bound_arr_##T( const T* arr, size_t size, T val )                                          \
+{                                                                                                           \
+    if ( size == 0 ) return 0;                                                                              \
+    const T* base = arr;                                                                                    \
+    while ( size > 1 )                                                                                      \
+    {                                                                                                       \
+        size_t half = size / 2;                                                                             \
+        base = LESS( val, base[ half ] ) ? base : base + half;                                              \
+        size -= half;                                                                                       \
+    }                                                                                                       \
+    return (size_t) ( base - arr ) + !LESS( val, *base );                                                   \
+}                                                                                                           \
+/* squeeze runs of equal elements down to their first one, returns the new size */                          \
+size_t vec_unique_arr_##T( T* arr, size_t size )                                                            \
+{                                                                                                           \
+    if ( size < 2 ) return size;                                                                            \
+    size_t w = 1;                                                                                           \
+    for ( size_t r = 1; r < size; r++ )                                                                     \
+    {                                                                                                       \
+        if ( LESS( arr[ w - 1 ], arr[r] ) || LESS( arr[r], arr[ w - 1 ] ) ) arr[ w++ ] = arr[r];            \
+    }                                                                                                       \
+    return w;                                                                                               \
+}                                                                                                           \
+/* sort the vector, equal elements may be reordered */                                                      \
+T* vec_sort_##T( T* self )                                                                                  \
+{                                                                                                           \
+    VEC_COW_( self = vec_unshare_##T( self ); )                                                             \
+    vec_sort_arr_##T( self, vec_size_##T( self ) );                                                         \
+    return self;                                                                                            \
+}                                                                                                           \
+/* sort the vector keeping equal elements in order, VEC_ERR_NOMEM if the merge buffer cannot be allocated */ \
+/* it cannot hand back a copy, so it returns VEC_ERR_SHARED on a shared vector */                           \
+int vec_try_stable_sort_##T( T* self )                                                                      \
+{                                                                                                           \
+    VEC_COW_( if ( VEC_UNLIKELY( vec_is_shared_##T( self ) ) ) return VEC_ERR_SHARED; )                     \
+    return vec_stable_sort_arr_##T( self, vec_size_##T( self ) );                                           \
+}                                                                                                           \
+T* vec_stable_sort_##T( T* self )                                                                           \
+{                                                                                                           \
+    VEC_COW_( self = vec_unshare_##T( self ); )                                                             \
+    int err = vec_try_stable_sort_##T( self );                                                              \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* lower bound in a sorted vector */                                                                        \
+size_t vec_lower_bound_##T( T* self, T val )                                                                \
+{                                                                                                           \
+    return vec_lower_bound_arr_##T( self, vec_size_##T( self ), val );                                      \
+}                                                                                                           \
+/* upper bound in a sorted vector */                                                                        \
+size_t vec_upper_bound_##T( T* self, T val )                                                                \
+{                                                                                                           \
+    return vec_upper_bound_arr_##T( self, vec_size_##T( self ), val );                                      \
+}                                                                                                           \
+/* whether a sorted vector holds an element equal to val */                                                 \
+bool vec_binary_search_##T( T* self, T val )                                                                \
+{                                                                                                           \
+    size_t size = vec_size_##T( self );                                                                     \
+    size_t i = vec_lower_bound_arr_##T( self, size, val );                                                  \
+    return i < size && !LESS( val, self[i] );                                                               \
+}                                                                                                           \
+/* remove consecutive duplicates, on a sorted vector this leaves every value once */                        \
+T* vec_unique_##T( T* self )                                                                                \
+{                                                                                                           \
+    VEC_COW_( self = vec_unshare_##T( self ); )                                                             \
+    return vec_truncate_##T( self, vec_unique_arr_##T( self, vec_size_##T( self ) ) );                      \
+}                                                                                                           \
+vec_view_sort_( T, LESS )                                                                                   \
+
+#define using_vector_radix( T, KEY )                                                                        \
+/* LSD radix sort on the 64-bit KEY of each element, one byte per pass, stable */                           \
+/* bytes that are the same in every key are skipped, so 32-bit keys take at most 4 passes */                \
+int vec_radix_sort_arr_##T( T* arr, size_t size )                                                           \
+{                                                                                                           \
+    if ( size < 2 ) return VEC_OK;                                                                          \
+    size_t counts[8][256] = { { 0 } };                                                                      \
+    for ( size_t i = 0; i < size; i++ )                                                                     \
+    {                                                                                                       \
+        uint64_t key = KEY( arr[i] );                                                                       \
+        for ( size_t b = 0; b < 8; b++ ) counts[b][ ( key >> ( 8 * b ) ) & 255 ]++;                         \
+    }                                                                                                       \
+    T* buf = vec_default_alloc( size * sizeof ( T ), _Alignof( T ) );                                       \
+    if ( VEC_UNLIKELY( buf == NULL ) ) return VEC_ERR_NOMEM;                                                \
+    T* src = arr;                                                                                           \
+    T* dst = buf;                                                                                           \
+    uint64_t first = KEY( arr[0] );                                                                         \
+    for ( size_t b = 0; b < 8; b++ )                                                                        \
+    {                                                                                                       \
+        size_t* count = counts[b];                                                                          \
+        if ( count[ ( first >> ( 8 * b ) ) & 255 ] == size ) continue;                                      \
+        size_t offset = 0;                                                                                  \
+        for ( size_t d = 0; d < 256; d++ )                                                                  \
+        {                                                                                                   \
+            size_t c = count[d];                                                                            \
+            count[d] = offset;                                                                              \
+            offset += c;                                                                                    \
+        }                                                                                                   \
+        for ( size_t i = 0; i < size; i++ )                                                                 \
+        {                                                                                                   \
+            dst[ count[ ( KEY( src[i] ) >> ( 8 * b ) ) & 255 ]++ ] = src[i];                                \
+        }                                                                                                   \
+        T* tmp = src;                                                                                       \
+        src = dst;                                                                                          \
+        dst = tmp;                                                                                          \
+    }                                                                                                       \
+    if ( src != arr ) memcpy( arr, src, size * sizeof ( T ) );                                              \
+    free( buf );                                                                                            \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+/* radix sort the vector, VEC_ERR_NOMEM if the scatter buffer cannot be allocated */                        \
+/* and VEC_ERR_SHARED on a shared vector, like vec_try_stable_sort */                                       \
+int vec_try_radix_sort_##T( T* self )                                                                       \
+{                                                                                                           \
+    VEC_COW_( if ( VEC_UNLIKELY( vec_is_shared_##T( self ) ) ) return VEC_ERR_SHARED; )                     \
+    return vec_radix_sort_arr_##T( self, vec_size_##T( self ) );                                            \
+}                                                                                                           \
+T* vec_radix_sort_##T( T* self )                                                                            \
+{                                                                                                           \
+    VEC_COW_( self = vec_unshare_##T( self ); )                                                             \
+    int err = vec_try_radix_sort_##T( self );                                                               \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+vec_view_radix_( T )                                                                                        \
+
+#endif  // VECTOR_IMPLEMENTATION
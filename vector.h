@@ -5,30 +5,581 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+
+// where a vector gets its memory from, see vec_alloc.h for an arena and a pool
+// every call gets the exact size the block was allocated or last reallocated with
+typedef struct vec_allocator
+{
+    void* (*allocate)( void* ctx, size_t size, size_t align );
+    void* (*reallocate)( void* ctx, void* ptr, size_t old_size, size_t new_size, size_t align );
+    void  (*deallocate)( void* ctx, void* ptr, size_t size, size_t align );
+    void* ctx;              // passed back to every call
+} vec_allocator;
+
+// compile-time optional copy-on-write sharing, define VECTOR_COW in every translation unit
+// `vec_share_##T` hands the same block to one more owner by counting it in vec_meta, every vec_* call that
+// changes a shared vector copies it first and lets go of the shared block, the last `vec_destroy_##T` frees it
+// without VECTOR_COW, VEC_COW_( ... ) expands to nothing and the header keeps its size
+#ifdef VECTOR_COW
+#include <stdatomic.h>
+#define VEC_COW_( ... ) __VA_ARGS__
+#else
+#define VEC_COW_( ... )
+#endif
 
 typedef struct vec_meta
 {
     size_t size;            // number of elements in the vector
     size_t capacity;        // the total capacity of how many elements the vector can hold
+    const vec_allocator* alloc;     // allocator owning the block, NULL for malloc/realloc/free
+    size_t flags;           // VEC_FLAG_* bits describing the storage
+    VEC_COW_( _Atomic size_t shares; )      // owners of the block besides the first, see VECTOR_COW
 } vec_meta;
 
+// the data lives in caller-provided storage, see `vec_new_in_##T` and `using_small_vector`
+// such a vector is never reallocated or freed, it moves to alloc once it outgrows the storage
+#define VEC_FLAG_INLINE ( (size_t) 1 << 0 )
+
+// vec_meta sits right before the data, padded in front so that the data is aligned to the vector's alignment
+// every vector is at least VEC_HEADER_ALIGN aligned, `using_vector_aligned( T, A )` asks for more
+#define VEC_HEADER_ALIGN 16
+#define VEC_ALIGNMENT( align ) ( (size_t) ( align ) > VEC_HEADER_ALIGN ? (size_t) ( align ) : (size_t) VEC_HEADER_ALIGN )
+#define VEC_HEADER_SIZE_ALIGNED( align )                                                                    \
+    ( ( sizeof ( vec_meta ) + VEC_ALIGNMENT( align ) - 1 ) / VEC_ALIGNMENT( align ) * VEC_ALIGNMENT( align ) )
+#define VEC_HEADER_SIZE VEC_HEADER_SIZE_ALIGNED( VEC_HEADER_ALIGN )
+
+// malloc only guarantees VEC_HEADER_ALIGN, anything stricter goes through aligned_alloc,
+// which needs the size rounded up to the alignment and cannot realloc in place
+static inline void* vec_default_alloc( size_t size, size_t align )
+{
+    if ( align <= VEC_HEADER_ALIGN ) return malloc( size );
+    return aligned_alloc( align, ( size + align - 1 ) / align * align );
+}
+
+static inline void* vec_default_realloc( void* ptr, size_t old_size, size_t new_size, size_t align )
+{
+    if ( align <= VEC_HEADER_ALIGN ) return realloc( ptr, new_size );
+    void* p = vec_default_alloc( new_size, align );
+    if ( p == NULL ) return NULL;
+    memcpy( p, ptr, old_size < new_size ? old_size : new_size );
+    free( ptr );
+    return p;
+}
+
+static inline void* vec_mem_alloc( const vec_allocator* alloc, size_t size, size_t align )
+{
+    if ( alloc == NULL ) return vec_default_alloc( size, align );
+    return alloc->allocate( alloc->ctx, size, align );
+}
+
+static inline void* vec_mem_realloc( const vec_allocator* alloc, void* ptr, size_t old_size, size_t new_size, size_t align )
+{
+    if ( alloc == NULL ) return vec_default_realloc( ptr, old_size, new_size, align );
+    return alloc->reallocate( alloc->ctx, ptr, old_size, new_size, align );
+}
+
+static inline void vec_mem_free( const vec_allocator* alloc, void* ptr, size_t size, size_t align )
+{
+    if ( alloc == NULL ) free( ptr );
+    else alloc->deallocate( alloc->ctx, ptr, size, align );
+}
+
+
+// smallest capacity a vector is ever allocated with
+#ifndef VEC_MIN_CAPACITY
+#define VEC_MIN_CAPACITY 16
+#endif
+
+// buffers below this many bytes double, larger ones grow by 1.5x, see `vec_growth_tiered`
+#ifndef VEC_GROWTH_TIER_BYTES
+#define VEC_GROWTH_TIER_BYTES ( (size_t) 1 << 20 )
+#endif
+
+// growth policy, maps the current capacity and element size to the next capacity
+// every policy must be geometric, so that push_back stays amortized O(1)
+typedef size_t (*vec_growth_policy)( size_t capacity, size_t elem_size );
+
+static inline size_t vec_growth_2x( size_t capacity, size_t elem_size )
+{
+    (void) elem_size;
+    return capacity * 2;
+}
+
+static inline size_t vec_growth_1_5x( size_t capacity, size_t elem_size )
+{
+    (void) elem_size;
+    return capacity + capacity / 2;
+}
+
+// double small buffers to get out of the allocator quickly, then 1.5x to keep the slack bounded
+static inline size_t vec_growth_tiered( size_t capacity, size_t elem_size )
+{
+    if ( capacity * elem_size < VEC_GROWTH_TIER_BYTES ) return capacity * 2;
+    return capacity + capacity / 2;
+}
+
+// policy used by `using_vector( T )`, override before including this header
+#ifndef VEC_GROWTH_DEFAULT
+#define VEC_GROWTH_DEFAULT vec_growth_tiered
+#endif
+
+// the one place capacities are grown, returns a capacity that can hold at least size elements
+static inline size_t vec_grow_capacity( size_t capacity, size_t size, size_t elem_size, vec_growth_policy policy )
+{
+    if ( capacity < VEC_MIN_CAPACITY ) capacity = VEC_MIN_CAPACITY;
+    while ( capacity < size )
+    {
+        size_t next = policy( capacity, elem_size );
+        if ( next <= capacity ) return size;    // the policy overflowed, fall back to the exact size
+        capacity = next;
+    }
+    return capacity;
+}
+
+// a vector only gives memory back once less than 1 / VEC_SHRINK_FACTOR of its capacity is used
+// the gap to the growth threshold keeps push/pop at the boundary from reallocating every time
+#ifndef VEC_SHRINK_FACTOR
+#define VEC_SHRINK_FACTOR 4
+#endif
+
+// the one place capacities are shrunk, halves the capacity while it is less than 1 / VEC_SHRINK_FACTOR used
+static inline size_t vec_shrink_capacity( size_t capacity, size_t size )
+{
+    while ( capacity / 2 >= VEC_MIN_CAPACITY && size < capacity / VEC_SHRINK_FACTOR )
+    {
+        capacity /= 2;
+    }
+    return capacity;
+}
+
+// per-thread scratch cache, `vec_scratch_get_##T` hands out cleared vectors that `vec_scratch_put_##T` took back
+// VEC_SCRATCH_SLOTS vectors are kept per type and thread, vectors above VEC_SCRATCH_MAX_BYTES are freed instead
+#ifndef VEC_SCRATCH_SLOTS
+#define VEC_SCRATCH_SLOTS 4
+#endif
+#ifndef VEC_SCRATCH_MAX_BYTES
+#define VEC_SCRATCH_MAX_BYTES ( (size_t) 16 << 20 )
+#endif
+
+// branch hints, keep the slow paths out of the way of the fast ones
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define VEC_LIKELY( x )     __builtin_expect( !!( x ), 1 )
+#define VEC_UNLIKELY( x )   __builtin_expect( !!( x ), 0 )
+#define VEC_COLD            __attribute__(( noinline, cold ))
+#else
+#define VEC_LIKELY( x )     ( x )
+#define VEC_UNLIKELY( x )   ( x )
+#define VEC_COLD
+#endif
+
+// error codes of the vec_try_* API, the rest of the API prints the message and exits instead
+#define VEC_OK          0
+#define VEC_ERR_NOMEM   1       // the allocator failed, the vector is left as it was
+#define VEC_ERR_RANGE   2       // position out of bounds
+#define VEC_ERR_EMPTY   3       // pop from an empty vector
+#define VEC_ERR_IO      4       // a file could not be opened, read, written or mapped, errno tells why
+#define VEC_ERR_FORMAT  5       // a file is not a vector file of this version and element size
+#define VEC_ERR_SHARED  6       // an in-place kernel that cannot hand back a copy got a shared vector, see VECTOR_COW
+
+// how the unchecked API fails
+static inline _Noreturn void vec_fail_( int err )
+{
+    if ( err == VEC_ERR_NOMEM ) fprintf( stderr, "[ERRO]: out of memory, aborted\n" );
+    else if ( err == VEC_ERR_RANGE ) fprintf( stderr, "[ERRO]: index out of bounds, aborted\n" );
+    else if ( err == VEC_ERR_EMPTY ) fprintf( stderr, "[ERRO]: empty vector, aborted\n" );
+    else if ( err == VEC_ERR_IO ) perror( "[ERRO]: vector file" );
+    else if ( err == VEC_ERR_SHARED ) fprintf( stderr, "[ERRO]: write to a shared vector, aborted\n" );
+    else fprintf( stderr, "[ERRO]: not a vector file, aborted\n" );
+    exit(1);
+}
+
+#ifdef VECTOR_COW
+// true while another owner holds the block, the acquire pairs with the release of an owner letting go,
+// so its last reads of the block happen before the remaining owner writes to it
+static inline bool vec_cow_shared_( vec_meta* meta )
+{
+    return atomic_load_explicit( &meta->shares, memory_order_acquire ) != 0;
+}
+
+// let go of the block, true when the caller was its last owner and has to free it
+static inline bool vec_cow_release_( vec_meta* meta )
+{
+    if ( !vec_cow_shared_( meta ) ) return true;
+    return atomic_fetch_sub_explicit( &meta->shares, 1, memory_order_acq_rel ) == 0;
+}
+#endif
+
+// compile-time optional instrumentation, define VECTOR_STATS in every translation unit to keep per element
+// type counters of allocations, reallocations, bytes moved, shrinks, live and peak bytes, and histograms of
+// the size and capacity vectors had when they were destroyed, `vec_stats_dump` prints them all
+// without VECTOR_STATS, VEC_STATS_( ... ) expands to nothing and vectors carry no extra code or data
+#ifdef VECTOR_STATS
+#include <stdatomic.h>
+#define VEC_STATS_( ... ) __VA_ARGS__
+
+// bucket k of a histogram counts the values in [ 2^(k-1), 2^k ), bucket 0 counts zeros
+#define VEC_STATS_BUCKETS 65
+
+// output formats of `vec_stats_dump`
+#define VEC_STATS_TEXT 0
+#define VEC_STATS_JSON 1
+
+typedef struct vec_stats
+{
+    const char* name;                   // element type
+    size_t elem_size;
+    _Atomic size_t allocs;              // blocks allocated
+    _Atomic size_t reallocs;            // capacity changes of a block
+    _Atomic size_t frees;               // blocks freed
+    _Atomic size_t shrinks;             // capacity changes that made the block smaller
+    _Atomic size_t bytes_moved;         // bytes copied because a block moved
+    _Atomic size_t live_bytes;          // bytes held by live vectors, headers included
+    _Atomic size_t peak_bytes;          // highest live_bytes so far
+    _Atomic size_t slack_bytes;         // unused capacity of destroyed vectors, summed
+    _Atomic size_t size_hist[ VEC_STATS_BUCKETS ];
+    _Atomic size_t capacity_hist[ VEC_STATS_BUCKETS ];
+    atomic_bool registered;             // on the list `vec_stats_dump` walks
+    struct vec_stats* next;
+} vec_stats;
+
+// every type that counted something, defined by each VECTOR_IMPLEMENTATION translation unit as a weak symbol
+// so any number of them link together, compilers without weak symbols allow only one of them
+extern _Atomic( vec_stats* ) vec_stats_list_;
+
+// print the counters of every type to out, VEC_STATS_TEXT or VEC_STATS_JSON
+void vec_stats_dump( FILE* out, int format );
+
+static inline size_t vec_stats_bucket_( size_t value )
+{
+    size_t bucket = 0;
+    for ( ; value; value >>= 1 ) bucket++;
+    return bucket;
+}
+
+static inline void vec_stats_register_( vec_stats* stats )
+{
+    if ( VEC_LIKELY( atomic_load_explicit( &stats->registered, memory_order_relaxed ) ) ) return;
+    if ( atomic_exchange( &stats->registered, true ) ) return;
+    stats->next = atomic_load( &vec_stats_list_ );
+    while ( !atomic_compare_exchange_weak( &vec_stats_list_, &stats->next, stats ) ) { }
+}
+
+// live bytes change by add - sub, size_t wraps so the difference may be negative
+static inline void vec_stats_live_( vec_stats* stats, size_t add, size_t sub )
+{
+    size_t live = atomic_fetch_add_explicit( &stats->live_bytes, add - sub, memory_order_relaxed ) + add - sub;
+    size_t peak = atomic_load_explicit( &stats->peak_bytes, memory_order_relaxed );
+    while ( live > peak && !atomic_compare_exchange_weak_explicit( &stats->peak_bytes, &peak, live,
+                                                                   memory_order_relaxed, memory_order_relaxed ) ) { }
+}
+
+// a new block of bytes, moved bytes copied into it from caller-provided storage
+static inline void vec_stats_alloc_( vec_stats* stats, size_t bytes, size_t moved )
+{
+    vec_stats_register_( stats );
+    atomic_fetch_add_explicit( &stats->allocs, 1, memory_order_relaxed );
+    atomic_fetch_add_explicit( &stats->bytes_moved, moved, memory_order_relaxed );
+    vec_stats_live_( stats, bytes, 0 );
+}
+
+static inline void vec_stats_realloc_( vec_stats* stats, size_t old_bytes, size_t new_bytes, size_t moved )
+{
+    vec_stats_register_( stats );
+    atomic_fetch_add_explicit( &stats->reallocs, 1, memory_order_relaxed );
+    if ( new_bytes < old_bytes ) atomic_fetch_add_explicit( &stats->shrinks, 1, memory_order_relaxed );
+    atomic_fetch_add_explicit( &stats->bytes_moved, moved, memory_order_relaxed );
+    vec_stats_live_( stats, new_bytes, old_bytes );
+}
+
+static inline void vec_stats_free_( vec_stats* stats, size_t bytes, size_t size, size_t capacity )
+{
+    vec_stats_register_( stats );
+    atomic_fetch_add_explicit( &stats->frees, 1, memory_order_relaxed );
+    atomic_fetch_add_explicit( &stats->slack_bytes, ( capacity - size ) * stats->elem_size, memory_order_relaxed );
+    atomic_fetch_add_explicit( &stats->size_hist[ vec_stats_bucket_( size ) ], 1, memory_order_relaxed );
+    atomic_fetch_add_explicit( &stats->capacity_hist[ vec_stats_bucket_( capacity ) ], 1, memory_order_relaxed );
+    vec_stats_live_( stats, 0, bytes );
+}
+#else
+#define VEC_STATS_( ... )
+#endif
+
+
+// the hot paths of a vector: accessors and the push/pop fast paths
+// LINKAGE is `static inline` when they are expanded into every translation unit, empty when they live in vec.c
+#define vec_using_hot_( T, LINKAGE )                                                                        \
+/* get the address for vec_meta */                                                                          \
+static inline vec_meta* vec_get_meta_##T( T* self )                                                         \
+{                                                                                                           \
+    return (vec_meta*) ( (char*) self - sizeof ( vec_meta ) );                                              \
+}                                                                                                           \
+/* slow paths of push_back and pop_back, defined with the rest of the vector */                             \
+T* vec_grow_##T( T* self, size_t size );                                                                    \
+int vec_try_grow_##T( T** self, size_t size );                                                              \
+T* vec_shrink_##T( T* self );                                                                               \
+VEC_COW_( T* vec_unshare_##T( T* self ); )                                                                  \
+VEC_COW_( int vec_try_unshare_##T( T** self ); )                                                            \
+/* get the reference of the first item */                                                                   \
+LINKAGE T* vec_front_##T( T* self )                                                                         \
+{                                                                                                           \
+    vec_meta *vector = vec_get_meta_##T( self );                                                            \
+    if ( vector->size > 0 ) return self;                                                                    \
+    else return NULL;                                                                                       \
+}                                                                                                           \
+/* get the reference of the last item */                                                                    \
+LINKAGE T* vec_back_##T( T* self )                                                                          \
+{                                                                                                           \
+    vec_meta *vector = vec_get_meta_##T( self );                                                            \
+    if ( vector->size > 0 ) return &self[ vector->size - 1 ];                                               \
+    else return NULL;                                                                                       \
+}                                                                                                           \
+/* Returns the number of elements in the vector */                                                          \
+LINKAGE size_t vec_size_##T( T* self )                                                                      \
+{                                                                                                           \
+    vec_meta *vector = vec_get_meta_##T( self );                                                            \
+    return vector->size;                                                                                    \
+}                                                                                                           \
+/* get the allocated size for the vector in terms of elements */                                            \
+LINKAGE size_t vec_capacity_##T( T* self )                                                                  \
+{                                                                                                           \
+    vec_meta *vector = vec_get_meta_##T( self );                                                            \
+    return vector->capacity;                                                                                \
+}                                                                                                           \
+/* Adds a new element at the end of the vector */                                                           \
+LINKAGE T* vec_push_back_##T( T* self, T val )                                                              \
+{                                                                                                           \
+    vec_meta* vector = vec_get_meta_##T( self );                                                            \
+    if ( VEC_UNLIKELY( vector->size == vector->capacity VEC_COW_( || vec_cow_shared_( vector ) ) ) )        \
+    {                                                                                                       \
+        self = vec_grow_##T( self, vector->size + 1 );                                                      \
+        vector = vec_get_meta_##T( self );                                                                  \
+    }                                                                                                       \
+    self[ vector->size++ ] = val;                                                                           \
+    return self;                                                                                            \
+}                                                                                                           \
+/* Adds an uninitialized element at the end of the vector, fill it in through vec_back */                   \
+LINKAGE T* vec_emplace_back_##T( T* self )                                                                  \
+{                                                                                                           \
+    vec_meta* vector = vec_get_meta_##T( self );                                                            \
+    if ( VEC_UNLIKELY( vector->size == vector->capacity VEC_COW_( || vec_cow_shared_( vector ) ) ) )        \
+    {                                                                                                       \
+        self = vec_grow_##T( self, vector->size + 1 );                                                      \
+        vector = vec_get_meta_##T( self );                                                                  \
+    }                                                                                                       \
+    vector->size++;                                                                                         \
+    return self;                                                                                            \
+}                                                                                                           \
+/* Removes the last element in the vector, effectively reducing the container size by one */                \
+LINKAGE T* vec_pop_back_##T( T* self )                                                                      \
+{                                                                                                           \
+    vec_meta *vector = vec_get_meta_##T( self );                                                            \
+    if ( VEC_UNLIKELY( !vector->size ) ) vec_fail_( VEC_ERR_EMPTY );                                        \
+    else                                                                                                    \
+    {                                                                                                       \
+        VEC_COW_( self = vec_unshare_##T( self ); )                                                         \
+        VEC_COW_( vector = vec_get_meta_##T( self ); )                                                      \
+        vector->size--;                                                                                     \
+        if ( VEC_UNLIKELY( vector->size < vector->capacity / VEC_SHRINK_FACTOR ) )                          \
+        {                                                                                                   \
+            if ( vector->capacity > VEC_MIN_CAPACITY ) self = vec_shrink_##T( self );                       \
+        }                                                                                                   \
+        return self;                                                                                        \
+    }                                                                                                       \
+}                                                                                                           \
+/* push_back reporting VEC_ERR_NOMEM instead of exiting, *self is untouched on failure */                   \
+LINKAGE int vec_try_push_back_##T( T** self, T val )                                                        \
+{                                                                                                           \
+    vec_meta* vector = vec_get_meta_##T( *self );                                                           \
+    if ( VEC_UNLIKELY( vector->size == vector->capacity VEC_COW_( || vec_cow_shared_( vector ) ) ) )        \
+    {                                                                                                       \
+        int err = vec_try_grow_##T( self, vector->size + 1 );                                               \
+        if ( VEC_UNLIKELY( err ) ) return err;                                                              \
+        vector = vec_get_meta_##T( *self );                                                                 \
+    }                                                                                                       \
+    ( *self )[ vector->size++ ] = val;                                                                      \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+/* emplace_back reporting VEC_ERR_NOMEM instead of exiting, *self is untouched on failure */                \
+LINKAGE int vec_try_emplace_back_##T( T** self )                                                            \
+{                                                                                                           \
+    vec_meta* vector = vec_get_meta_##T( *self );                                                           \
+    if ( VEC_UNLIKELY( vector->size == vector->capacity VEC_COW_( || vec_cow_shared_( vector ) ) ) )        \
+    {                                                                                                       \
+        int err = vec_try_grow_##T( self, vector->size + 1 );                                               \
+        if ( VEC_UNLIKELY( err ) ) return err;                                                              \
+        vector = vec_get_meta_##T( *self );                                                                 \
+    }                                                                                                       \
+    vector->size++;                                                                                         \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+/* pop_back reporting VEC_ERR_EMPTY instead of exiting */                                                   \
+LINKAGE int vec_try_pop_back_##T( T** self )                                                                \
+{                                                                                                           \
+    vec_meta* vector = vec_get_meta_##T( *self );                                                           \
+    if ( VEC_UNLIKELY( vector->size == 0 ) ) return VEC_ERR_EMPTY;                                          \
+    VEC_COW_( int err = vec_try_unshare_##T( self ); )                                                      \
+    VEC_COW_( if ( VEC_UNLIKELY( err ) ) return err; )                                                      \
+    VEC_COW_( vector = vec_get_meta_##T( *self ); )                                                         \
+    vector->size--;                                                                                         \
+    if ( VEC_UNLIKELY( vector->size < vector->capacity / VEC_SHRINK_FACTOR ) )                              \
+    {                                                                                                       \
+        if ( vector->capacity > VEC_MIN_CAPACITY ) *self = vec_shrink_##T( *self );                         \
+    }                                                                                                       \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+
+// non-owning view of size elements at data: a whole vector, a range of one, or a plain array
+// views are passed by value and never allocate, a view of a vector is valid until the vector reallocates,
+// the vec_view_* functions of vec_simd.h and vec_sort.h run the same kernels as the vector ones on it
+// under VECTOR_COW a view does not unshare, writes through a view of a shared vector reach every owner,
+// so call vec_unshare_##T before taking a view to fill, scale or sort
+#define vec_view_( T )                                                                                      \
+typedef struct vec_view_##T                                                                                 \
+{                                                                                                           \
+    T* data;                                                                                                \
+    size_t size;                                                                                            \
+} vec_view_##T;                                                                                             \
+/* view of size elements of arr */                                                                          \
+static inline vec_view_##T vec_view_arr_##T( T* arr, size_t size )                                          \
+{                                                                                                           \
+    return (vec_view_##T) { arr, size };                                                                    \
+}                                                                                                           \
+/* view of every element of the vector */                                                                   \
+static inline vec_view_##T vec_view_of_##T( T* self )                                                       \
+{                                                                                                           \
+    return (vec_view_##T) { self, vec_size_##T( self ) };                                                   \
+}                                                                                                           \
+/* narrow the view to its count elements from position */                                                   \
+/* VEC_ERR_RANGE when they run past its end, *self is untouched then */                                     \
+static inline int vec_view_try_sub_##T( vec_view_##T* self, size_t position, size_t count )                 \
+{                                                                                                           \
+    if ( VEC_UNLIKELY( position > self->size || count > self->size - position ) ) return VEC_ERR_RANGE;     \
+    self->data += position;                                                                                 \
+    self->size = count;                                                                                     \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+/* view of count elements of view from position */                                                          \
+static inline vec_view_##T vec_view_sub_##T( vec_view_##T view, size_t position, size_t count )             \
+{                                                                                                           \
+    int err = vec_view_try_sub_##T( &view, position, count );                                               \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return view;                                                                                            \
+}                                                                                                           \
+/* view of count elements of the vector from position */                                                    \
+static inline vec_view_##T vec_view_range_##T( T* self, size_t position, size_t count )                     \
+{                                                                                                           \
+    return vec_view_sub_##T( vec_view_of_##T( self ), position, count );                                    \
+}                                                                                                           \
+/* Returns the number of elements in the view */                                                            \
+static inline size_t vec_view_size_##T( vec_view_##T view )                                                 \
+{                                                                                                           \
+    return view.size;                                                                                       \
+}                                                                                                           \
+/* get the reference of the item at position, NULL when it is out of range */                               \
+static inline T* vec_view_at_##T( vec_view_##T view, size_t position )                                      \
+{                                                                                                           \
+    return position < view.size ? &view.data[ position ] : NULL;                                            \
+}                                                                                                           \
+static inline T* vec_view_front_##T( vec_view_##T view )                                                    \
+{                                                                                                           \
+    return view.size > 0 ? view.data : NULL;                                                                \
+}                                                                                                           \
+static inline T* vec_view_back_##T( vec_view_##T view )                                                     \
+{                                                                                                           \
+    return view.size > 0 ? &view.data[ view.size - 1 ] : NULL;                                              \
+}                                                                                                           \
+
+// use this macro to create all the function for that specific type
+// T is the type of needed vector
+// POLICY is the growth policy of the vector, `using_vector( T )` uses VEC_GROWTH_DEFAULT
+// ALIGN is the alignment of the data in bytes, a power of two, at least VEC_HEADER_ALIGN is used
+// MODE is `inline` to expand the hot paths as `static inline` into every translation unit,
+// or `extern` to keep them in vec.c, `using_vector( T )` picks `inline` when VECTOR_INLINE is defined
+#ifdef VECTOR_INLINE
+#define vec_hot_default_ inline
+#else
+#define vec_hot_default_ extern
+#endif
+#define vec_using_mode_( T, POLICY, ALIGN, MODE ) using_vector_ex( T, POLICY, ALIGN, MODE )
+#define using_vector( T ) using_vector_policy( T, VEC_GROWTH_DEFAULT )
+#define using_vector_policy( T, POLICY ) vec_using_mode_( T, POLICY, VEC_HEADER_ALIGN, vec_hot_default_ )
+
+// vector whose data is aligned to ALIGN bytes, e.g. 64 for a cache line or an AVX-512 register
+#define using_vector_aligned( T, ALIGN ) vec_using_mode_( T, VEC_GROWTH_DEFAULT, ALIGN, vec_hot_default_ )
+
+// small vector of T with room for N elements in the storage type vec_small_##T##_##N,
+// which can live on the stack or inside another struct, `using_vector( T )` must come first,
+// only for vectors with the default alignment
+// vec_small_new_##T##_##N( &storage ) returns a regular T* vector, every vec_*_##T function works on it,
+// it only touches the heap once it grows past N elements, vec_destroy_##T is still needed after that
+#define using_small_vector( T, N )                                                                          \
+typedef struct vec_small_##T##_##N                                                                          \
+{                                                                                                           \
+    _Alignas( VEC_HEADER_ALIGN ) unsigned char header[ VEC_HEADER_SIZE ];                                   \
+    T data[ N ];                                                                                            \
+} vec_small_##T##_##N;                                                                                      \
+static inline T* vec_small_new_##T##_##N( vec_small_##T##_##N* storage )                                    \
+{                                                                                                           \
+    return vec_new_in_##T( storage, sizeof ( *storage ), NULL );                                            \
+}                                                                                                           \
+
 
 #ifndef VECTOR_IMPLEMENTATION
-#define using_vector( T )                                                                                   \
+#define vec_hot_decl_inline( T ) vec_using_hot_( T, static inline )
+#define vec_hot_decl_extern( T )                                                                            \
+T* vec_front_##T( T* self );                                                                                \
+T* vec_back_##T( T* self );                                                                                 \
+T* vec_push_back_##T( T* self, T val );                                                                     \
+T* vec_emplace_back_##T( T* self );                                                                         \
+T* vec_pop_back_##T( T* self );                                                                             \
+int vec_try_push_back_##T( T** self, T val );                                                               \
+int vec_try_emplace_back_##T( T** self );                                                                   \
+int vec_try_pop_back_##T( T** self );                                                                       \
+size_t vec_size_##T( T* self );                                                                             \
+size_t vec_capacity_##T( T* self );                                                                         \
+
+#define using_vector_ex( T, POLICY, ALIGN, MODE )                                                           \
+vec_hot_decl_##MODE( T )                                                                                    \
+vec_view_( T )                                                                                              \
 T* vec_new_##T( size_t size, T val );                                                                       \
+T* vec_new_with_alloc_##T( size_t size, T val, const vec_allocator* alloc );                                \
+T* vec_new_in_##T( void* storage, size_t bytes, const vec_allocator* alloc );                               \
 T* vec_resize_##T( T* self, size_t size, T val );                                                           \
 T* vec_clear_##T( T* self );                                                                                \
+T* vec_trim_##T( T* self, size_t max_cap );                                                                 \
+T* vec_release_##T( T* self );                                                                              \
 T* vec_assign_##T( T* self, size_t size, T val );                                                           \
-T* vec_back_##T( T* self );                                                                                 \
 T* vec_shrink_to_fit_##T( T* self );                                                                        \
 T* vec_reserve_##T( T* self, size_t size );                                                                 \
 T* vec_insert_##T( T* self, size_t position, T val );                                                       \
-T* vec_insert_arr_##T( T* self, size_t position, T* arr, size_t size );                                     \
-T* vec_push_back_##T( T* self, T val );                                                                     \
-T* vec_pop_back_##T( T* self );                                                                             \
-size_t vec_size_##T( T* self );                                                                             \
-size_t vec_capacity_##T( T* self );                                                                         \
+T* vec_insert_arr_##T( T* self, size_t position, const T* arr, size_t size );                               \
+T* vec_append_arr_##T( T* self, const T* arr, size_t size );                                                \
+T* vec_append_vec_##T( T* self, T* other );                                                                 \
+T* vec_erase_range_##T( T* self, size_t position, size_t count );                                           \
+T* vec_swap_remove_##T( T* self, size_t position );                                                         \
+T* vec_truncate_##T( T* self, size_t size );                                                                \
 void vec_destroy_##T( T* self );                                                                            \
+T* vec_scratch_get_##T( size_t capacity );                                                                  \
+void vec_scratch_put_##T( T* self );                                                                        \
+void vec_scratch_flush_##T( void );                                                                         \
+int vec_try_new_##T( T** self, size_t size, T val );                                                        \
+int vec_try_new_with_alloc_##T( T** self, size_t size, T val, const vec_allocator* alloc );                 \
+int vec_try_resize_##T( T** self, size_t size, T val );                                                     \
+int vec_try_assign_##T( T** self, size_t size, T val );                                                     \
+int vec_try_reserve_##T( T** self, size_t size );                                                           \
+int vec_try_insert_##T( T** self, size_t position, T val );                                                 \
+int vec_try_insert_arr_##T( T** self, size_t position, const T* arr, size_t size );                         \
+int vec_try_append_arr_##T( T** self, const T* arr, size_t size );                                          \
+int vec_try_append_vec_##T( T** self, T* other );                                                           \
+int vec_try_erase_range_##T( T** self, size_t position, size_t count );                                     \
+int vec_try_swap_remove_##T( T** self, size_t position );                                                   \
+VEC_STATS_( const vec_stats* vec_stats_##T( void ); )                                                       \
+VEC_COW_( T* vec_share_##T( T* self ); )                                                                    \
+VEC_COW_( T* vec_unshare_##T( T* self ); )                                                                  \
+VEC_COW_( int vec_try_unshare_##T( T** self ); )                                                            \
+VEC_COW_( bool vec_is_shared_##T( T* self ); )                                                              \
+
 
 
 // use `_Generic` keyword from C11 to wrap all of the function above
@@ -95,6 +646,12 @@ using_vector(double)
     double*:    vec_push_back_double                                                                        \
 ) ( self, val )                                                                                             \
 
+#define vec_emplace_back( self ) _Generic( (self),                                                          \
+    int*:       vec_emplace_back_int,                                                                       \
+    char*:      vec_emplace_back_char,                                                                      \
+    double*:    vec_emplace_back_double                                                                     \
+) ( self )                                                                                                  \
+
 #define vec_pop_back( self ) _Generic( (self),                                                              \
     int*:       vec_pop_back_int,                                                                           \
     char*:      vec_pop_back_char,                                                                          \
@@ -127,267 +684,602 @@ using_vector(double)
 #endif  // __VECTOR_H__
 
 
-// use this macro to create all the function for that specific type
-// T is the type of needed vector
+// the definitions behind `using_vector_ex`, compiled once in vec.c
 #ifdef VECTOR_IMPLEMENTATION
-#define using_vector( T )                                                                                   \
-/* create a vector with size size, all initialize to val */                                                 \
-T* vec_new_##T( size_t size, T val )                                                                        \
+// the sharing half of a vector, see VECTOR_COW
+#ifdef VECTOR_COW
+#define vec_cow_def_( T )                                                                                   \
+void vec_destroy_##T( T* self );                                                                            \
+/* copy the first keep elements of self into a new block of the same capacity, from the allocator of self */ \
+/* or from malloc when that one has nothing to give, a mapped file for instance */                          \
+static int vec_cow_copy_##T( T* self, size_t keep, T** copy )                                               \
 {                                                                                                           \
-    size_t cap;                                                                                             \
-    if ( size < 16 ) cap = 16;                                                                              \
-    else cap = size;                                                                                        \
-    vec_meta* vector = malloc( sizeof ( vec_meta ) );                                                       \
-    vector->size = size;                                                                                    \
-    vector->capacity = 16;                                                                                  \
-    if ( cap > vector->capacity )                                                                           \
+    vec_meta* vector = vec_get_meta_##T( self );                                                            \
+    const vec_allocator* alloc = vector->alloc;                                                             \
+    if ( keep > vector->size ) keep = vector->size;                                                         \
+    char* block = vec_mem_alloc( alloc, vec_bytes_##T( vector->capacity ), vec_align_##T() );               \
+    if ( VEC_UNLIKELY( block == NULL ) && alloc != NULL )                                                   \
     {                                                                                                       \
-        while ( vector->capacity < cap )                                                                    \
-        {                                                                                                   \
-            if ( vector->capacity <= 1024 )                                                                 \
-            {                                                                                               \
-                vector->capacity *= 2;                                                                      \
-            }                                                                                               \
-            else                                                                                            \
-            {                                                                                               \
-                vector->capacity += 512;                                                                    \
-            }                                                                                               \
-        }                                                                                                   \
+        alloc = NULL;                                                                                       \
+        block = vec_mem_alloc( NULL, vec_bytes_##T( vector->capacity ), vec_align_##T() );                  \
     }                                                                                                       \
-    vector = realloc( vector, sizeof ( vec_meta ) + sizeof (T) * vector->capacity );                        \
-    T* data = (void*) ( (char*) vector + sizeof ( vec_meta ) );                                             \
-    for ( size_t i = 0; i < size; i++ )                                                                     \
+    if ( VEC_UNLIKELY( block == NULL ) ) return VEC_ERR_NOMEM;                                              \
+    T* data = (void*) ( block + vec_header_size_##T() );                                                    \
+    vec_meta* meta = vec_get_meta_##T( data );                                                              \
+    meta->size = keep;                                                                                      \
+    meta->capacity = vector->capacity;                                                                      \
+    meta->alloc = alloc;                                                                                    \
+    meta->flags = 0;                                                                                        \
+    atomic_init( &meta->shares, 0 );                                                                        \
+    memcpy( data, self, keep * sizeof ( T ) );                                                              \
+    VEC_STATS_( vec_stats_alloc_( &vec_stats_of_##T, vec_bytes_##T( vector->capacity ), keep * sizeof ( T ) ); ) \
+    *copy = data;                                                                                           \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+/* make *self the only owner of its block before changing it, a shared block is copied, only its first keep */ \
+/* elements when the caller is about to drop the rest, and *self lets go of it */                           \
+static int vec_try_own_##T( T** self, size_t keep )                                                         \
+{                                                                                                           \
+    if ( VEC_LIKELY( !vec_cow_shared_( vec_get_meta_##T( *self ) ) ) ) return VEC_OK;                       \
+    T* copy;                                                                                                \
+    int err = vec_cow_copy_##T( *self, keep, &copy );                                                       \
+    if ( VEC_UNLIKELY( err ) ) return err;                                                                  \
+    vec_destroy_##T( *self );                                                                               \
+    *self = copy;                                                                                           \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+static T* vec_own_##T( T* self, size_t keep )                                                               \
+{                                                                                                           \
+    int err = vec_try_own_##T( &self, keep );                                                               \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* hand the block to one more owner, every owner destroys its vector and the last one frees the block */    \
+/* the owners may live on different threads, a vector in caller-provided storage is copied instead */       \
+T* vec_share_##T( T* self )                                                                                 \
+{                                                                                                           \
+    vec_meta* vector = vec_get_meta_##T( self );                                                            \
+    if ( VEC_UNLIKELY( vector->flags & VEC_FLAG_INLINE ) )                                                  \
     {                                                                                                       \
-        data[i] = val;                                                                                      \
+        T* copy;                                                                                            \
+        int err = vec_cow_copy_##T( self, vector->size, &copy );                                            \
+        if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                        \
+        return copy;                                                                                        \
     }                                                                                                       \
-    return data;                                                                                            \
+    atomic_fetch_add_explicit( &vector->shares, 1, memory_order_relaxed );                                  \
+    return self;                                                                                            \
 }                                                                                                           \
-/* get the address for vec_meta */                                                                          \
-static inline vec_meta* vec_get_meta_##T( T* self )                                                         \
+/* make self the only owner of its block, call it before writing to the elements directly */                \
+int vec_try_unshare_##T( T** self )                                                                         \
 {                                                                                                           \
-    return (vec_meta*) ( (char*) self - sizeof ( vec_meta ) );                                              \
+    return vec_try_own_##T( self, SIZE_MAX );                                                               \
 }                                                                                                           \
-/* change vector to specific size */                                                                        \
-T* vec_resize_##T( T* self, size_t size, T val )                                                            \
+T* vec_unshare_##T( T* self )                                                                               \
+{                                                                                                           \
+    return vec_own_##T( self, SIZE_MAX );                                                                   \
+}                                                                                                           \
+/* true while the block has other owners */                                                                 \
+bool vec_is_shared_##T( T* self )                                                                           \
+{                                                                                                           \
+    return vec_cow_shared_( vec_get_meta_##T( self ) );                                                     \
+}                                                                                                           \
+
+#else
+#define vec_cow_def_( T )
+#endif
+#define vec_hot_def_inline( T ) vec_using_hot_( T, static inline )
+#define vec_hot_def_extern( T ) vec_using_hot_( T, )
+#define using_vector_ex( T, POLICY, ALIGN, MODE )                                                           \
+vec_hot_def_##MODE( T )                                                                                     \
+vec_view_( T )                                                                                              \
+VEC_STATS_( static vec_stats vec_stats_of_##T = { .name = #T, .elem_size = sizeof ( T ) }; )                \
+VEC_STATS_( const vec_stats* vec_stats_##T( void ) { return &vec_stats_of_##T; } )                          \
+/* alignment of the data, passed to the allocator */                                                        \
+static inline size_t vec_align_##T( void )                                                                  \
+{                                                                                                           \
+    return VEC_ALIGNMENT( ALIGN );                                                                          \
+}                                                                                                           \
+/* bytes in front of the data, the allocated block starts here */                                           \
+static inline size_t vec_header_size_##T( void )                                                            \
+{                                                                                                           \
+    return VEC_HEADER_SIZE_ALIGNED( ALIGN );                                                                \
+}                                                                                                           \
+/* next capacity that can hold size elements, following the growth policy of this type */                   \
+static inline size_t vec_grow_capacity_##T( size_t capacity, size_t size )                                  \
+{                                                                                                           \
+    return vec_grow_capacity( capacity, size, sizeof ( T ), POLICY );                                       \
+}                                                                                                           \
+/* size of the block holding capacity elements and the header */                                            \
+static inline size_t vec_bytes_##T( size_t capacity )                                                       \
+{                                                                                                           \
+    return vec_header_size_##T() + sizeof ( T ) * capacity;                                                 \
+}                                                                                                           \
+/* reallocate the vector so it holds exactly capacity elements, size is left untouched */                   \
+/* NULL when a bigger block cannot be allocated, the vector is left as it was */                            \
+/* a smaller block that cannot be allocated keeps the current one */                                        \
+static inline T* vec_set_capacity_##T( T* self, size_t capacity )                                           \
 {                                                                                                           \
     vec_meta* vector = vec_get_meta_##T( self );                                                            \
-    size_t cap;                                                                                             \
-    if ( size < 16 ) cap = 16;                                                                              \
-    else cap = size;                                                                                        \
-    if ( cap > vector->capacity )                                                                           \
+    char* block = (char*) self - vec_header_size_##T();                                                     \
+    char* moved;                                                                                            \
+    if ( VEC_UNLIKELY( capacity > ( SIZE_MAX - vec_header_size_##T() ) / sizeof ( T ) ) ) return NULL;      \
+    if ( VEC_UNLIKELY( vector->flags & VEC_FLAG_INLINE ) )                                                  \
     {                                                                                                       \
-        while ( vector->capacity < cap )                                                                    \
-        {                                                                                                   \
-            if ( vector->capacity <= 1024 )                                                                 \
-            {                                                                                               \
-                vector->capacity *= 2;                                                                      \
-            }                                                                                               \
-            else                                                                                            \
-            {                                                                                               \
-                vector->capacity += 512;                                                                    \
-            }                                                                                               \
-        }                                                                                                   \
-        vector = realloc( vector, sizeof ( vec_meta ) + sizeof ( T ) * vector->capacity );                  \
-        self = (void*) ( (char*) vector + sizeof ( vec_meta ) );                                            \
-        for ( size_t i = vector->size; i < size; i++ )                                                      \
-        {                                                                                                   \
-            self[i] = val;                                                                                  \
-        }                                                                                                   \
-        vector->size = size;                                                                                \
+        /* caller-provided storage keeps its size, spill to the allocator once it is too small */           \
+        if ( capacity <= vector->capacity ) return self;                                                    \
+        moved = vec_mem_alloc( vector->alloc, vec_bytes_##T( capacity ), vec_align_##T() );                 \
+        if ( VEC_UNLIKELY( moved == NULL ) ) return NULL;                                                   \
+        memcpy( moved, block, vec_bytes_##T( vector->size ) );                                              \
+        vec_get_meta_##T( (void*) ( moved + vec_header_size_##T() ) )->flags &= ~VEC_FLAG_INLINE;           \
+        VEC_STATS_( vec_stats_alloc_( &vec_stats_of_##T, vec_bytes_##T( capacity ), vec_bytes_##T( vector->size ) ); ) \
     }                                                                                                       \
     else                                                                                                    \
     {                                                                                                       \
-        while ( cap > 1024 )                                                                                \
-        {                                                                                                   \
-            if ( cap + 512 < vector->capacity )                                                             \
-            {                                                                                               \
-                vector->capacity -= 512;                                                                    \
-            }                                                                                               \
-            else break;                                                                                     \
-        }                                                                                                   \
-        while ( cap <= 1024 )                                                                               \
-        {                                                                                                   \
-            if ( cap * 2 < vector->capacity )                                                               \
-            {                                                                                               \
-                vector->capacity /= 2;                                                                      \
-            }                                                                                               \
-            else break;                                                                                     \
-        }                                                                                                   \
-        vector = realloc( vector, sizeof ( vec_meta ) + sizeof ( T ) * vector->capacity );                  \
-        self = (void*) ( (char*) vector + sizeof ( vec_meta ) );                                            \
-        vector->size = size;                                                                                \
+        VEC_STATS_( size_t used = vec_bytes_##T( vector->size ), old_bytes = vec_bytes_##T( vector->capacity ); ) \
+        VEC_STATS_( uintptr_t before = (uintptr_t) block; )                                                 \
+        moved = vec_mem_realloc( vector->alloc, block, vec_bytes_##T( vector->capacity ),                   \
+                                 vec_bytes_##T( capacity ), vec_align_##T() );                              \
+        if ( VEC_UNLIKELY( moved == NULL ) ) return capacity < vector->capacity ? self : NULL;              \
+        VEC_STATS_( vec_stats_realloc_( &vec_stats_of_##T, old_bytes, vec_bytes_##T( capacity ),            \
+                                        (uintptr_t) moved != before ? used : 0 ); )                         \
     }                                                                                                       \
+    self = (void*) ( moved + vec_header_size_##T() );                                                       \
+    vec_get_meta_##T( self )->capacity = capacity;                                                          \
     return self;                                                                                            \
 }                                                                                                           \
-/* clear, remove all elements in the vector, may not reallocate */                                          \
-T* vec_clear_##T( T* self )                                                                                 \
+/* slow path of try_push_back, grows *self to hold size elements following the growth policy */             \
+VEC_COLD int vec_try_grow_##T( T** self, size_t size )                                                      \
 {                                                                                                           \
-    vec_meta* vector = vec_get_meta_##T( self );                                                            \
-    vector->size = 0;                                                                                       \
-    vector->capacity = 16;                                                                                  \
-    vector = realloc( vector, sizeof ( vec_meta ) + sizeof ( T ) * vector->capacity );                      \
-    self = (void*) ( (char*) vector + sizeof ( vec_meta ) );                                                \
-    memset( self, 0, sizeof (T) * vector->capacity );                                                       \
+    VEC_COW_( int err = vec_try_unshare_##T( self ); )                                                      \
+    VEC_COW_( if ( VEC_UNLIKELY( err ) ) return err; )                                                      \
+    VEC_COW_( if ( size <= vec_get_meta_##T( *self )->capacity ) return VEC_OK; )                           \
+    T* grown = vec_set_capacity_##T( *self, vec_grow_capacity_##T( vec_get_meta_##T( *self )->capacity, size ) ); \
+    if ( VEC_UNLIKELY( grown == NULL ) ) return VEC_ERR_NOMEM;                                              \
+    *self = grown;                                                                                          \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+/* slow path of push_back, only taken when the vector is full */                                            \
+VEC_COLD T* vec_grow_##T( T* self, size_t size )                                                            \
+{                                                                                                           \
+    int err = vec_try_grow_##T( &self, size );                                                              \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
     return self;                                                                                            \
 }                                                                                                           \
-/* Assigns new contents to the vector and modifying its size accordingly */                                 \
-T* vec_assign_##T( T* self, size_t size, T val )                                                            \
+/* slow path of pop_back, only taken when the vector dropped below 1 / VEC_SHRINK_FACTOR of its capacity */ \
+VEC_COLD T* vec_shrink_##T( T* self )                                                                       \
 {                                                                                                           \
     vec_meta* vector = vec_get_meta_##T( self );                                                            \
+    return vec_set_capacity_##T( self, vec_shrink_capacity( vector->capacity, vector->size ) );             \
+}                                                                                                           \
+/* make room for size elements, one capacity check for the bulk operations */                               \
+static inline int vec_try_make_room_##T( T** self, size_t size )                                            \
+{                                                                                                           \
+    VEC_COW_( int err = vec_try_unshare_##T( self ); )                                                      \
+    VEC_COW_( if ( VEC_UNLIKELY( err ) ) return err; )                                                      \
+    if ( VEC_UNLIKELY( size > vec_get_meta_##T( *self )->capacity ) ) return vec_try_grow_##T( self, size ); \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+/* give memory back once the vector dropped below 1 / VEC_SHRINK_FACTOR of its capacity */                  \
+static inline T* vec_maybe_shrink_##T( T* self )                                                            \
+{                                                                                                           \
+    vec_meta* vector = vec_get_meta_##T( self );                                                            \
+    if ( VEC_UNLIKELY( vector->size < vector->capacity / VEC_SHRINK_FACTOR ) )                              \
+    {                                                                                                       \
+        if ( vector->capacity > VEC_MIN_CAPACITY ) return vec_shrink_##T( self );                           \
+    }                                                                                                       \
+    return self;                                                                                            \
+}                                                                                                           \
+vec_cow_def_( T )                                                                                           \
+/* create a vector with size size, all initialize to val, its memory comes from alloc ( NULL for malloc ) */ \
+int vec_try_new_with_alloc_##T( T** self, size_t size, T val, const vec_allocator* alloc )                  \
+{                                                                                                           \
+    size_t cap = vec_grow_capacity_##T( 0, size );                                                          \
+    if ( VEC_UNLIKELY( cap > ( SIZE_MAX - vec_header_size_##T() ) / sizeof ( T ) ) ) return VEC_ERR_NOMEM;  \
+    char* block = vec_mem_alloc( alloc, vec_bytes_##T( cap ), vec_align_##T() );                            \
+    if ( VEC_UNLIKELY( block == NULL ) ) return VEC_ERR_NOMEM;                                              \
+    T* data = (void*) ( block + vec_header_size_##T() );                                                    \
+    vec_meta* vector = vec_get_meta_##T( data );                                                            \
+    vector->size = size;                                                                                    \
+    vector->capacity = cap;                                                                                 \
+    vector->alloc = alloc;                                                                                  \
+    vector->flags = 0;                                                                                      \
+    VEC_COW_( atomic_init( &vector->shares, 0 ); )                                                          \
+    VEC_STATS_( vec_stats_alloc_( &vec_stats_of_##T, vec_bytes_##T( cap ), 0 ); )                           \
+    for ( size_t i = 0; i < size; i++ )                                                                     \
+    {                                                                                                       \
+        data[i] = val;                                                                                      \
+    }                                                                                                       \
+    *self = data;                                                                                           \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+T* vec_new_with_alloc_##T( size_t size, T val, const vec_allocator* alloc )                                 \
+{                                                                                                           \
+    T* self;                                                                                                \
+    int err = vec_try_new_with_alloc_##T( &self, size, val, alloc );                                        \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* create an empty vector in caller-provided storage of bytes bytes, 16-byte aligned */                     \
+/* it spills to alloc ( NULL for malloc ) when it outgrows the storage */                                   \
+T* vec_new_in_##T( void* storage, size_t bytes, const vec_allocator* alloc )                                \
+{                                                                                                           \
+    T* data = (void*) ( (char*) storage + vec_header_size_##T() );                                          \
+    vec_meta* vector = vec_get_meta_##T( data );                                                            \
+    vector->size = 0;                                                                                       \
+    vector->capacity = ( bytes - vec_header_size_##T() ) / sizeof ( T );                                    \
+    vector->alloc = alloc;                                                                                  \
+    vector->flags = VEC_FLAG_INLINE;                                                                        \
+    VEC_COW_( atomic_init( &vector->shares, 0 ); )                                                          \
+    return data;                                                                                            \
+}                                                                                                           \
+/* create a vector with size size, all initialize to val */                                                 \
+int vec_try_new_##T( T** self, size_t size, T val )                                                         \
+{                                                                                                           \
+    return vec_try_new_with_alloc_##T( self, size, val, NULL );                                             \
+}                                                                                                           \
+T* vec_new_##T( size_t size, T val )                                                                        \
+{                                                                                                           \
+    return vec_new_with_alloc_##T( size, val, NULL );                                                       \
+}                                                                                                           \
+/* change vector to specific size */                                                                        \
+int vec_try_resize_##T( T** self, size_t size, T val )                                                      \
+{                                                                                                           \
+    VEC_COW_( int err = vec_try_unshare_##T( self ); )                                                      \
+    VEC_COW_( if ( VEC_UNLIKELY( err ) ) return err; )                                                      \
+    T* data = *self;                                                                                        \
+    vec_meta* vector = vec_get_meta_##T( data );                                                            \
     size_t cap;                                                                                             \
-    if ( size < 16 ) cap = 16;                                                                              \
-    else cap = size;                                                                                        \
-    if ( cap > vector->capacity )                                                                           \
+    if ( size > vector->capacity ) cap = vec_grow_capacity_##T( vector->capacity, size );                   \
+    else cap = vec_shrink_capacity( vector->capacity, size );                                               \
+    if ( cap != vector->capacity )                                                                          \
     {                                                                                                       \
-        while ( vector->capacity < cap )                                                                    \
-        {                                                                                                   \
-            if ( vector->capacity <= 1024 )                                                                 \
-            {                                                                                               \
-                vector->capacity *= 2;                                                                      \
-            }                                                                                               \
-            else                                                                                            \
-            {                                                                                               \
-                vector->capacity += 512;                                                                    \
-            }                                                                                               \
-        }                                                                                                   \
-        vector = realloc( vector, sizeof ( vec_meta ) + sizeof ( T ) * vector->capacity );                  \
-        self = (void*) ( (char*) vector + sizeof ( vec_meta ) );                                            \
-        for ( size_t i = 0; i < size; i++ )                                                                 \
-        {                                                                                                   \
-            self[i] = val;                                                                                  \
-        }                                                                                                   \
-        vector->size = size;                                                                                \
+        data = vec_set_capacity_##T( data, cap );                                                           \
+        if ( VEC_UNLIKELY( data == NULL ) ) return VEC_ERR_NOMEM;                                           \
+        vector = vec_get_meta_##T( data );                                                                  \
     }                                                                                                       \
-    else                                                                                                    \
+    for ( size_t i = vector->size; i < size; i++ )                                                          \
     {                                                                                                       \
-        while ( cap > 1024 )                                                                                \
-        {                                                                                                   \
-            if ( cap + 512 < vector->capacity )                                                             \
-            {                                                                                               \
-                vector->capacity -= 512;                                                                    \
-            }                                                                                               \
-            else break;                                                                                     \
-        }                                                                                                   \
-        while ( cap <= 1024 )                                                                               \
-        {                                                                                                   \
-            if ( cap * 2 < vector->capacity )                                                               \
-            {                                                                                               \
-                vector->capacity /= 2;                                                                      \
-            }                                                                                               \
-            else break;                                                                                     \
-        }                                                                                                   \
-        vector = realloc( vector, sizeof ( vec_meta ) + sizeof ( T ) * vector->capacity );                  \
-        self = (void*) ( (char*) vector + sizeof ( vec_meta ) );                                            \
-        for ( size_t i = 0; i < size; i++ )                                                                 \
-        {                                                                                                   \
-            self[i] = val;                                                                                  \
-        }                                                                                                   \
-        vector->size = size;                                                                                \
+        data[i] = val;                                                                                      \
     }                                                                                                       \
+    vector->size = size;                                                                                    \
+    *self = data;                                                                                           \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+T* vec_resize_##T( T* self, size_t size, T val )                                                            \
+{                                                                                                           \
+    int err = vec_try_resize_##T( &self, size, val );                                                       \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
     return self;                                                                                            \
 }                                                                                                           \
-/* get the reference of the first item */                                                                   \
-T* vec_front_##T( T* self )                                                                                 \
+/* clear, remove all elements in the vector, keeps the capacity and never reallocates */                    \
+T* vec_clear_##T( T* self )                                                                                 \
 {                                                                                                           \
-    vec_meta *vector = vec_get_meta_##T( self );                                                            \
-    if ( vector->size > 0 ) return self;                                                                    \
-    else return NULL;                                                                                       \
+    VEC_COW_( self = vec_own_##T( self, 0 ); )                                                              \
+    vec_get_meta_##T( self )->size = 0;                                                                     \
+    return self;                                                                                            \
 }                                                                                                           \
-/* get the reference of the last item */                                                                    \
-T* vec_back_##T( T* self )                                                                                  \
+/* give back memory above max_cap elements, never below the size or VEC_MIN_CAPACITY */                     \
+T* vec_trim_##T( T* self, size_t max_cap )                                                                  \
 {                                                                                                           \
-    vec_meta *vector = vec_get_meta_##T( self );                                                            \
-    if ( vector->size > 0 ) return &self[ vector->size - 1 ];                                               \
-    else return NULL;                                                                                       \
+    VEC_COW_( self = vec_unshare_##T( self ); )                                                             \
+    vec_meta* vector = vec_get_meta_##T( self );                                                            \
+    if ( max_cap < vector->size ) max_cap = vector->size;                                                   \
+    if ( max_cap < VEC_MIN_CAPACITY ) max_cap = VEC_MIN_CAPACITY;                                           \
+    if ( max_cap >= vector->capacity ) return self;                                                         \
+    return vec_set_capacity_##T( self, max_cap );                                                           \
 }                                                                                                           \
-/* Returns the number of elements in the vector */                                                          \
-size_t vec_size_##T( T* self )                                                                              \
+/* remove all elements and give the memory back, the vector stays usable */                                 \
+T* vec_release_##T( T* self )                                                                               \
 {                                                                                                           \
-    vec_meta *vector = vec_get_meta_##T( self );                                                            \
-    return vector->size;                                                                                    \
+    VEC_COW_( self = vec_own_##T( self, 0 ); )                                                              \
+    vec_get_meta_##T( self )->size = 0;                                                                     \
+    return vec_trim_##T( self, VEC_MIN_CAPACITY );                                                          \
 }                                                                                                           \
-/* get the allocated size for the vector in terms of elements */                                            \
-size_t vec_capacity_##T( T* self )                                                                          \
+/* Assigns new contents to the vector and modifying its size accordingly */                                 \
+int vec_try_assign_##T( T** self, size_t size, T val )                                                      \
 {                                                                                                           \
-    vec_meta *vector = vec_get_meta_##T( self );                                                            \
-    return vector->capacity;                                                                                \
+    VEC_COW_( int err = vec_try_unshare_##T( self ); )                                                      \
+    VEC_COW_( if ( VEC_UNLIKELY( err ) ) return err; )                                                      \
+    T* data = *self;                                                                                        \
+    vec_meta* vector = vec_get_meta_##T( data );                                                            \
+    size_t cap;                                                                                             \
+    if ( size > vector->capacity ) cap = vec_grow_capacity_##T( vector->capacity, size );                   \
+    else cap = vec_shrink_capacity( vector->capacity, size );                                               \
+    if ( cap != vector->capacity )                                                                          \
+    {                                                                                                       \
+        data = vec_set_capacity_##T( data, cap );                                                           \
+        if ( VEC_UNLIKELY( data == NULL ) ) return VEC_ERR_NOMEM;                                           \
+        vector = vec_get_meta_##T( data );                                                                  \
+    }                                                                                                       \
+    for ( size_t i = 0; i < size; i++ )                                                                     \
+    {                                                                                                       \
+        data[i] = val;                                                                                      \
+    }                                                                                                       \
+    vector->size = size;                                                                                    \
+    *self = data;                                                                                           \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+T* vec_assign_##T( T* self, size_t size, T val )                                                            \
+{                                                                                                           \
+    int err = vec_try_assign_##T( &self, size, val );                                                       \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
 }                                                                                                           \
 /* Requests the container to reduce its capacity to fit its size */                                         \
 T* vec_shrink_to_fit_##T( T* self )                                                                         \
 {                                                                                                           \
-    return vec_resize_##T( self, vec_size_##T(self), (T) { 0 } );                                           \
+    VEC_COW_( self = vec_unshare_##T( self ); )                                                             \
+    size_t cap = vec_size_##T( self );                                                                      \
+    if ( cap < VEC_MIN_CAPACITY ) cap = VEC_MIN_CAPACITY;                                                   \
+    if ( cap >= vec_capacity_##T( self ) ) return self;                                                     \
+    return vec_set_capacity_##T( self, cap );                                                               \
 }                                                                                                           \
 /* Requests that the vector capacity be at least enough to contain size elements */                         \
+int vec_try_reserve_##T( T** self, size_t size )                                                            \
+{                                                                                                           \
+    if ( size <= vec_capacity_##T( *self ) ) return VEC_OK;                                                 \
+    VEC_COW_( int err = vec_try_unshare_##T( self ); )                                                      \
+    VEC_COW_( if ( VEC_UNLIKELY( err ) ) return err; )                                                      \
+    T* data = vec_set_capacity_##T( *self, size );                                                          \
+    if ( VEC_UNLIKELY( data == NULL ) ) return VEC_ERR_NOMEM;                                               \
+    *self = data;                                                                                           \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
 T* vec_reserve_##T( T* self, size_t size )                                                                  \
 {                                                                                                           \
-    if ( size <= vec_size_##T( self ) ) return self;                                                        \
-    else                                                                                                    \
-    {                                                                                                       \
-        return vec_resize_##T( self, size, (T) { 0 } );                                                     \
-    }                                                                                                       \
+    int err = vec_try_reserve_##T( &self, size );                                                           \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
 }                                                                                                           \
 /* extend the vector by inserting an element at the specified position */                                   \
+int vec_try_insert_##T( T** self, size_t position, T val )                                                  \
+{                                                                                                           \
+    if ( VEC_UNLIKELY( position > vec_get_meta_##T( *self )->size ) ) return VEC_ERR_RANGE;                 \
+    int err = vec_try_make_room_##T( self, vec_get_meta_##T( *self )->size + 1 );                           \
+    if ( VEC_UNLIKELY( err ) ) return err;                                                                  \
+    T* data = *self;                                                                                        \
+    vec_meta* vector = vec_get_meta_##T( data );                                                            \
+    memmove( &data[ position + 1 ], &data[ position ], ( vector->size - position ) * sizeof ( T ) );        \
+    data[ position ] = val;                                                                                 \
+    vector->size++;                                                                                         \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
 T* vec_insert_##T( T* self, size_t position, T val )                                                        \
 {                                                                                                           \
-    vec_meta *vector = vec_get_meta_##T( self );                                                            \
-    if ( position > vector->size )                                                                          \
-    {                                                                                                       \
-        fprintf( stderr, "[ERRO]: index out of bounds, aborted\n" );                                        \
-        exit(1);                                                                                            \
-    }                                                                                                       \
-    else                                                                                                    \
-    {                                                                                                       \
-        vector->size++;                                                                                     \
-        self = vec_resize_##T( self, vector->size, (T) { 0 } );                                             \
-        memmove( &self[ position + 1 ], &self[ position ], ( vector->size - position ) * sizeof ( T ) );    \
-        self[ position ] = val;                                                                             \
-    }                                                                                                       \
+    int err = vec_try_insert_##T( &self, position, val );                                                   \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
     return self;                                                                                            \
 }                                                                                                           \
 /* extend the vector by inserting an array of elements at the specified position */                         \
-T* vec_insert_arr_##T( T* self, size_t position, T* arr, size_t size )                                      \
+/* arr must not point into the vector itself, it may move */                                                \
+int vec_try_insert_arr_##T( T** self, size_t position, const T* arr, size_t size )                          \
 {                                                                                                           \
-    vec_meta *vector = vec_get_meta_##T( self );                                                            \
-    if ( position > vector->size )                                                                          \
-    {                                                                                                       \
-        fprintf( stderr, "[ERRO]: index out of bounds, aborted\n" );                                        \
-        exit(1);                                                                                            \
-    }                                                                                                       \
-    else                                                                                                    \
-    {                                                                                                       \
-        vector->size += size;                                                                               \
-        self = vec_resize_##T( self, vector->size, (T) { 0 } );                                             \
-        memmove( &self[ position + size ], &self[ position ], ( vector->size - position ) * sizeof ( T ) ); \
-        memmove( &self[ position ], arr, size * sizeof ( T ) );                                             \
-    }                                                                                                       \
+    if ( VEC_UNLIKELY( position > vec_get_meta_##T( *self )->size ) ) return VEC_ERR_RANGE;                 \
+    int err = vec_try_make_room_##T( self, vec_get_meta_##T( *self )->size + size );                        \
+    if ( VEC_UNLIKELY( err ) ) return err;                                                                  \
+    T* data = *self;                                                                                        \
+    vec_meta* vector = vec_get_meta_##T( data );                                                            \
+    memmove( &data[ position + size ], &data[ position ], ( vector->size - position ) * sizeof ( T ) );     \
+    memcpy( &data[ position ], arr, size * sizeof ( T ) );                                                  \
+    vector->size += size;                                                                                   \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+T* vec_insert_arr_##T( T* self, size_t position, const T* arr, size_t size )                                \
+{                                                                                                           \
+    int err = vec_try_insert_arr_##T( &self, position, arr, size );                                         \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
     return self;                                                                                            \
 }                                                                                                           \
-/* Adds a new element at the end of the vector */                                                           \
-T* vec_push_back_##T( T* self, T val )                                                                      \
+/* append an array of elements to the end of the vector, arr must not point into the vector itself */       \
+int vec_try_append_arr_##T( T** self, const T* arr, size_t size )                                           \
 {                                                                                                           \
-    return vec_insert_##T( self, vec_size_##T(self), val );                                                 \
+    int err = vec_try_make_room_##T( self, vec_get_meta_##T( *self )->size + size );                        \
+    if ( VEC_UNLIKELY( err ) ) return err;                                                                  \
+    vec_meta* vector = vec_get_meta_##T( *self );                                                           \
+    memcpy( &( *self )[ vector->size ], arr, size * sizeof ( T ) );                                         \
+    vector->size += size;                                                                                   \
+    return VEC_OK;                                                                                          \
 }                                                                                                           \
-/* Removes the last element in the vector, effectively reducing the container size by one */                \
-T* vec_pop_back_##T( T* self )                                                                              \
+T* vec_append_arr_##T( T* self, const T* arr, size_t size )                                                 \
+{                                                                                                           \
+    int err = vec_try_append_arr_##T( &self, arr, size );                                                   \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* append all elements of other to the end of the vector, other may be the vector itself */                 \
+int vec_try_append_vec_##T( T** self, T* other )                                                            \
+{                                                                                                           \
+    size_t size = vec_get_meta_##T( other )->size;                                                          \
+    bool same = ( *self == other );                                                                         \
+    int err = vec_try_make_room_##T( self, vec_get_meta_##T( *self )->size + size );                        \
+    if ( VEC_UNLIKELY( err ) ) return err;                                                                  \
+    vec_meta* vector = vec_get_meta_##T( *self );                                                           \
+    memcpy( &( *self )[ vector->size ], same ? *self : other, size * sizeof ( T ) );                        \
+    vector->size += size;                                                                                   \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+T* vec_append_vec_##T( T* self, T* other )                                                                  \
+{                                                                                                           \
+    int err = vec_try_append_vec_##T( &self, other );                                                       \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* remove count elements starting at position */                                                            \
+int vec_try_erase_range_##T( T** self, size_t position, size_t count )                                      \
+{                                                                                                           \
+    vec_meta* vector = vec_get_meta_##T( *self );                                                           \
+    if ( VEC_UNLIKELY( position > vector->size || count > vector->size - position ) ) return VEC_ERR_RANGE; \
+    VEC_COW_( int err = vec_try_unshare_##T( self ); )                                                      \
+    VEC_COW_( if ( VEC_UNLIKELY( err ) ) return err; )                                                      \
+    VEC_COW_( vector = vec_get_meta_##T( *self ); )                                                         \
+    memmove( &( *self )[ position ], &( *self )[ position + count ],                                        \
+             ( vector->size - position - count ) * sizeof ( T ) );                                          \
+    vector->size -= count;                                                                                  \
+    *self = vec_maybe_shrink_##T( *self );                                                                  \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+T* vec_erase_range_##T( T* self, size_t position, size_t count )                                            \
+{                                                                                                           \
+    int err = vec_try_erase_range_##T( &self, position, count );                                            \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* remove the element at position in O(1) by moving the last element into its place, order is not kept */   \
+int vec_try_swap_remove_##T( T** self, size_t position )                                                    \
+{                                                                                                           \
+    vec_meta* vector = vec_get_meta_##T( *self );                                                           \
+    if ( VEC_UNLIKELY( position >= vector->size ) ) return VEC_ERR_RANGE;                                   \
+    VEC_COW_( int err = vec_try_unshare_##T( self ); )                                                      \
+    VEC_COW_( if ( VEC_UNLIKELY( err ) ) return err; )                                                      \
+    VEC_COW_( vector = vec_get_meta_##T( *self ); )                                                         \
+    ( *self )[ position ] = ( *self )[ vector->size - 1 ];                                                  \
+    vector->size--;                                                                                         \
+    *self = vec_maybe_shrink_##T( *self );                                                                  \
+    return VEC_OK;                                                                                          \
+}                                                                                                           \
+T* vec_swap_remove_##T( T* self, size_t position )                                                          \
+{                                                                                                           \
+    int err = vec_try_swap_remove_##T( &self, position );                                                   \
+    if ( VEC_UNLIKELY( err ) ) vec_fail_( err );                                                            \
+    return self;                                                                                            \
+}                                                                                                           \
+/* drop every element from size on, does nothing when the vector is not longer than size */                 \
+T* vec_truncate_##T( T* self, size_t size )                                                                 \
 {                                                                                                           \
     vec_meta *vector = vec_get_meta_##T( self );                                                            \
-    if ( !vector->size )                                                                                    \
+    if ( size >= vector->size ) return self;                                                                \
+    VEC_COW_( self = vec_own_##T( self, size ); )                                                           \
+    VEC_COW_( vector = vec_get_meta_##T( self ); )                                                          \
+    vector->size = size;                                                                                    \
+    return vec_maybe_shrink_##T( self );                                                                    \
+}                                                                                                           \
+/* free the resources used by the container */                                                              \
+void vec_destroy_##T( T* self )                                                                             \
+{                                                                                                           \
+    vec_meta *vector = vec_get_meta_##T( self );                                                            \
+    if ( vector->flags & VEC_FLAG_INLINE ) return;                                                          \
+    VEC_COW_( if ( !vec_cow_release_( vector ) ) return; )                                                  \
+    VEC_STATS_( vec_stats_free_( &vec_stats_of_##T, vec_bytes_##T( vector->capacity ), vector->size, vector->capacity ); ) \
+    vec_mem_free( vector->alloc, (char*) self - vec_header_size_##T(), vec_bytes_##T( vector->capacity ),   \
+                  vec_align_##T() );                                                                        \
+}                                                                                                           \
+/* per-thread cache of cleared heap vectors, the largest ones sit at the end */                             \
+static _Thread_local T* vec_scratch_cache_##T[ VEC_SCRATCH_SLOTS ];                                         \
+static _Thread_local size_t vec_scratch_count_##T;                                                          \
+/* an empty vector with room for at least capacity elements, reused from this thread's cache if possible */ \
+T* vec_scratch_get_##T( size_t capacity )                                                                   \
+{                                                                                                           \
+    if ( VEC_LIKELY( vec_scratch_count_##T > 0 ) )                                                          \
     {                                                                                                       \
-        fprintf( stderr, "[ERRO]: empty vector, aborted\n" );                                               \
-        exit(1);                                                                                            \
+        T* self = vec_scratch_cache_##T[ --vec_scratch_count_##T ];                                         \
+        return vec_reserve_##T( self, capacity );                                                           \
     }                                                                                                       \
-    else                                                                                                    \
+    T* self = vec_new_##T( 0, (T) { 0 } );                                                                  \
+    return vec_reserve_##T( self, capacity );                                                               \
+}                                                                                                           \
+/* hand a vector back to this thread's cache, it is destroyed when the cache is full, when it holds more */ \
+/* than VEC_SCRATCH_MAX_BYTES or when its memory does not come from malloc */                               \
+void vec_scratch_put_##T( T* self )                                                                         \
+{                                                                                                           \
+    vec_meta* vector = vec_get_meta_##T( self );                                                            \
+    if ( vector->alloc != NULL || ( vector->flags & VEC_FLAG_INLINE )                                       \
+         || vec_bytes_##T( vector->capacity ) > VEC_SCRATCH_MAX_BYTES VEC_COW_( || vec_cow_shared_( vector ) ) ) \
     {                                                                                                       \
-        vector->size--;                                                                                     \
-        vec_shrink_to_fit_##T( self );                                                                      \
-        return self;                                                                                        \
+        vec_destroy_##T( self );                                                                            \
+        return;                                                                                             \
+    }                                                                                                       \
+    vector->size = 0;                                                                                       \
+    size_t i = vec_scratch_count_##T;                                                                       \
+    if ( i == VEC_SCRATCH_SLOTS )                                                                           \
+    {                                                                                                       \
+        /* full, keep the bigger of the new vector and the smallest cached one */                           \
+        T* smallest = vec_scratch_cache_##T[0];                                                             \
+        if ( vec_get_meta_##T( smallest )->capacity >= vector->capacity )                                   \
+        {                                                                                                   \
+            vec_destroy_##T( self );                                                                        \
+            return;                                                                                         \
+        }                                                                                                   \
+        vec_destroy_##T( smallest );                                                                        \
+        i = --vec_scratch_count_##T;                                                                        \
+        memmove( &vec_scratch_cache_##T[0], &vec_scratch_cache_##T[1], i * sizeof ( T* ) );                 \
+    }                                                                                                       \
+    while ( i > 0 && vec_get_meta_##T( vec_scratch_cache_##T[ i - 1 ] )->capacity > vector->capacity )      \
+    {                                                                                                       \
+        vec_scratch_cache_##T[i] = vec_scratch_cache_##T[ i - 1 ];                                          \
+        i--;                                                                                                \
     }                                                                                                       \
+    vec_scratch_cache_##T[i] = self;                                                                        \
+    vec_scratch_count_##T++;                                                                                \
 }                                                                                                           \
-/* free the resources used by the container */                                                              \
-void vec_destroy_##T( T* self )                                                                             \
+/* destroy every vector in this thread's cache, call it before the thread exits */                          \
+void vec_scratch_flush_##T( void )                                                                          \
 {                                                                                                           \
-    vec_meta *vector = vec_get_meta_##T( self );                                                            \
-    free(vector);                                                                                           \
+    while ( vec_scratch_count_##T > 0 )                                                                     \
+    {                                                                                                       \
+        vec_destroy_##T( vec_scratch_cache_##T[ --vec_scratch_count_##T ] );                                \
+    }                                                                                                       \
 }                                                                                                           \
 
+
+// the stats registry and dump, see VECTOR_STATS
+#if defined( VECTOR_STATS ) && !defined( __VEC_STATS_IMPL__ )
+#define __VEC_STATS_IMPL__
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define VEC_STATS_WEAK __attribute__(( weak ))
+#else
+#define VEC_STATS_WEAK
+#endif
+
+VEC_STATS_WEAK _Atomic( vec_stats* ) vec_stats_list_ = NULL;
+
+static void vec_stats_hist_( FILE* out, const char* name, _Atomic size_t* hist, int format )
+{
+    bool first = true;
+    fprintf( out, format == VEC_STATS_JSON ? ", \"%s\": {" : "    %-14s", name );
+    for ( size_t k = 0; k < VEC_STATS_BUCKETS; k++ )
+    {
+        size_t count = atomic_load_explicit( &hist[k], memory_order_relaxed );
+        if ( count == 0 ) continue;
+        size_t low = k ? (size_t) 1 << ( k - 1 ) : 0;
+        if ( format == VEC_STATS_JSON ) fprintf( out, "%s\"%zu\": %zu", first ? "" : ", ", low, count );
+        else fprintf( out, " %zu+: %zu", low, count );
+        first = false;
+    }
+    fprintf( out, format == VEC_STATS_JSON ? "}" : "\n" );
+}
+
+VEC_STATS_WEAK void vec_stats_dump( FILE* out, int format )
+{
+    vec_stats* head = atomic_load( &vec_stats_list_ );
+    if ( format == VEC_STATS_JSON ) fprintf( out, "[" );
+    for ( vec_stats* stats = head; stats; stats = stats->next )
+    {
+        size_t counts[] = {
+            atomic_load( &stats->allocs ), atomic_load( &stats->reallocs ), atomic_load( &stats->frees ),
+            atomic_load( &stats->shrinks ), atomic_load( &stats->bytes_moved ), atomic_load( &stats->live_bytes ),
+            atomic_load( &stats->peak_bytes ), atomic_load( &stats->slack_bytes ),
+        };
+        if ( format == VEC_STATS_JSON )
+        {
+            fprintf( out, "%s\n  { \"type\": \"%s\", \"elem_size\": %zu, \"allocs\": %zu, \"reallocs\": %zu, "
+                     "\"frees\": %zu, \"shrinks\": %zu, \"bytes_moved\": %zu, \"live_bytes\": %zu, "
+                     "\"peak_bytes\": %zu, \"slack_bytes\": %zu", stats == head ? "" : ",", stats->name,
+                     stats->elem_size, counts[0], counts[1], counts[2], counts[3], counts[4], counts[5], counts[6],
+                     counts[7] );
+        }
+        else
+        {
+            fprintf( out, "%s ( %zu bytes )\n    allocs %zu  reallocs %zu  frees %zu  shrinks %zu  moved %zu B"
+                     "  live %zu B  peak %zu B  slack %zu B\n", stats->name, stats->elem_size, counts[0], counts[1],
+                     counts[2], counts[3], counts[4], counts[5], counts[6], counts[7] );
+        }
+        vec_stats_hist_( out, "size_hist", stats->size_hist, format );
+        vec_stats_hist_( out, "capacity_hist", stats->capacity_hist, format );
+        if ( format == VEC_STATS_JSON ) fprintf( out, " }" );
+    }
+    if ( format == VEC_STATS_JSON ) fprintf( out, "\n]\n" );
+}
+#endif  // __VEC_STATS_IMPL__
+
+
 #endif  // VECTOR_IMPLEMENTATION
\ No newline at end of file